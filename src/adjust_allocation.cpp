@@ -60,7 +60,7 @@ void adjust_allocation::apply(module& m) const
             for(auto i : iterator_for(tail))
             {
                 if(contains(i->inputs(), ins))
-                    instruction::replace_argument(i, ins, copy);
+                    m.replace_argument(i, ins, copy);
             }
         }
     }
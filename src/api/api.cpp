@@ -25,6 +25,7 @@
 #include <migraphx/rank.hpp>
 #include <migraphx/shape.hpp>
 #include <migraphx/program.hpp>
+#include <migraphx/execution_session.hpp>
 #include <migraphx/onnx.hpp>
 #include <migraphx/tf.hpp>
 #include <migraphx/instruction_ref.hpp>
@@ -485,6 +486,17 @@ struct migraphx_program
     migraphx::program object;
 };
 
+extern "C" struct migraphx_execution_session;
+struct migraphx_execution_session
+{
+    template <class... Ts>
+    migraphx_execution_session(Ts&&... xs)
+        : object(std::forward<Ts>(xs)...) // NOLINT(readability-redundant-member-init)
+    {
+    }
+    migraphx::execution_session object;
+};
+
 extern "C" struct migraphx_operation;
 struct migraphx_operation
 {
@@ -1324,6 +1336,50 @@ migraphx_program_experimental_get_context(migraphx_context_t* out, const_migraph
     return api_error_result;
 }
 
+extern "C" migraphx_status
+migraphx_execution_session_destroy(migraphx_execution_session_t execution_session)
+{
+    auto api_error_result = migraphx::try_([&] { destroy((execution_session)); });
+    return api_error_result;
+}
+
+extern "C" migraphx_status
+migraphx_execution_session_assign_to(migraphx_execution_session_t output,
+                                     const_migraphx_execution_session_t input)
+{
+    auto api_error_result = migraphx::try_([&] { *output = *input; });
+    return api_error_result;
+}
+
+extern "C" migraphx_status
+migraphx_execution_session_create(migraphx_execution_session_t* execution_session,
+                                  const_migraphx_program_t p)
+{
+    auto api_error_result = migraphx::try_([&] {
+        if(p == nullptr)
+            MIGRAPHX_THROW(migraphx_status_bad_param, "Bad parameter p: Null pointer");
+        *execution_session = object_cast<migraphx_execution_session_t>(
+            allocate<migraphx::execution_session>((p->object)));
+    });
+    return api_error_result;
+}
+
+extern "C" migraphx_status
+migraphx_execution_session_run(migraphx_arguments_t* out,
+                               migraphx_execution_session_t execution_session,
+                               migraphx_program_parameters_t params)
+{
+    auto api_error_result = migraphx::try_([&] {
+        if(execution_session == nullptr)
+            MIGRAPHX_THROW(migraphx_status_bad_param,
+                           "Bad parameter execution_session: Null pointer");
+        if(params == nullptr)
+            MIGRAPHX_THROW(migraphx_status_bad_param, "Bad parameter params: Null pointer");
+        *out = allocate<migraphx_arguments_t>((execution_session->object).eval((params->object)));
+    });
+    return api_error_result;
+}
+
 extern "C" migraphx_status migraphx_operation_destroy(migraphx_operation_t operation)
 {
     auto api_error_result = migraphx::try_([&] { destroy((operation)); });
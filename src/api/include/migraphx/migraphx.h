@@ -102,6 +102,9 @@ typedef const struct migraphx_module* const_migraphx_module_t;
 typedef struct migraphx_program* migraphx_program_t;
 typedef const struct migraphx_program* const_migraphx_program_t;
 
+typedef struct migraphx_execution_session* migraphx_execution_session_t;
+typedef const struct migraphx_execution_session* const_migraphx_execution_session_t;
+
 typedef struct migraphx_operation* migraphx_operation_t;
 typedef const struct migraphx_operation* const_migraphx_operation_t;
 
@@ -343,6 +346,18 @@ migraphx_program_equal(bool* out, const_migraphx_program_t program, const_migrap
 migraphx_status migraphx_program_experimental_get_context(migraphx_context_t* out,
                                                           const_migraphx_program_t program);
 
+migraphx_status migraphx_execution_session_destroy(migraphx_execution_session_t execution_session);
+
+migraphx_status migraphx_execution_session_assign_to(migraphx_execution_session_t output,
+                                                     const_migraphx_execution_session_t input);
+
+migraphx_status migraphx_execution_session_create(migraphx_execution_session_t* execution_session,
+                                                  const_migraphx_program_t p);
+
+migraphx_status migraphx_execution_session_run(migraphx_arguments_t* out,
+                                               migraphx_execution_session_t execution_session,
+                                               migraphx_program_parameters_t params);
+
 migraphx_status migraphx_operation_destroy(migraphx_operation_t operation);
 
 migraphx_status migraphx_operation_assign_to(migraphx_operation_t output,
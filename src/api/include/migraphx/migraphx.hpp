@@ -961,6 +961,35 @@ struct program : MIGRAPHX_HANDLE_BASE(program)
     friend bool operator!=(const program& px, const program& py) { return !(px == py); }
 };
 
+/// Runs a compiled program with its own context, so that each thread can evaluate the same
+/// program concurrently through its own session
+struct execution_session : MIGRAPHX_HANDLE_BASE(execution_session)
+{
+    execution_session() {}
+
+    MIGRAPHX_HANDLE_CONSTRUCTOR(execution_session);
+
+    execution_session(const program& p) : prog(p)
+    {
+        this->make_handle(&migraphx_execution_session_create, p.get_handle_ptr());
+    }
+
+    /// Run the program using the inputs passed in
+    arguments eval(const program_parameters& pparams) const
+    {
+        migraphx_arguments_t pout;
+        call(&migraphx_execution_session_run,
+             &pout,
+             this->get_handle_ptr(),
+             pparams.get_handle_ptr());
+        return arguments(pout, own{});
+    }
+
+    private:
+    // Keeps the program alive while the session uses it
+    program prog;
+};
+
 // options for migraphx file format options
 struct file_options : MIGRAPHX_HANDLE_BASE(file_options)
 {
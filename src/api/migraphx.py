@@ -284,6 +284,16 @@ def program(h):
              returns='migraphx::context')
 
 
+@auto_handle()
+def execution_session(h):
+    h.constructor('create', api.params(p='const migraphx::program&'))
+    h.method('run',
+             api.params(
+                 params='std::unordered_map<std::string, migraphx::argument>'),
+             fname='eval',
+             returns='std::vector<migraphx::argument>')
+
+
 @auto_handle()
 def operation(h):
     h.constructor('create',
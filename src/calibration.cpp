@@ -0,0 +1,279 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/calibration.hpp>
+#include <migraphx/errors.hpp>
+#include <migraphx/file_buffer.hpp>
+#include <migraphx/json.hpp>
+#include <migraphx/par_for.hpp>
+#include <migraphx/serialize.hpp>
+#include <migraphx/thread_pool.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+// Number of positive int8 levels
+const std::size_t quantized_bins = 128;
+
+calibration_method to_calibration_method(const std::string& name)
+{
+    if(name == "max")
+        return calibration_method::max;
+    if(name == "percentile")
+        return calibration_method::percentile;
+    if(name == "entropy")
+        return calibration_method::entropy;
+    MIGRAPHX_THROW("Unknown calibration method: " + name);
+}
+
+std::string to_string(calibration_method method)
+{
+    switch(method)
+    {
+    case calibration_method::max: return "max";
+    case calibration_method::percentile: return "percentile";
+    case calibration_method::entropy: return "entropy";
+    }
+    MIGRAPHX_THROW("Unknown calibration method");
+}
+
+calibration_histogram::calibration_histogram() : calibration_histogram(2048) {}
+
+calibration_histogram::calibration_histogram(std::size_t bins) : counts(bins)
+{
+    if(bins == 0)
+        MIGRAPHX_THROW("CALIBRATION: histogram needs at least one bin");
+}
+
+void calibration_histogram::grow(float x)
+{
+    if(x <= range)
+        return;
+    // Everything seen so far was zero, which stays in the first bin
+    if(range == 0)
+    {
+        range = x;
+        return;
+    }
+    auto bins = counts.size();
+    while(range < x)
+    {
+        for(std::size_t i = 0; i < bins; i++)
+        {
+            auto c = (i * 2 < bins) ? counts[i * 2] : 0;
+            if(i * 2 + 1 < bins)
+                c += counts[i * 2 + 1];
+            counts[i] = c;
+        }
+        range *= 2;
+    }
+}
+
+void calibration_histogram::update(const argument& arg)
+{
+    const std::size_t grain = 4096;
+    auto n                  = arg.get_shape().elements();
+    auto nchunks            = (n + grain - 1) / grain;
+    auto nthreads           = std::max<std::size_t>(thread_pool::global().size(), 1);
+    auto bins               = counts.size();
+    thread_min.assign(nthreads, 0);
+    thread_max.assign(nthreads, 0);
+    thread_counts.assign(nthreads * bins, 0);
+    arg.visit([&](auto data) {
+        auto for_each_chunk = [&](auto f) {
+            par_for(nchunks, 1, [&](std::size_t chunk, std::size_t tid) {
+                auto last = std::min(n, (chunk + 1) * grain);
+                for(std::size_t i = chunk * grain; i < last; i++)
+                {
+                    auto x = static_cast<float>(data[i]);
+                    if(std::isfinite(x))
+                        f(x, tid);
+                }
+            });
+        };
+        for_each_chunk([&](float x, std::size_t tid) {
+            thread_min[tid] = std::min(thread_min[tid], x);
+            thread_max[tid] = std::max(thread_max[tid], x);
+        });
+        min_value = std::min(min_value, *std::min_element(thread_min.begin(), thread_min.end()));
+        max_value = std::max(max_value, *std::max_element(thread_max.begin(), thread_max.end()));
+        max_abs   = std::max(-min_value, max_value);
+        this->grow(max_abs);
+
+        float scale = (range > 0) ? bins / range : 0;
+        for_each_chunk([&](float x, std::size_t tid) {
+            auto b = std::min<std::size_t>(std::fabs(x) * scale, bins - 1);
+            thread_counts[tid * bins + b]++;
+        });
+    });
+    for(std::size_t tid = 0; tid < nthreads; tid++)
+    {
+        std::transform(counts.begin(),
+                       counts.end(),
+                       thread_counts.begin() + tid * bins,
+                       counts.begin(),
+                       std::plus<>{});
+    }
+    runs++;
+}
+
+static float entropy_threshold(const std::vector<std::size_t>& counts, float range)
+{
+    auto bins = counts.size();
+    std::vector<double> p(bins);
+    std::vector<double> q(bins);
+    double best_kl        = std::numeric_limits<double>::max();
+    std::size_t best_bins = bins;
+    auto outliers         = std::accumulate(counts.begin(), counts.end(), 0.0);
+    for(std::size_t i = 0; i < quantized_bins; i++)
+        outliers -= counts[i];
+    // Try every clipping point, clipped values are added to the last bin
+    for(std::size_t i = quantized_bins; i <= bins; i++)
+    {
+        std::copy(counts.begin(), counts.begin() + i, p.begin());
+        p[i - 1] += outliers;
+        if(i < bins)
+            outliers -= counts[i];
+
+        // Merge the bins into the int8 levels, and spread each level evenly over the bins that
+        // were not empty
+        for(std::size_t j = 0; j < quantized_bins; j++)
+        {
+            auto start          = j * i / quantized_bins;
+            auto last           = (j + 1) * i / quantized_bins;
+            double sum          = 0;
+            std::size_t nonzero = 0;
+            for(auto k = start; k < last; k++)
+            {
+                sum += counts[k];
+                nonzero += counts[k] != 0 ? 1 : 0;
+            }
+            for(auto k = start; k < last; k++)
+                q[k] = (counts[k] != 0) ? sum / nonzero : 0;
+        }
+
+        auto p_total = std::accumulate(p.begin(), p.begin() + i, 0.0);
+        auto q_total = std::accumulate(q.begin(), q.begin() + i, 0.0);
+        if(p_total == 0 or q_total == 0)
+            continue;
+        double kl = 0;
+        for(std::size_t k = 0; k < i; k++)
+        {
+            if(p[k] == 0)
+                continue;
+            auto pk = p[k] / p_total;
+            // Levels missing from the quantized distribution get a small probability
+            auto qk = std::max(q[k] / q_total, 1e-10);
+            kl += pk * std::log(pk / qk);
+        }
+        if(kl < best_kl)
+        {
+            best_kl   = kl;
+            best_bins = i;
+        }
+    }
+    return best_bins * range / bins;
+}
+
+float calibration_histogram::threshold(const calibration_options& options) const
+{
+    auto bins  = counts.size();
+    auto total = std::accumulate(counts.begin(), counts.end(), std::size_t{0});
+    if(total == 0 or range == 0)
+        return max_abs;
+    switch(options.method)
+    {
+    case calibration_method::max: return max_abs;
+    case calibration_method::percentile: {
+        auto target      = total * options.percentile / 100.0;
+        std::size_t csum = 0;
+        for(std::size_t i = 0; i < bins; i++)
+        {
+            csum += counts[i];
+            if(csum >= target)
+                return std::min(max_abs, (i + 1) * range / bins);
+        }
+        return max_abs;
+    }
+    case calibration_method::entropy:
+        if(bins < quantized_bins)
+            return max_abs;
+        return std::min(max_abs, entropy_threshold(counts, range));
+    }
+    MIGRAPHX_THROW("Unknown calibration method");
+}
+
+std::pair<float, float>
+calibration_histogram::quant_params(const calibration_options& options, bool asymmetric) const
+{
+    // Nothing was captured for this tensor
+    if(runs == 0)
+        return {64.0f, 0.0f};
+    if(asymmetric)
+    {
+        // The range has to include zero so that it is represented exactly
+        auto t  = threshold(options);
+        auto lo = std::min(std::max(min_value, -t), 0.0f);
+        auto hi = std::max(std::min(max_value, t), 0.0f);
+        if(hi == lo)
+            return {1.0f, 0.0f};
+        auto scale      = (hi - lo) / 255.0f;
+        auto zero_point = std::min(std::max(std::round(-lo / scale), 0.0f), 255.0f);
+        return {1.0f / scale, zero_point};
+    }
+    // scale and shift is need for only int8 type, and we do not
+    // consider shift, so set shift to 0
+    auto t = threshold(options);
+    // if all values are 0, no need to do scaling
+    if(t == 0.0f)
+        return {1.0f, 0.0f};
+    return {127.0f / t, 0.0f};
+}
+
+void save_calibration_table(const std::vector<calibration_histogram>& histograms,
+                            const std::string& key,
+                            const std::string& filename)
+{
+    value v     = {{"key", key}, {"histograms", to_value(histograms)}};
+    auto buffer = to_json_string(v);
+    write_buffer(filename, buffer.data(), buffer.size());
+}
+
+std::vector<calibration_histogram> load_calibration_table(const std::string& filename,
+                                                          const std::string& key)
+{
+    auto v = from_json_string(read_string(filename));
+    if(not v.contains("histograms") or not v.contains("key"))
+        MIGRAPHX_THROW("CALIBRATION: invalid calibration table " + filename);
+    if(v.at("key").to<std::string>() != key)
+        MIGRAPHX_THROW("CALIBRATION: calibration table " + filename +
+                       " was collected from another program or number of bins");
+    return from_value<std::vector<calibration_histogram>>(v.at("histograms"));
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -0,0 +1,152 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/compile_cache.hpp>
+#include <migraphx/load_save.hpp>
+#include <migraphx/serialize.hpp>
+#include <migraphx/hash.hpp>
+#include <migraphx/tmp_dir.hpp>
+#include <migraphx/version.h>
+#include <migraphx/env.hpp>
+#include <algorithm>
+#include <sstream>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_COMPILE_CACHE)
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_COMPILE_CACHE_SIZE)
+
+static const char* const cache_extension = ".mxr";
+
+compile_cache::compile_cache(const compile_options& options)
+    : dir(options.cache_dir.empty() ? string_value_of(MIGRAPHX_COMPILE_CACHE{})
+                                    : options.cache_dir),
+      max_bytes(options.cache_size == 0 ? value_of(MIGRAPHX_COMPILE_CACHE_SIZE{})
+                                        : options.cache_size)
+{
+}
+
+bool compile_cache::enabled() const { return not dir.empty(); }
+
+std::string compile_cache::key(const program& p,
+                               const target& t,
+                               const std::vector<pass>& passes,
+                               const compile_options& options) const
+{
+    std::size_t seed = hash_value(p.to_value());
+    hash_combine(seed, std::string{MIGRAPHX_VERSION_STRING});
+    hash_combine(seed, std::string{MIGRAPHX_GIT_HASH});
+    // Compiled programs can contain code for the exact device, such as the instruction set of
+    // the host cpu or the gpu architecture, which another machine sharing the cache can't run
+    hash_combine(seed, t.device_identity());
+    for(const auto& pss : passes)
+        hash_combine(seed, pss.name());
+    hash_combine(seed, options.offload_copy);
+    hash_combine(seed, options.fast_math);
+    std::stringstream ss;
+    ss << t.name() << "-" << std::hex << seed;
+    return ss.str();
+}
+
+optional<program> compile_cache::load(const std::string& key) const
+{
+    auto file = dir / (key + cache_extension);
+    if(not fs::exists(file))
+        return nullopt;
+    try
+    {
+        auto p = migraphx::load(file.string());
+        // Touch the file so that it is evicted last
+        std::error_code ec;
+        fs::last_write_time(file, fs::file_time_type::clock::now(), ec);
+        return p;
+    }
+    catch(const std::exception&)
+    {
+        // A file from an older version or one that is corrupt is compiled again and replaced
+        return nullopt;
+    }
+}
+
+void compile_cache::store(const std::string& key, const program& p) const
+{
+    auto file = dir / (key + cache_extension);
+    // Write to a temporary file first so another process never loads a partial file
+    auto tmp = file;
+    tmp += "." + unique_string("tmp");
+    std::error_code ec;
+    try
+    {
+        fs::create_directories(dir);
+        save(p, tmp.string());
+        fs::rename(tmp, file);
+    }
+    catch(const std::exception&)
+    {
+        // Failing to cache the program should not fail the compilation
+        fs::remove(tmp, ec);
+        return;
+    }
+    if(max_bytes > 0)
+        evict(key);
+}
+
+void compile_cache::evict(const std::string& keep) const
+{
+    struct entry
+    {
+        fs::path path;
+        fs::file_time_type time;
+        std::uintmax_t size;
+    };
+    std::vector<entry> entries;
+    std::uintmax_t total = 0;
+    std::error_code ec;
+    for(const auto& f : fs::directory_iterator(dir, ec))
+    {
+        if(f.path().extension() != cache_extension)
+            continue;
+        auto size = fs::file_size(f.path(), ec);
+        auto time = fs::last_write_time(f.path(), ec);
+        if(ec)
+            continue;
+        total += size;
+        if(f.path().stem() != keep)
+            entries.push_back({f.path(), time, size});
+    }
+    std::sort(entries.begin(), entries.end(), [](const auto& x, const auto& y) {
+        return x.time < y.time;
+    });
+    for(const auto& e : entries)
+    {
+        if(total <= max_bytes)
+            break;
+        // Another process may have already removed it
+        if(fs::remove(e.path, ec))
+            total -= e.size;
+    }
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
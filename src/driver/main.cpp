@@ -28,6 +28,7 @@
 #include "perf.hpp"
 #include "models.hpp"
 #include "marker_roctx.hpp"
+#include "replay.hpp"
 
 #include <migraphx/tf.hpp>
 #include <migraphx/onnx.hpp>
@@ -41,6 +42,7 @@
 #include <migraphx/eliminate_pad.hpp>
 #include <migraphx/generate.hpp>
 #include <migraphx/pass_manager.hpp>
+#include <migraphx/pass_profile.hpp>
 #include <migraphx/propagate_constant.hpp>
 #include <migraphx/quantization.hpp>
 #include <migraphx/register_op.hpp>
@@ -48,6 +50,7 @@
 #include <migraphx/simplify_algebra.hpp>
 #include <migraphx/simplify_reshapes.hpp>
 #include <migraphx/register_target.hpp>
+#include <migraphx/request_batcher.hpp>
 
 #include <fstream>
 
@@ -318,9 +321,16 @@ struct compiler
     loader l;
     program_params parameters;
     compiler_target ct;
-    bool offload_copy  = false;
-    bool fast_math     = true;
-    precision quantize = precision::fp32;
+    bool offload_copy              = false;
+    bool fast_math                 = true;
+    precision quantize             = precision::fp32;
+    pass_profile* profile          = nullptr;
+    std::string calibration_method = "max";
+    std::string calibration_table;
+    bool int8_per_channel          = false;
+    bool int8_asymmetric           = false;
+    std::size_t weight_bits        = 0;
+    std::size_t weight_group_size  = 128;
 
     std::vector<std::string> fill0;
     std::vector<std::string> fill1;
@@ -339,16 +349,33 @@ struct compiler
            ap.set_value(false));
         ap(quantize, {"--fp16"}, ap.help("Quantize for fp16"), ap.set_value(precision::fp16));
         ap(quantize, {"--int8"}, ap.help("Quantize for int8"), ap.set_value(precision::int8));
+        ap(calibration_method,
+           {"--int8-calibration"},
+           ap.help("Method to choose the int8 scales from the calibration data"),
+           ap.type("max|percentile|entropy"));
+        ap(calibration_table,
+           {"--int8-calibration-table"},
+           ap.help("Load the int8 calibration from this file, or save it when it does not exist"));
+        ap(int8_per_channel,
+           {"--int8-per-channel"},
+           ap.help("Use a scale for each output channel of the int8 weights"),
+           ap.set_value(true));
+        ap(int8_asymmetric,
+           {"--int8-asymmetric"},
+           ap.help("Quantize the int8 activations to uint8 with a zero point"),
+           ap.set_value(true));
+        ap(weight_bits,
+           {"--quantize-weights"},
+           ap.help("Quantize only the weights of dot to this many bits (4 or 8)"));
+        ap(weight_group_size,
+           {"--weight-group-size"},
+           ap.help("Number of weights sharing a scale when quantizing the weights"));
     }
 
     auto params(const program& p) { return parameters.generate(p, ct.get_target(), offload_copy); }
 
-    program compile()
+    void compile(program& p)
     {
-        auto p = l.load();
-        // Dont compile if its already been compiled
-        if(p.is_compiled())
-            return p;
         auto t = ct.get_target();
         if(quantize == precision::fp16)
         {
@@ -356,12 +383,29 @@ struct compiler
         }
         else if(quantize == precision::int8)
         {
-            quantize_int8(p, t, {params(p)});
+            calibration_options options;
+            options.method      = to_calibration_method(calibration_method);
+            options.table       = calibration_table;
+            options.per_channel = int8_per_channel;
+            options.asymmetric  = int8_asymmetric;
+            quantize_int8(p, t, {params(p)}, {"dot", "convolution"}, options);
         }
+        if(weight_bits > 0)
+            quantize_weights(p, t, weight_bits, weight_group_size);
         compile_options options;
         options.offload_copy = offload_copy;
         options.fast_math    = fast_math;
+        options.profile      = profile;
         p.compile(t, options);
+    }
+
+    program compile()
+    {
+        auto p = l.load();
+        // Dont compile if its already been compiled
+        if(p.is_compiled())
+            return p;
+        this->compile(p);
         l.save(p);
         return p;
     }
@@ -465,12 +509,34 @@ struct version : command<version>
 struct compile : command<compile>
 {
     compiler c;
-    void parse(argument_parser& ap) { c.parse(ap); }
+    bool profile_passes = false;
+    std::string profile_file;
+    void parse(argument_parser& ap)
+    {
+        c.parse(ap);
+        ap(profile_passes,
+           {"--profile-passes"},
+           ap.help("Print the time spent in each compile pass"),
+           ap.set_value(true));
+        ap(profile_file,
+           {"--profile-passes-json"},
+           ap.help("Write the time and effect of each pass on each module to a json file"));
+    }
 
     void run()
     {
+        pass_profile profile;
+        if(profile_passes or not profile_file.empty())
+            c.profile = &profile;
         std::cout << "Compiling ... " << std::endl;
         c.compile();
+        if(profile_passes)
+            profile.print_summary(std::cout);
+        if(not profile_file.empty())
+        {
+            std::ofstream os(profile_file);
+            os << to_json_string(profile.to_value());
+        }
     }
 };
 
@@ -511,6 +577,74 @@ struct perf : command<perf>
     }
 };
 
+struct batch : command<batch>
+{
+    compiler c;
+    std::vector<std::string> buckets;
+    std::size_t max_batch    = 0;
+    unsigned max_latency     = 1000;
+    std::size_t n            = 1000;
+    double rate              = 1000;
+    std::string arrivals     = "poisson";
+    std::string trace;
+    void parse(argument_parser& ap)
+    {
+        c.parse(ap);
+        ap(buckets,
+           {"--buckets"},
+           ap.help("Batch sizes to compile the program for (default: 1 2 4 8)"),
+           ap.append(),
+           ap.nargs(2));
+        ap(max_batch, {"--max-batch"}, ap.help("Most requests in a batch (default: largest bucket)"));
+        ap(max_latency,
+           {"--max-latency"},
+           ap.help("Longest time in microseconds a request waits for a batch to fill"));
+        ap(n, {"--requests", "-n"}, ap.help("Number of requests to replay"));
+        ap(rate, {"--rate"}, ap.help("Average arrival rate in requests per second"));
+        ap(arrivals,
+           {"--arrivals"},
+           ap.help("Distribution of the synthetic arrivals"),
+           ap.type("poisson|uniform|burst"));
+        ap(trace,
+           {"--trace"},
+           ap.help("Replay the arrival times in milliseconds listed in a file, one per line"));
+    }
+
+    void run()
+    {
+        // Requests are on the host, so the outputs have to be as well
+        c.offload_copy = true;
+        std::vector<std::size_t> sizes;
+        std::transform(buckets.begin(),
+                       buckets.end(),
+                       std::back_inserter(sizes),
+                       [](const std::string& x) { return std::stoul(x); });
+        if(sizes.empty())
+            sizes = {1, 2, 4, 8};
+        std::vector<program> progs;
+        for(auto size : sizes)
+        {
+            std::cout << "Compiling batch " << size << " ... " << std::endl;
+            c.l.batch = size;
+            auto p    = c.l.load();
+            if(not p.is_compiled())
+                c.compile(p);
+            progs.push_back(std::move(p));
+        }
+        batcher_options options;
+        options.max_batch   = max_batch;
+        options.max_latency = std::chrono::microseconds{max_latency};
+        request_batcher batcher{std::move(progs), options};
+
+        parameter_map sample;
+        for(auto&& ps : batcher.get_parameter_shapes())
+            sample[ps.first] = generate_argument(ps.second);
+        auto times = trace.empty() ? generate_arrivals(arrivals, n, rate) : read_arrivals(trace);
+        std::cout << "Replaying " << times.size() << " requests ... " << std::endl;
+        replay_arrivals(std::cout, batcher, times, sample);
+    }
+};
+
 struct roctx : command<roctx>
 {
     compiler c;
@@ -0,0 +1,173 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "replay.hpp"
+
+#include <migraphx/errors.hpp>
+#include <migraphx/stringutils.hpp>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <thread>
+
+namespace migraphx {
+namespace driver {
+inline namespace MIGRAPHX_INLINE_NS {
+
+std::vector<double>
+generate_arrivals(const std::string& dist, std::size_t n, double rate, unsigned seed)
+{
+    if(rate <= 0)
+        MIGRAPHX_THROW("Arrival rate must be positive");
+    std::vector<double> result(n);
+    std::mt19937 gen{seed};
+    if(dist == "poisson")
+    {
+        std::exponential_distribution<double> gaps{rate};
+        double t = 0;
+        std::generate(result.begin(), result.end(), [&] { return t += gaps(gen); });
+    }
+    else if(dist == "uniform")
+    {
+        std::size_t i = 0;
+        std::generate(result.begin(), result.end(), [&] { return (i++) / rate; });
+    }
+    else if(dist == "burst")
+    {
+        // Bursts of 16 requests arriving at once, with the same average rate
+        const std::size_t burst = 16;
+        std::size_t i           = 0;
+        std::generate(result.begin(), result.end(), [&] { return ((i++) / burst) * burst / rate; });
+    }
+    else
+    {
+        MIGRAPHX_THROW("Unknown arrival distribution: " + dist);
+    }
+    return result;
+}
+
+std::vector<double> read_arrivals(const std::string& file)
+{
+    std::ifstream is(file);
+    if(not is)
+        MIGRAPHX_THROW("Failed to open trace: " + file);
+    std::vector<double> result;
+    double ms;
+    while(is >> ms)
+        result.push_back(ms / 1000.0);
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+static double percentile(const std::vector<double>& sorted, double p)
+{
+    if(sorted.empty())
+        return 0;
+    auto i = static_cast<std::size_t>(p * (sorted.size() - 1));
+    return sorted[i];
+}
+
+void replay_arrivals(std::ostream& os,
+                     request_batcher& batcher,
+                     const std::vector<double>& arrivals,
+                     const parameter_map& sample)
+{
+    using clock = std::chrono::steady_clock;
+    using request =
+        std::pair<clock::time_point, std::future<std::vector<argument>>>; // arrival, result
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<request> pending;
+
+    auto start = clock::now();
+    // Submit the requests on their own thread so that waiting on the results never delays
+    // the arrivals
+    std::thread submitter{[&] {
+        for(auto arrival : arrivals)
+        {
+            auto t = start + std::chrono::duration_cast<clock::duration>(
+                                 std::chrono::duration<double>{arrival});
+            std::this_thread::sleep_until(t);
+            auto f = batcher.submit(sample);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                pending.emplace_back(t, std::move(f));
+            }
+            cv.notify_one();
+        }
+    }};
+
+    std::vector<double> latencies;
+    std::size_t failed = 0;
+    while(latencies.size() + failed < arrivals.size())
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [&] { return not pending.empty(); });
+        auto r = std::move(pending.front());
+        pending.pop_front();
+        lock.unlock();
+        try
+        {
+            r.second.get();
+            std::chrono::duration<double, std::milli> latency = clock::now() - r.first;
+            latencies.push_back(latency.count());
+        }
+        catch(const std::exception& e)
+        {
+            if(failed == 0)
+                os << "Request failed: " << e.what() << std::endl;
+            failed++;
+        }
+    }
+    std::chrono::duration<double> total = clock::now() - start;
+    submitter.join();
+
+    auto stats = batcher.get_stats();
+    std::sort(latencies.begin(), latencies.end());
+    double mean = latencies.empty() ? 0.0
+                                    : std::accumulate(latencies.begin(), latencies.end(), 0.0) /
+                                          latencies.size();
+    double offered = arrivals.empty() ? 0.0 : arrivals.size() / std::max(arrivals.back(), 1e-9);
+
+    os << "Buckets: " << to_string_range(batcher.get_bucket_sizes()) << std::endl;
+    os << "Requests: " << stats.requests << " (" << failed << " failed)" << std::endl;
+    os << "Batches: " << stats.batches << std::endl;
+    if(stats.batches > 0)
+        os << "Average batch: " << double(stats.requests) / stats.batches
+           << ", padding: " << stats.padding << std::endl;
+    os << "Offered rate: " << offered << " requests/sec" << std::endl;
+    os << "Throughput: " << stats.requests / total.count() << " requests/sec" << std::endl;
+    os << "Latency (ms): mean " << mean << ", p50 " << percentile(latencies, 0.5) << ", p90 "
+       << percentile(latencies, 0.9) << ", p99 " << percentile(latencies, 0.99) << ", max "
+       << percentile(latencies, 1.0) << std::endl;
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace driver
+} // namespace migraphx
@@ -124,7 +124,7 @@ static void remove_contiguous(const std::string& op_name, module& m, F f)
             replace(new_args, arg, prev);
             if(try_compute_shape(ins, new_args, mod_args))
             {
-                instruction::replace_argument(ins, arg, prev);
+                m.replace_argument(ins, arg, prev);
             }
             else if(prev->can_eval())
             {
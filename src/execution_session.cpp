@@ -0,0 +1,135 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/execution_session.hpp>
+#include <migraphx/stringutils.hpp>
+#include <algorithm>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+execution_session::execution_session(const program& p) : prog(&p), ctx(p.create_context()) {}
+
+// Copying the context itself would share the state the target keeps behind pointers, such as
+// the streams and scratch buffers of the cpu context
+execution_session::execution_session(const execution_session& other)
+    : prog(other.prog), ctx(other.prog->create_context())
+{
+}
+
+execution_session& execution_session::operator=(const execution_session& other)
+{
+    if(this == &other)
+        return *this;
+    std::lock_guard<std::mutex> guard(lock);
+    prog = other.prog;
+    ctx  = prog->create_context();
+    return *this;
+}
+
+std::vector<argument> execution_session::eval(parameter_map params)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    auto result = prog->eval(ctx, std::move(params));
+    ctx.finish();
+    return result;
+}
+
+std::vector<argument> execution_session::eval(parameter_map params,
+                                              const std::vector<argument>& outputs)
+{
+    auto names = get_output_parameter_names();
+    if(names.empty())
+    {
+        auto results = eval(std::move(params));
+        if(results.size() != outputs.size())
+            MIGRAPHX_THROW("Expected " + std::to_string(results.size()) + " outputs but got " +
+                           std::to_string(outputs.size()));
+        for(std::size_t i = 0; i < results.size(); i++)
+        {
+            const auto& s = outputs[i].get_shape();
+            if(s.type() != results[i].get_shape().type() or
+               s.lens() != results[i].get_shape().lens())
+                MIGRAPHX_THROW("Output " + std::to_string(i) + " has shape " + to_string(s) +
+                               " but expected " + to_string(results[i].get_shape()));
+            visit_all(outputs[i], results[i])([](auto output, auto result) {
+                std::copy(result.begin(), result.end(), output.begin());
+            });
+        }
+        return outputs;
+    }
+    if(names.size() != outputs.size())
+        MIGRAPHX_THROW("Expected " + std::to_string(names.size()) + " outputs but got " +
+                       std::to_string(outputs.size()));
+    for(std::size_t i = 0; i < names.size(); i++)
+    {
+        auto s = prog->get_parameter_shape(names[i]);
+        if(outputs[i].get_shape() != s)
+            MIGRAPHX_THROW("Output " + std::to_string(i) + " has shape " +
+                           to_string(outputs[i].get_shape()) + " but expected " + to_string(s));
+        params[names[i]] = outputs[i];
+    }
+    eval(std::move(params));
+    return outputs;
+}
+
+std::future<std::vector<argument>> execution_session::eval_async(parameter_map params,
+                                                                 std::vector<argument> outputs)
+{
+    return std::async(std::launch::async,
+                      [this, params = std::move(params), outputs = std::move(outputs)]() mutable {
+                          if(outputs.empty())
+                              return this->eval(std::move(params));
+                          return this->eval(std::move(params), outputs);
+                      });
+}
+
+std::vector<std::string> execution_session::get_output_parameter_names() const
+{
+    std::vector<std::pair<std::size_t, std::string>> outputs;
+    for(const auto& name : prog->get_parameter_names())
+    {
+        if(name == "output")
+            return {name};
+        const std::string prefix = "main:#output_";
+        if(not starts_with(name, prefix))
+            continue;
+        outputs.emplace_back(std::stoul(name.substr(prefix.size())), name);
+    }
+    // Order the outputs by their index instead of by name
+    std::sort(outputs.begin(), outputs.end());
+    std::vector<std::string> result;
+    std::transform(outputs.begin(),
+                   outputs.end(),
+                   std::back_inserter(result),
+                   [](const auto& p) { return p.second; });
+    return result;
+}
+
+context& execution_session::get_context() { return ctx; }
+const context& execution_session::get_context() const { return ctx; }
+
+const program& execution_session::get_program() const { return *prog; }
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -0,0 +1,120 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/hash.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/literal.hpp>
+#include <migraphx/operation.hpp>
+#include <migraphx/shape.hpp>
+#include <migraphx/value.hpp>
+#include <string_view>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+template <class T>
+static std::size_t hash_element(const T& x)
+{
+    return std::hash<T>{}(x);
+}
+
+static std::size_t hash_element(std::nullptr_t) { return 0; }
+
+static std::size_t hash_element(const value::binary& x)
+{
+    return std::hash<std::string_view>{}(
+        std::string_view{reinterpret_cast<const char*>(x.data()), x.size()});
+}
+
+static std::size_t hash_element(const std::vector<value>& x)
+{
+    std::size_t seed = x.size();
+    for(const auto& v : x)
+        hash_combine(seed, hash_value(v));
+    return seed;
+}
+
+// Arrays and objects with a key are visited as a pair with the key
+template <class T>
+static std::size_t hash_element(const std::pair<std::string, T>& x)
+{
+    return hash_element(x.second);
+}
+
+std::size_t hash_value(const value& v)
+{
+    std::size_t seed = v.get_type();
+    hash_combine(seed, v.get_key());
+    v.visit_value([&](const auto& x) { hash_combine(seed, hash_element(x)); });
+    return seed;
+}
+
+template <class Range>
+static void hash_range(std::size_t& seed, const Range& r)
+{
+    hash_combine(seed, r.size());
+    for(auto x : r)
+        hash_combine(seed, x);
+}
+
+std::size_t hash_value(const shape& s)
+{
+    std::size_t seed = s.type();
+    hash_range(seed, s.lens());
+    hash_range(seed, s.strides());
+    for(const auto& ss : s.sub_shapes())
+        hash_combine(seed, hash_value(ss));
+    return seed;
+}
+
+std::size_t hash_value(const literal& l)
+{
+    std::size_t seed = hash_value(l.get_shape());
+    if(not l.empty())
+        hash_combine(seed, std::string_view{l.data(), l.get_shape().bytes()});
+    return seed;
+}
+
+std::size_t hash_value(const operation& op)
+{
+    std::size_t seed = 0;
+    hash_combine(seed, op.name());
+    hash_combine(seed, hash_value(op.to_value()));
+    return seed;
+}
+
+std::size_t hash_value(const instruction& ins)
+{
+    std::size_t seed = hash_value(ins.get_operator());
+    hash_combine(seed, hash_value(ins.get_shape()));
+    for(auto input : ins.inputs())
+        hash_combine(seed, input);
+    for(auto mod : ins.module_inputs())
+        hash_combine(seed, mod);
+    if(ins.name() == "@literal")
+        hash_combine(seed, hash_value(ins.get_literal()));
+    return seed;
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
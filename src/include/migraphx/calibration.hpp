@@ -0,0 +1,124 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_MIGRAPHX_CALIBRATION_HPP
+#define MIGRAPHX_GUARD_MIGRAPHX_CALIBRATION_HPP
+
+#include <migraphx/argument.hpp>
+#include <migraphx/config.hpp>
+#include <migraphx/value.hpp>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+/// How the int8 range of a tensor is chosen from its calibration histogram
+enum class calibration_method
+{
+    /// Use the largest absolute value seen
+    max,
+    /// Clip to the given percentile of the absolute values
+    percentile,
+    /// Clip to the threshold that minimizes the KL divergence between the original and the
+    /// quantized distributions
+    entropy
+};
+
+calibration_method to_calibration_method(const std::string& name);
+std::string to_string(calibration_method method);
+
+struct calibration_options
+{
+    calibration_method method = calibration_method::max;
+    /// Percentage of the absolute values kept by the percentile method
+    double percentile = 99.99;
+    /// Number of bins of each histogram
+    std::size_t bins = 2048;
+    /// File of the calibration table. When it exists the histograms are loaded from it instead of
+    /// running the calibration data, otherwise the histograms collected are saved to it.
+    std::string table;
+    /// Quantize the constant weights of convolution and dot with a scale per output channel
+    bool per_channel = false;
+    /// Quantize the activations to uint8 with a zero point instead of symmetrically to int8
+    bool asymmetric = false;
+};
+
+/// Histogram of the absolute values of a tensor over all of the calibration data. The bins
+/// cover [0, range), and the range is doubled by merging neighbouring bins when a larger value
+/// is seen, so the data only has to be read once.
+struct calibration_histogram
+{
+    std::vector<std::size_t> counts;
+    float range      = 0;
+    float max_abs    = 0;
+    float min_value  = 0;
+    float max_value  = 0;
+    std::size_t runs = 0;
+
+    calibration_histogram();
+    explicit calibration_histogram(std::size_t bins);
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.counts, "counts"),
+                    f(self.range, "range"),
+                    f(self.max_abs, "max_abs"),
+                    f(self.min_value, "min_value"),
+                    f(self.max_value, "max_value"),
+                    f(self.runs, "runs"));
+    }
+
+    /// Add the values of the argument, which must be in host memory
+    void update(const argument& arg);
+
+    /// The largest absolute value to represent in int8
+    float threshold(const calibration_options& options) const;
+
+    /// The scale and shift used by `quantize_int8_pass`. Asymmetric parameters map the range
+    /// of the values to uint8 with a zero point.
+    std::pair<float, float> quant_params(const calibration_options& options,
+                                         bool asymmetric = false) const;
+
+    private:
+    void grow(float x);
+    // Per thread counts and extremes, kept so that updating does not allocate
+    std::vector<std::size_t> thread_counts;
+    std::vector<float> thread_min;
+    std::vector<float> thread_max;
+};
+
+/// Save the histograms with a key that identifies what they were collected from
+void save_calibration_table(const std::vector<calibration_histogram>& histograms,
+                            const std::string& key,
+                            const std::string& filename);
+/// Load the histograms of a table, which must have been saved with the same key
+std::vector<calibration_histogram> load_calibration_table(const std::string& filename,
+                                                          const std::string& key);
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
@@ -0,0 +1,73 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_MIGRAPHX_COMPILE_CACHE_HPP
+#define MIGRAPHX_GUARD_MIGRAPHX_COMPILE_CACHE_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/compile_options.hpp>
+#include <migraphx/filesystem.hpp>
+#include <migraphx/optional.hpp>
+#include <migraphx/pass.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/target.hpp>
+#include <string>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+/**
+ * A directory of compiled programs. Each program is stored under a hash of the
+ * uncompiled program, the build of the library, the target with the device it
+ * compiles for, its passes and the compile options, so a program compiled once
+ * can be loaded instead of compiled again. Files are
+ * written atomically, and when the directory grows past `max_bytes` the least
+ * recently used programs are removed.
+ */
+struct compile_cache
+{
+    fs::path dir{};
+    std::size_t max_bytes = 0;
+
+    compile_cache() = default;
+    explicit compile_cache(const compile_options& options);
+
+    bool enabled() const;
+
+    std::string key(const program& p,
+                    const target& t,
+                    const std::vector<pass>& passes,
+                    const compile_options& options) const;
+
+    optional<program> load(const std::string& key) const;
+    void store(const std::string& key, const program& p) const;
+
+    /// Remove the least recently used programs until the directory fits in max_bytes
+    void evict(const std::string& keep = "") const;
+};
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
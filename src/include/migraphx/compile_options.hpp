@@ -26,15 +26,25 @@
 
 #include <migraphx/config.hpp>
 #include <migraphx/tracer.hpp>
+#include <cstddef>
+#include <string>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
+struct pass_profile;
+
 struct compile_options
 {
     bool offload_copy = false;
     bool fast_math    = true;
     tracer trace{};
+    /// When set, the time and effect of each pass is recorded here
+    pass_profile* profile = nullptr;
+    /// Directory where compiled programs are cached, MIGRAPHX_COMPILE_CACHE is used when empty
+    std::string cache_dir{};
+    /// Limit in bytes for the cache directory, MIGRAPHX_COMPILE_CACHE_SIZE is used when zero
+    std::size_t cache_size = 0;
 };
 
 } // namespace MIGRAPHX_INLINE_NS
@@ -40,6 +40,7 @@ struct program;
 struct dead_code_elimination
 {
     std::string name() const { return "dead_code_elimination"; }
+    bool idempotent() const { return true; }
     void apply(module& m) const;
     void apply(program& p) const;
 };
@@ -34,11 +34,13 @@ inline namespace MIGRAPHX_INLINE_NS {
 struct module;
 
 /**
- * Remove identical instructions.
+ * Remove identical instructions. Instructions are bucketed by their structural
+ * hash, so the module is processed in a single pass.
  */
 struct eliminate_common_subexpression
 {
     std::string name() const { return "eliminate_common_subexpression"; }
+    bool idempotent() const { return true; }
     void apply(module& m) const;
 };
 
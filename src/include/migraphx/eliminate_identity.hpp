@@ -41,6 +41,7 @@ struct module;
 struct eliminate_identity
 {
     std::string name() const { return "eliminate_identity"; }
+    bool idempotent() const { return true; }
     void apply(module& m) const;
 };
 
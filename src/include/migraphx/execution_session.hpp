@@ -0,0 +1,79 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_MIGRAPHX_EXECUTION_SESSION_HPP
+#define MIGRAPHX_GUARD_MIGRAPHX_EXECUTION_SESSION_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/context.hpp>
+#include <migraphx/program.hpp>
+#include <future>
+#include <mutex>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+/// Evaluates a compiled program with its own context. The program is shared and is not
+/// modified, so each thread can run requests through its own session concurrently. The
+/// program must outlive the session.
+struct execution_session
+{
+    explicit execution_session(const program& p);
+
+    /// A copy evaluates the same program with a new context from the program, so the copy and
+    /// the original can be used from different threads
+    execution_session(const execution_session& other);
+    execution_session& operator=(const execution_session& other);
+
+    /// Evaluate the program and wait for the context to finish
+    std::vector<argument> eval(parameter_map params);
+
+    /// Evaluate the program writing the results into `outputs`, which are returned. The outputs
+    /// are bound to the output parameters when the program was compiled with them, otherwise
+    /// the results are copied into them.
+    std::vector<argument> eval(parameter_map params, const std::vector<argument>& outputs);
+
+    /// Evaluate the program on another thread. Evaluations on the same session run one at a
+    /// time, and the session and the buffers of the arguments must outlive the future.
+    std::future<std::vector<argument>> eval_async(parameter_map params,
+                                                  std::vector<argument> outputs = {});
+
+    /// Names of the parameters the program writes its outputs to, in output order
+    std::vector<std::string> get_output_parameter_names() const;
+
+    context& get_context();
+    const context& get_context() const;
+
+    const program& get_program() const;
+
+    private:
+    const program* prog;
+    context ctx;
+    std::mutex lock;
+};
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif // MIGRAPHX_GUARD_MIGRAPHX_EXECUTION_SESSION_HPP
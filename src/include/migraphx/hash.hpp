@@ -0,0 +1,73 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_MIGRAPHX_HASH_HPP
+#define MIGRAPHX_GUARD_MIGRAPHX_HASH_HPP
+
+#include <migraphx/config.hpp>
+#include <cstddef>
+#include <functional>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct value;
+struct shape;
+struct literal;
+struct operation;
+struct instruction;
+
+inline void hash_combine(std::size_t& seed, std::size_t h)
+{
+    seed ^= h + 0x9e3779b9 + (seed << 6u) + (seed >> 2u);
+}
+
+template <class T>
+void hash_combine(std::size_t& seed, const T& x)
+{
+    hash_combine(seed, std::hash<T>{}(x));
+}
+
+std::size_t hash_value(const value& v);
+
+std::size_t hash_value(const shape& s);
+
+/// Hash of the shape and the bytes of the literal
+std::size_t hash_value(const literal& l);
+
+/// Hash of the name and the serialized attributes of the operator
+std::size_t hash_value(const operation& op);
+
+/**
+ * Structural hash of an instruction. It combines the operator, the output
+ * shape, the identities of the input instructions and modules, and the
+ * contents for literals. Instructions that compare equal have the same hash,
+ * so it can be used to bucket instructions before comparing them with
+ * `operator==`.
+ */
+std::size_t hash_value(const instruction& ins);
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
@@ -81,6 +81,9 @@ struct literal : raw_data<literal>
         std::copy(x, x + s.bytes(), buffer.get());
     }
 
+    /// Shares the buffer instead of copying it, the buffer must hold at least `s.bytes()`
+    literal(const shape& s, std::shared_ptr<char> b) : buffer(std::move(b)), m_shape(s) {}
+
     /// Whether data is available
     bool empty() const { return this->buffer == nullptr; }
 
@@ -0,0 +1,65 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_MIGRAPHX_MAPPED_FILE_HPP
+#define MIGRAPHX_GUARD_MIGRAPHX_MAPPED_FILE_HPP
+
+#include <migraphx/config.hpp>
+#include <memory>
+#include <string>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+/**
+ * @brief A read-only view of a whole file mapped into memory
+ * @details The file is mapped privately, so pages are shared with the page cache
+ * until they are written to. Copies of the object share the same mapping, which is
+ * unmapped once the last reference (including any from `share`) goes away.
+ */
+struct mapped_file
+{
+    mapped_file() = default;
+    explicit mapped_file(const std::string& filename);
+
+    /// Whether a file is mapped
+    bool empty() const;
+
+    /// Provides a raw pointer to the start of the mapping
+    const char* data() const;
+
+    /// Size of the mapped file in bytes
+    std::size_t size() const;
+
+    /// Returns a pointer to `nbytes` at `offset` that keeps the mapping alive
+    std::shared_ptr<char> share(std::size_t offset, std::size_t nbytes) const;
+
+    private:
+    std::shared_ptr<char> buffer = nullptr;
+    std::size_t nbytes           = 0;
+};
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif // MIGRAPHX_GUARD_MIGRAPHX_MAPPED_FILE_HPP
@@ -0,0 +1,81 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_AMDMIGRAPHX_MATCH_ATTENTION_HPP
+#define MIGRAPHX_GUARD_AMDMIGRAPHX_MATCH_ATTENTION_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/matcher.hpp>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace match {
+
+namespace detail {
+template <class F>
+struct attention_matcher
+{
+    F f;
+    // The parts are type erased since the alternatives would otherwise repeat the same matchers
+    // many times over
+    any_matcher qk() const { return f("dot")(arg(0)(any().bind("q")), arg(1)(any().bind("k"))); }
+
+    any_matcher scaled_qk() const
+    {
+        auto scale = skip_broadcasts(is_constant().bind("scale"));
+        return any_of(f("mul")(either_arg(0, 1)(qk(), scale)),
+                      f("div")(arg(0)(qk()), arg(1)(scale)),
+                      qk());
+    }
+
+    any_matcher scores() const
+    {
+        return any_of(f("add")(either_arg(0, 1)(scaled_qk(), any().bind("mask"))), scaled_qk());
+    }
+
+    auto matcher() const
+    {
+        return f("dot")(arg(0)(f("softmax")(arg(0)(scores())).bind("softmax")),
+                        arg(1)(any().bind("v")));
+    }
+};
+} // namespace detail
+
+/// Scaled dot product attention: softmax(q * k * scale + mask) * v, where the scale and the mask
+/// are optional
+template <class F>
+auto attention(F f)
+{
+    return detail::attention_matcher<F>{f}.matcher();
+}
+
+inline auto attention()
+{
+    return attention([](auto x) { return name(x); });
+}
+
+} // namespace match
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
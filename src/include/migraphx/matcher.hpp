@@ -31,9 +31,14 @@
 #include <migraphx/optional.hpp>
 #include <migraphx/iterator_for.hpp>
 #include <migraphx/type_name.hpp>
+#include <migraphx/pass_profile.hpp>
+#include <migraphx/rank.hpp>
 #include <migraphx/config.hpp>
+#include <deque>
+#include <functional>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -103,6 +108,44 @@ struct predicate_matcher
     }
 };
 
+template <class M>
+auto get_root_names(rank<1>, const M& m) -> decltype(m.root_names())
+{
+    return m.root_names();
+}
+
+template <class M>
+optional<std::vector<std::string>> get_root_names(rank<0>, const M&)
+{
+    return nullopt;
+}
+
+/// Get the operator names that the matcher can match at the root, or nullopt
+/// if the matcher could match any instruction
+template <class M>
+optional<std::vector<std::string>> get_root_names(const M& m)
+{
+    return get_root_names(rank<1>{}, m);
+}
+
+/// Attach the operator names a matcher can match at the root
+template <class M>
+struct rooted_matcher
+{
+    optional<std::vector<std::string>> names;
+    M m;
+
+    auto match(matcher_context& ctx, instruction_ref ins) const { return m.match(ctx, ins); }
+
+    optional<std::vector<std::string>> root_names() const { return names; }
+};
+
+template <class M>
+rooted_matcher<M> make_rooted_matcher(optional<std::vector<std::string>> names, M m)
+{
+    return {std::move(names), m};
+}
+
 /// Convert a function into a matcher
 template <class F>
 struct function_matcher
@@ -123,9 +166,11 @@ function_matcher<F> make_function_matcher(F f)
 template <class M>
 auto bind_match(M m, std::string name)
 {
-    return make_function_matcher(
-        [=, name = std::move(name)](matcher_context& ctx,
-                                    instruction_ref ins) -> optional<instruction_ref> {
+    return make_rooted_matcher(
+        get_root_names(m),
+        make_function_matcher([=, name = std::move(name)](
+                                  matcher_context& ctx,
+                                  instruction_ref ins) -> optional<instruction_ref> {
             auto result = m.match(ctx, ins);
             if(result)
             {
@@ -134,7 +179,7 @@ auto bind_match(M m, std::string name)
                 ctx.instructions[name] = ins;
             }
             return result;
-        });
+        }));
 }
 
 /// Convert a matcher to a bindable matcher
@@ -203,23 +248,28 @@ struct basic_matcher
     {
         // Copy m because we cant capture `this` by value
         auto mm = m;
-        return make_basic_fun_matcher([=](matcher_context& ctx,
-                                          instruction_ref ins) -> optional<instruction_ref> {
-            auto result = mm.match(ctx, ins);
-            if(result)
-            {
-                bool matches =
-                    fold([&](auto x, auto y) { return x and ctx.matched(y, result); })(true, ms...);
-                if(matches)
-                    return result;
-            }
-            return nullopt;
-        });
+        return make_basic_matcher(make_rooted_matcher(
+            get_root_names(m),
+            make_function_matcher(
+                [=](matcher_context& ctx, instruction_ref ins) -> optional<instruction_ref> {
+                    auto result = mm.match(ctx, ins);
+                    if(result)
+                    {
+                        bool matches = fold([&](auto x, auto y) {
+                            return x and ctx.matched(y, result);
+                        })(true, ms...);
+                        if(matches)
+                            return result;
+                    }
+                    return nullopt;
+                })));
     }
 
     auto bind(std::string name) const { return bind_match(m, std::move(name)); }
 
     auto match(matcher_context& ctx, instruction_ref ins) const { return m.match(ctx, ins); }
+
+    optional<std::vector<std::string>> root_names() const { return get_root_names(m); }
 };
 
 /// Create a basic matcher from a matcher
@@ -249,9 +299,16 @@ using any_matcher_base = basic_matcher<
 struct any_matcher : any_matcher_base
 {
     template <class M>
-    any_matcher(M mm) : any_matcher_base({[=](auto& ctx, auto ins) { return mm.match(ctx, ins); }})
+    any_matcher(M mm)
+        : any_matcher_base({[=](auto& ctx, auto ins) { return mm.match(ctx, ins); }}),
+          names(get_root_names(mm))
     {
     }
+
+    optional<std::vector<std::string>> root_names() const { return names; }
+
+    private:
+    optional<std::vector<std::string>> names;
 };
 
 /// This macro takes care of the boilerplate for defining a matcher
@@ -372,6 +429,8 @@ void find_matches(Mod& mod, instruction_ref ins, Ms&&... ms)
                 get_module(mod).debug_print(ins);
             }
             m.apply(mod, r);
+            if(auto* counts = profiled_matches())
+                (*counts)[get_type_name(m)]++;
             match = true;
         },
         ms...);
@@ -387,6 +446,162 @@ void find_matches(Mod& mod, Ms&&... ms)
     }
 }
 
+/// Apply the finders to the module until no more matches are found. Finders are
+/// only tried on instructions with an operator their matcher can match at the root. After a
+/// rewrite only the instructions that were affected, and their users, are visited again, and
+/// instructions left unused by a rewrite are removed.
+template <class Mod, class... Ms>
+void rewrite_matches(Mod& mod, Ms&&... ms)
+{
+#if !defined(__GNUC__) || defined(__clang__) || __GNUC__ > 5
+    const
+#endif
+        int trace = value_of(MIGRAPHX_TRACE_MATCHES{});
+    module& m     = get_module(mod);
+    std::vector<optional<std::vector<std::string>>> roots;
+    std::vector<std::function<bool(instruction_ref)>> finders;
+    each_args(
+        [&](auto&& f) {
+            auto* fp     = &f;
+            auto matcher = f.matcher();
+            roots.push_back(get_root_names(matcher));
+            finders.push_back([&, fp, matcher](instruction_ref ins) {
+                if(trace > 1)
+                    std::cout << "Match: " << get_type_name(*fp) << std::endl;
+                auto r = match_instruction(m, ins, matcher);
+                if(r.result == m.end())
+                    return false;
+                if(trace > 0)
+                {
+                    std::cout << "Matched by " << get_type_name(*fp) << std::endl;
+                    m.debug_print(ins);
+                }
+                fp->apply(mod, r);
+                if(auto* counts = profiled_matches())
+                    (*counts)[get_type_name(*fp)]++;
+                return true;
+            });
+        },
+        ms...);
+
+    // Finders that can match an operator, in the order they were passed
+    std::unordered_map<std::string, std::vector<std::size_t>> dispatch;
+    auto get_finders = [&](const std::string& name) -> const std::vector<std::size_t>& {
+        auto it = dispatch.find(name);
+        if(it != dispatch.end())
+            return it->second;
+        std::vector<std::size_t> result;
+        for(std::size_t i = 0; i < roots.size(); i++)
+        {
+            if(not roots[i].has_value() or contains(*roots[i], name))
+                result.push_back(i);
+        }
+        return dispatch.emplace(name, std::move(result)).first->second;
+    };
+
+    std::deque<instruction_ref> worklist;
+    std::unordered_set<instruction_ref> queued;
+    std::unordered_set<instruction_ref> known;
+    std::unordered_set<instruction_ref> removed;
+    std::vector<instruction_ref> dead;
+    auto push = [&](instruction_ref ins) {
+        if(contains(removed, ins))
+            return;
+        if(queued.insert(ins).second)
+            worklist.push_back(ins);
+    };
+    auto is_dead = [&](instruction_ref ins) {
+        if(not ins->outputs().empty() or ins == std::prev(m.end()) or ins->name() == "@param")
+            return false;
+        // Same as dead_code_elimination, keep instructions that could have side effects
+        return ins->get_shape().elements() != 0 or ins->name().front() == '@' or
+               contains({"undefined", "identity", "allocate"}, ins->name());
+    };
+    // Detach unused instructions, they are removed once matching is done
+    auto remove_dead = fix([&](auto self, instruction_ref ins) -> void {
+        if(contains(removed, ins) or not is_dead(ins))
+            return;
+        removed.insert(ins);
+        dead.push_back(ins);
+        auto args = ins->inputs();
+        ins->clear_arguments();
+        for(auto arg : args)
+        {
+            push(arg);
+            self(arg);
+        }
+    });
+    // Walk from an instruction to find the instructions inserted by a rewrite
+    auto find_new = fix([&](auto self, instruction_ref ins) -> void {
+        auto visit = [&](instruction_ref x) {
+            if(not known.insert(x).second)
+                return;
+            push(x);
+            self(x);
+        };
+        auto inputs  = ins->inputs();
+        auto outputs = ins->outputs();
+        std::for_each(inputs.begin(), inputs.end(), visit);
+        std::for_each(outputs.begin(), outputs.end(), visit);
+    });
+
+    for(auto ins : iterator_for(m))
+        known.insert(ins);
+    // Guard against finders that keep undoing each other
+    std::size_t max_rewrites = 64 * (m.size() + 1);
+    std::size_t rewrites     = 0;
+    bool changed             = true;
+    while(changed and rewrites < max_rewrites)
+    {
+        changed = false;
+        // Start from every instruction, so that the module is a fixed point once
+        // the worklist is drained without finding any match
+        for(auto ins : iterator_for(m))
+            push(ins);
+        while(not worklist.empty() and rewrites < max_rewrites)
+        {
+            auto ins = worklist.front();
+            worklist.pop_front();
+            queued.erase(ins);
+            if(contains(removed, ins))
+                continue;
+            if(is_dead(ins))
+            {
+                remove_dead(ins);
+                continue;
+            }
+            auto inputs            = ins->inputs();
+            auto outputs           = ins->outputs();
+            auto version           = m.version();
+            const auto& candidates = get_finders(ins->name());
+            auto it = std::find_if(candidates.begin(), candidates.end(), [&](std::size_t i) {
+                return finders[i](ins);
+            });
+            // The finder can still decide not to rewrite after matching
+            if(it == candidates.end() or m.version() == version)
+                continue;
+            changed = true;
+            rewrites++;
+            std::vector<instruction_ref> affected{ins};
+            affected.insert(affected.end(), inputs.begin(), inputs.end());
+            affected.insert(affected.end(), outputs.begin(), outputs.end());
+            for(auto a : affected)
+            {
+                if(contains(removed, a))
+                    continue;
+                find_new(a);
+                push(a);
+                for(auto output : a->outputs())
+                    push(output);
+            }
+            for(auto a : affected)
+                remove_dead(a);
+        }
+    }
+    for(auto ins : dead)
+        m.remove_instruction(ins);
+}
+
 template <class M, class F>
 struct find_generic_match
 {
@@ -616,10 +831,15 @@ inline auto var(std::string s)
         });
 }
 
+template <class P>
+auto make_name_matcher(std::vector<std::string> names, P p)
+{
+    return make_basic_matcher(make_rooted_matcher(std::move(names), predicate_matcher<P>{p}));
+}
+
 inline auto name(std::string s)
 {
-    return make_basic_pred_matcher(
-        [=, s = std::move(s)](instruction_ref ins) { return ins->name() == s; });
+    return make_name_matcher({s}, [=](instruction_ref ins) { return ins->name() == s; });
 }
 
 inline auto name_contains(const std::string& name)
@@ -630,7 +850,7 @@ inline auto name_contains(const std::string& name)
 
 inline auto name(std::unordered_set<std::string> names)
 {
-    return make_basic_pred_matcher([=, names = std::move(names)](instruction_ref ins) {
+    return make_name_matcher({names.begin(), names.end()}, [=](instruction_ref ins) {
         return names.count(ins->name()) > 0;
     });
 }
@@ -33,12 +33,22 @@ inline namespace MIGRAPHX_INLINE_NS {
 struct module;
 
 /**
- * Remove memory allocations. It uses graph coloring to find memory allocations that can be reused.
+ * Remove memory allocations by placing them in a scratch memory, where allocations that aren't
+ * live at the same time can share memory. The default planner places the allocations by best
+ * fit from the largest to the smallest, and the graph coloring planner can be selected with
+ * the `planner` member or the MIGRAPHX_MEMORY_PLANNER environment variable.
  */
 struct memory_coloring
 {
     std::string allocation_op{};
     bool verify = false;
+    // "best_fit" or "coloring", defaults to MIGRAPHX_MEMORY_PLANNER or best_fit when empty
+    std::string planner{};
+    // Let pointwise operators write their output over an input that dies at the operator
+    bool reuse_pointwise = false;
+    // Print the peak live bytes and the planned scratch size, which is also enabled by
+    // MIGRAPHX_TRACE_MEMORY_COLORING
+    bool report = false;
     std::string name() const { return "memory coloring"; }
     void apply(module& m) const;
 };
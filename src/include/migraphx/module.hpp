@@ -72,6 +72,10 @@ struct module
     bool bypass() const;
     void set_bypass(bool b = true);
 
+    /// Returns a value that changes whenever the module is modified through
+    /// its member functions, so passes can tell an unchanged module apart
+    std::size_t version() const;
+
     template <class... Ts, MIGRAPHX_REQUIRES(std::is_same<Ts, instruction_ref>{}...)>
     instruction_ref add_instruction(operation op, Ts... args)
     {
@@ -113,6 +117,8 @@ struct module
 
     instruction_ref replace_instruction(instruction_ref ins, instruction_ref rep);
 
+    void replace_argument(instruction_ref ins, instruction_ref old, instruction_ref new_ins);
+
     instruction_ref remove_instruction(instruction_ref ins);
     instruction_ref remove_instructions(instruction_ref first, instruction_ref last);
 
@@ -84,14 +84,14 @@ struct loop
     {
         int64_t max_iterations = 0;
 
-        template <class T>
-        void copy(context&, const argument& src, T& dst) const
+        template <class Context, class T>
+        void copy(Context&, const argument& src, T& dst) const
         {
             dst = *src.cast<T>();
         }
 
-        template <class T>
-        void copy(context&, T src, const argument& dst) const
+        template <class Context, class T>
+        void copy(Context&, T src, const argument& dst) const
         {
             *dst.cast<T>() = src;
         }
@@ -114,7 +114,8 @@ struct loop
             }
         }
 
-        void set_zero(context&, const std::vector<argument>& concatenated_outputs, int iter) const
+        template <class Context>
+        void set_zero(Context&, const std::vector<argument>& concatenated_outputs, int iter) const
         {
             if(iter >= max_iterations)
                 return;
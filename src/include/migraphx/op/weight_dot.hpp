@@ -0,0 +1,127 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_OPERATORS_WEIGHT_DOT_HPP
+#define MIGRAPHX_GUARD_OPERATORS_WEIGHT_DOT_HPP
+
+#include <migraphx/check_shapes.hpp>
+#include <migraphx/stringutils.hpp>
+#include <migraphx/streamutils.hpp>
+#include <migraphx/argument.hpp>
+#include <migraphx/config.hpp>
+#include <migraphx/par_for.hpp>
+#include <migraphx/reflect.hpp>
+#include <migraphx/value.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace op {
+
+/**
+ * A dot product where only the second operand, the weights, are quantized. The weights of shape
+ * {k, n} are stored transposed as int8 of shape {n, k * bits / 8}, with two signed 4-bit values
+ * per byte (the even k in the low nibble) when bits is 4. Each group of group_size consecutive k
+ * for an output column has its own scale, stored as {n, k / group_size}.
+ */
+struct weight_dot
+{
+    std::size_t bits       = 8;
+    std::size_t group_size = 128;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.bits, "bits"), f(self.group_size, "group_size"));
+    }
+
+    std::string name() const { return "weight_dot"; }
+
+    shape compute_shape(std::vector<shape> inputs) const
+    {
+        check_shapes{inputs, *this}.has(3).standard();
+        if(bits != 4 and bits != 8)
+            MIGRAPHX_THROW("WEIGHT_DOT: only 4 or 8 bits are supported");
+        const auto& a = inputs.at(0);
+        const auto& w = inputs.at(1);
+        const auto& s = inputs.at(2);
+        if(a.lens().size() < 2 or w.lens().size() != 2 or s.lens().size() != 2)
+            MIGRAPHX_THROW("WEIGHT_DOT: the weights and scales must be 2D");
+        if(w.type() != shape::int8_type or s.type() != a.type())
+            MIGRAPHX_THROW("WEIGHT_DOT: the weights must be int8 and the scales the input type");
+        auto k = a.lens().back();
+        if(group_size == 0 or k % group_size != 0 or w.lens()[1] * 8 != k * bits or
+           s.lens() != std::vector<std::size_t>{w.lens()[0], k / group_size})
+        {
+            MIGRAPHX_THROW("WEIGHT_DOT: mismatched dimensions: {" + to_string_range(a.lens()) +
+                           "} x {" + to_string_range(w.lens()) + "}");
+        }
+        auto out_lens   = a.lens();
+        out_lens.back() = w.lens()[0];
+        return {a.type(), out_lens};
+    }
+
+    // The k-th quantized weight of a row of the packed weights
+    int unpack(const int8_t* row, std::size_t k) const
+    {
+        if(bits == 8)
+            return row[k];
+        auto b = row[k / 2];
+        if(k % 2 == 0)
+            return static_cast<int8_t>(static_cast<uint8_t>(b) << 4) >> 4;
+        return b >> 4;
+    }
+
+    argument compute(const shape& output_shape, std::vector<argument> args) const
+    {
+        argument result{output_shape};
+        auto k        = args[0].get_shape().lens().back();
+        auto n        = output_shape.lens().back();
+        auto stride   = args[1].get_shape().lens()[1];
+        auto groups   = k / group_size;
+        const auto* w = args[1].cast<int8_t>();
+        visit_all(result, args[0], args[2])([&](auto output, auto a, auto scales) {
+            par_for(output_shape.elements(), [&](auto i) {
+                auto row   = i / n;
+                auto col   = i % n;
+                double sum = 0;
+                for(std::size_t g = 0; g < groups; g++)
+                {
+                    double group_sum = 0;
+                    for(std::size_t j = g * group_size; j < (g + 1) * group_size; j++)
+                        group_sum += a[row * k + j] * unpack(w + col * stride, j);
+                    sum += group_sum * scales[col * groups + g];
+                }
+                output[i] = sum;
+            });
+        });
+        return result;
+    }
+};
+
+} // namespace op
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
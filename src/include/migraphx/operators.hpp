@@ -136,6 +136,7 @@
 #include <migraphx/op/undefined.hpp>
 #include <migraphx/op/unknown.hpp>
 #include <migraphx/op/unsqueeze.hpp>
+#include <migraphx/op/weight_dot.hpp>
 #include <migraphx/op/where.hpp>
 
 #endif
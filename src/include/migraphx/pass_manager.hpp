@@ -45,8 +45,16 @@ struct module_pass_manager
     virtual ~module_pass_manager() {}
 };
 
-void run_passes(module& mod, const std::vector<pass>& passes, tracer trace = tracer{});
-void run_passes(program& prog, const std::vector<pass>& passes, tracer trace = tracer{});
+struct pass_profile;
+
+void run_passes(module& mod,
+                const std::vector<pass>& passes,
+                tracer trace          = tracer{},
+                pass_profile* profile = nullptr);
+void run_passes(program& prog,
+                const std::vector<pass>& passes,
+                tracer trace          = tracer{},
+                pass_profile* profile = nullptr);
 
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
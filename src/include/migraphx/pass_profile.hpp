@@ -0,0 +1,73 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_MIGRAPHX_PASS_PROFILE_HPP
+#define MIGRAPHX_GUARD_MIGRAPHX_PASS_PROFILE_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/value.hpp>
+#include <iosfwd>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+/// Statistics collected by `run_passes` for each pass applied to each module
+struct pass_profile
+{
+    struct record
+    {
+        std::string pass;
+        // Empty when the pass was applied to the whole program
+        std::string module;
+        double ms                       = 0;
+        std::size_t instructions_before = 0;
+        std::size_t instructions_after  = 0;
+        bool skipped                    = false;
+        // Number of times each finder applied in `match::find_matches`
+        std::unordered_map<std::string, std::size_t> matches;
+    };
+    std::vector<record> records;
+
+    double total_ms() const;
+
+    value to_value() const;
+
+    /// Print the time of each pass summed over all the modules, slowest first
+    void print_summary(std::ostream& os) const;
+};
+
+namespace match {
+
+/// The match counts of the pass being profiled on the current thread, or
+/// nullptr when passes are not being profiled
+std::unordered_map<std::string, std::size_t>*& profiled_matches();
+
+} // namespace match
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
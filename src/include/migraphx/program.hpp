@@ -76,6 +76,10 @@ struct program
 
     std::vector<argument> eval(parameter_map params) const;
 
+    // Evaluate with a separate context, so that several threads can evaluate the same compiled
+    // program at once as long as each uses its own context
+    std::vector<argument> eval(context& ctx, parameter_map params) const;
+
     std::size_t size() const;
 
     std::vector<shape> get_output_shapes() const;
@@ -88,6 +92,9 @@ struct program
 
     bool is_compiled() const;
 
+    // Create a new context for the target the program was compiled for
+    context create_context() const;
+
     void finalize();
 
     void
@@ -97,6 +104,10 @@ struct program
 
     value to_value() const;
     void from_value(const value& v);
+    /// Serialize the program with the raw data of its literals written to the section
+    value to_value(data_section& section) const;
+    /// Deserialize a program whose raw data was written to the section
+    void from_value(const value& v, const data_section& section);
 
     void debug_print() const;
     void debug_print(instruction_ref ins) const;
@@ -139,6 +150,8 @@ struct program
 
     private:
     void assign(const program& p);
+    value to_value(data_section* section) const;
+    void from_value(const value& v, const data_section* section);
     std::unique_ptr<program_impl> impl;
 };
 
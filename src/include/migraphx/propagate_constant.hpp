@@ -34,9 +34,19 @@ struct module;
 
 /**
  * Replace instructions which take all literals with a literal of the computation.
+ *
+ * The constant instructions are evaluated once each in topological order, with the instructions
+ * that do not depend on each other evaluated in parallel. Folded results can be cached on disk,
+ * keyed by the operators and the contents of the literals they are computed from.
  */
 struct propagate_constant
 {
+    /// Instructions whose output is this many times larger than their inputs are not folded
+    std::size_t max_growth = 16;
+    /// Outputs up to this many bytes are folded regardless of how much they grow
+    std::size_t min_growth_bytes = 1024 * 1024;
+    /// Directory of the cache of folded literals, which defaults to MIGRAPHX_CONSTANT_CACHE
+    std::string cache_dir = "";
     std::string name() const { return "propagate_constant"; }
     void apply(module& m) const;
 };
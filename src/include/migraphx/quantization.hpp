@@ -26,6 +26,7 @@
 
 #include <string>
 #include <vector>
+#include <migraphx/calibration.hpp>
 #include <migraphx/instruction_ref.hpp>
 #include <migraphx/operation.hpp>
 #include <migraphx/config.hpp>
@@ -43,7 +44,13 @@ void quantize_fp16(program& prog, const std::vector<std::string>& ins_names = {"
 void quantize_int8(program& prog,
                    const target& t,
                    const std::vector<parameter_map>& calibration,
-                   const std::vector<std::string>& ins_names = {"dot", "convolution"});
+                   const std::vector<std::string>& ins_names = {"dot", "convolution"},
+                   const calibration_options& options        = {});
+
+void quantize_weights(program& prog,
+                      const target& t,
+                      std::size_t bits       = 8,
+                      std::size_t group_size = 128);
 
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
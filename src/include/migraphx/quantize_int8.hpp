@@ -27,6 +27,7 @@
 #include <string>
 #include <vector>
 #include <functional>
+#include <set>
 #include <migraphx/argument.hpp>
 #include <migraphx/config.hpp>
 
@@ -55,6 +56,10 @@ struct quantize_int8_pass
 {
     std::vector<std::string> ins_names = {"dot", "convolution"};
     std::vector<std::pair<float, float>> quant_params;
+    // Quantize constant weights with a scale per output channel computed from their values
+    bool per_channel = false;
+    // Indices of the quant_params that quantize to uint8 with a zero point
+    std::set<std::size_t> asymmetric_params;
     std::string name() const { return "quantize_int8"; }
     void apply(module& m) const;
 };
@@ -0,0 +1,90 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_MIGRAPHX_REQUEST_BATCHER_HPP
+#define MIGRAPHX_GUARD_MIGRAPHX_REQUEST_BATCHER_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/program.hpp>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct batcher_options
+{
+    /// Most requests run together, zero uses the largest bucket size
+    std::size_t max_batch = 0;
+    /// Longest time a request waits in the queue for other requests to join its batch
+    std::chrono::microseconds max_latency{1000};
+};
+
+struct batcher_stats
+{
+    std::size_t requests = 0;
+    std::size_t batches  = 0;
+    /// Slots of the batches that were filled with padding
+    std::size_t padding = 0;
+};
+
+struct request_batcher_impl;
+
+/**
+ * @brief Groups single-sample requests into batches for programs compiled for fixed batch sizes
+ * @details Each program is compiled for a different batch size (a bucket), where the first
+ * dimension of every parameter and output is the batch. Requests queue until either `max_batch`
+ * of them are waiting or the oldest one has waited `max_latency`. They are then packed into the
+ * smallest bucket that fits them, padding the unused slots, and the outputs are split back into
+ * one result per request. The outputs must be on the host, so gpu programs need offload copy.
+ */
+struct request_batcher
+{
+    request_batcher(std::vector<program> programs, batcher_options options = {});
+    request_batcher(const request_batcher&) = delete;
+    request_batcher& operator=(const request_batcher&) = delete;
+    /// Runs the requests still queued before returning
+    ~request_batcher();
+
+    /// Queue one sample, where each parameter has a batch dimension of 1
+    std::future<std::vector<argument>> submit(parameter_map params);
+
+    std::vector<std::size_t> get_bucket_sizes() const;
+
+    /// The shapes of the parameters for a single sample
+    std::unordered_map<std::string, shape> get_parameter_shapes() const;
+
+    batcher_stats get_stats() const;
+
+    private:
+    std::unique_ptr<request_batcher_impl> impl;
+};
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif // MIGRAPHX_GUARD_MIGRAPHX_REQUEST_BATCHER_HPP
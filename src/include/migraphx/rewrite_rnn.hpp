@@ -35,16 +35,31 @@ namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
 struct module;
+struct module_pass_manager;
 
 /**
  * Rewrite rnn to gemm and add.
+ *
+ * By default the sequence is unrolled. In the compact mode each direction is computed with a
+ * loop instead, where the body only has the recurrent gemm for all the gates and the update of
+ * the gates. The sequences with variable lengths are still unrolled.
  */
 struct rewrite_rnn
 {
+    bool compact = false;
+
     std::string name() const { return "rewrite_rnn"; }
-    void apply(module& m) const;
+    void apply(module_pass_manager& mpm) const;
 
     private:
+    // for the compact mode
+    void apply_compact(module_pass_manager& mpm, instruction_ref ins, std::size_t n) const;
+    std::vector<instruction_ref> compact_cell(const module& m,
+                                              module& body,
+                                              instruction_ref ins,
+                                              std::vector<instruction_ref> inputs,
+                                              const std::vector<operation>& actv_funcs) const;
+
     // for vanilla rnn operators
     void apply_vanilla_rnn(module& m, instruction_ref ins) const;
     std::vector<instruction_ref> vanilla_rnn_cell(bool is_forward,
@@ -29,7 +29,10 @@
 #include <migraphx/reflect.hpp>
 #include <migraphx/requires.hpp>
 #include <migraphx/rank.hpp>
+#include <memory>
+#include <string>
 #include <type_traits>
+#include <vector>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -52,6 +55,51 @@ T from_value(const value& v)
     return x;
 }
 
+struct literal;
+
+/**
+ * @brief Out-of-line storage for the raw data of literals and arguments
+ * @details Raw data is normally serialized inline as a binary value. A program serialized with a
+ * data section instead appends its raw data to the section and only stores the offset in the
+ * value. When reading, literals and the raw data held by operators share the section's buffer
+ * rather than copy it, so a section backed by a mapped file gives data that points straight into
+ * the mapping. Each entry is aligned to `alignment` bytes from the start of the section.
+ */
+struct data_section
+{
+    static constexpr std::size_t alignment = 64;
+
+    /// Creates an empty section that raw data will be written to
+    data_section();
+    /// Creates a section that raw data is read from
+    data_section(std::shared_ptr<char> data, std::size_t size);
+
+    bool is_writable() const;
+    /// The data written so far
+    const std::vector<char>& contents() const;
+    /// Appends the data and returns its offset
+    std::size_t write(const char* data, std::size_t nbytes);
+    /// Returns a pointer to the data at offset that shares ownership with the section
+    std::shared_ptr<char> read(std::size_t offset, std::size_t nbytes) const;
+
+    /// Serializes the literal with its data written to the section
+    value to_value(const literal& l);
+    /// Deserializes a literal, which shares the section's buffer when its data is stored there
+    literal literal_from_value(const value& v) const;
+    /// Moves all raw data stored inline in the value to the section
+    void store(value& v);
+    /// Tags all raw data of the value that is stored in the section with the id of the section,
+    /// so that from_value shares the section's buffer for it while the section is alive
+    void load(value& v) const;
+
+    private:
+    std::vector<char> output;
+    std::shared_ptr<char> input           = nullptr;
+    std::size_t input_size                = 0;
+    bool writable                         = false;
+    std::shared_ptr<const std::string> id = nullptr;
+};
+
 namespace detail {
 
 template <class T, MIGRAPHX_REQUIRES(std::is_empty<T>{})>
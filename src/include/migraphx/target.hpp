@@ -82,6 +82,15 @@ struct target
      * @return Allocated argument in the target.
      */
     argument allocate(const shape& s) const;
+    /**
+     * @brief Identify the device the compiled code is built for.
+     *
+     * Compiled programs are only reused on devices with the same identity. Targets that
+     * generate code for the exact device, such as a specific gpu architecture or the host cpu
+     * features, should return a string that changes with it.
+     * @return A string identifying the device, which is empty when the code is portable.
+     */
+    std::string device_identity() const;
 };
 
 #else
@@ -105,6 +114,12 @@ argument copy_from_target(T&, const argument& arg)
     return arg;
 }
 
+template <class T>
+std::string target_device_identity(T&)
+{
+    return "";
+}
+
 #ifdef TYPE_ERASED_DECLARATION
 
 // Type-erased interface for:
@@ -122,6 +137,8 @@ struct target
     argument copy_from(const argument& input) const;
     // (optional)
     argument allocate(const shape& s) const;
+    // (optional)
+    std::string device_identity() const;
 };
 
 #else
@@ -225,6 +242,12 @@ struct target
         return (*this).private_detail_te_get_handle().allocate(s);
     }
 
+    std::string device_identity() const
+    {
+        assert((*this).private_detail_te_handle_mem_var);
+        return (*this).private_detail_te_get_handle().device_identity();
+    }
+
     friend bool is_shared(const target& private_detail_x, const target& private_detail_y)
     {
         return private_detail_x.private_detail_te_handle_mem_var ==
@@ -245,6 +268,7 @@ struct target
         virtual argument copy_to(const argument& input) const                      = 0;
         virtual argument copy_from(const argument& input) const                    = 0;
         virtual argument allocate(const shape& s) const                            = 0;
+        virtual std::string device_identity() const                                = 0;
     };
 
     template <class T>
@@ -291,6 +315,20 @@ struct target
         return target_allocate(private_detail_te_self, s);
     }
 
+    template <class T>
+    static auto private_detail_te_default_device_identity(char, T&& private_detail_te_self)
+        -> decltype(private_detail_te_self.device_identity())
+    {
+        return private_detail_te_self.device_identity();
+    }
+
+    template <class T>
+    static std::string private_detail_te_default_device_identity(float,
+                                                                 T&& private_detail_te_self)
+    {
+        return target_device_identity(private_detail_te_self);
+    }
+
     template <typename PrivateDetailTypeErasedT>
     struct private_detail_te_handle_type : private_detail_te_handle_base_type
     {
@@ -347,6 +385,12 @@ struct target
             return private_detail_te_default_allocate(char(0), private_detail_te_value, s);
         }
 
+        std::string device_identity() const override
+        {
+
+            return private_detail_te_default_device_identity(char(0), private_detail_te_value);
+        }
+
         PrivateDetailTypeErasedT private_detail_te_value;
     };
 
@@ -0,0 +1,76 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_RTGLIB_THREAD_POOL_HPP
+#define MIGRAPHX_GUARD_RTGLIB_THREAD_POOL_HPP
+
+#include <migraphx/config.hpp>
+#include <functional>
+#include <memory>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct thread_pool_impl;
+
+/**
+ * @brief A persistent pool of threads that execute tasks by work stealing
+ * @details The thread calling `run` always executes tasks as well, so a pool of size n has n-1
+ * threads. Tasks submitted from a thread of the pool go to that thread's own queue, which lets
+ * `run` be nested without oversubscribing the cores or deadlocking.
+ */
+struct thread_pool
+{
+    thread_pool(std::size_t n, bool affinity = false);
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+    ~thread_pool();
+
+    /// Number of threads that can execute tasks concurrently
+    std::size_t size() const;
+
+    /// Calls `f(i)` for every `i` in `[0, n)` and waits for them to finish. The first exception
+    /// thrown by a task is rethrown after all the tasks have finished.
+    void run(std::size_t n, const std::function<void(std::size_t)>& f);
+
+    /// Runs `f` on a thread of the pool without waiting for it. It is only picked up by a thread
+    /// that has no other task, and runs on the calling thread when the pool has no other
+    /// threads. The task must not throw.
+    void submit(std::function<void()> f);
+
+    /**
+     * @brief The pool shared by the whole process
+     * @details The size defaults to the number of hardware threads, and can be set with the
+     * MIGRAPHX_NUM_THREADS environment variable. Setting MIGRAPHX_THREAD_AFFINITY pins each
+     * thread of the pool to a core.
+     */
+    static thread_pool& global();
+
+    private:
+    std::unique_ptr<thread_pool_impl> impl;
+};
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
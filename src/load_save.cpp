@@ -24,15 +24,77 @@
 #include <migraphx/load_save.hpp>
 #include <migraphx/file_buffer.hpp>
 #include <migraphx/json.hpp>
+#include <migraphx/mapped_file.hpp>
 #include <migraphx/msgpack.hpp>
-#include <migraphx/file_buffer.hpp>
-#include <fstream>
+#include <migraphx/make_shared_array.hpp>
+#include <migraphx/serialize.hpp>
+#include <array>
+#include <cstring>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
+// Programs saved as msgpack keep the raw data of their literals in a separate data section
+// that follows the msgpack'd program:
+//
+//   header | msgpack | padding | data section
+//
+// The data section starts on a page boundary so the file can be mapped and the literals used
+// in place.
+struct data_section_header
+{
+    std::array<char, 8> magic = {'M', 'I', 'G', 'X', 'D', 'S', '0', '1'};
+    std::uint64_t value_offset = 0;
+    std::uint64_t value_size   = 0;
+    std::uint64_t data_offset  = 0;
+    std::uint64_t data_size    = 0;
+};
+
+static std::size_t align_to(std::size_t n, std::size_t alignment = 4096)
+{
+    return (n + alignment - 1) / alignment * alignment;
+}
+
+static bool read_header(const char* buffer, std::size_t size, data_section_header& header)
+{
+    if(size < sizeof(data_section_header))
+        return false;
+    data_section_header result;
+    std::memcpy(&result, buffer, sizeof(data_section_header));
+    if(result.magic != data_section_header{}.magic)
+        return false;
+    if(result.value_offset + result.value_size > size or
+       result.data_offset + result.data_size > size)
+        MIGRAPHX_THROW("Truncated program file");
+    header = result;
+    return true;
+}
+
+static program load_msgpack(std::shared_ptr<char> buffer, std::size_t size)
+{
+    program p;
+    data_section_header header;
+    if(read_header(buffer.get(), size, header))
+    {
+        data_section section{std::shared_ptr<char>{buffer, buffer.get() + header.data_offset},
+                             header.data_size};
+        p.from_value(from_msgpack(buffer.get() + header.value_offset, header.value_size),
+                     section);
+    }
+    else
+    {
+        p.from_value(from_msgpack(buffer.get(), size));
+    }
+    return p;
+}
+
 program load(const std::string& filename, const file_options& options)
 {
+    if(options.format == "msgpack")
+    {
+        mapped_file f{filename};
+        return load_msgpack(f.share(0, f.size()), f.size());
+    }
     return load_buffer(read_buffer(filename), options);
 }
 program load_buffer(const std::vector<char>& buffer, const file_options& options)
@@ -44,7 +106,20 @@ program load_buffer(const char* buffer, std::size_t size, const file_options& op
     program p;
     if(options.format == "msgpack")
     {
-        p.from_value(from_msgpack(buffer, size));
+        data_section_header header;
+        if(read_header(buffer, size, header))
+        {
+            // The caller owns the buffer so the data section is copied once for the literals to
+            // share
+            auto data = make_shared_array<char>(buffer + header.data_offset,
+                                                buffer + header.data_offset + header.data_size);
+            data_section section{data, header.data_size};
+            p.from_value(from_msgpack(buffer + header.value_offset, header.value_size), section);
+        }
+        else
+        {
+            p.from_value(from_msgpack(buffer, size));
+        }
     }
     else if(options.format == "json")
     {
@@ -63,15 +138,28 @@ void save(const program& p, const std::string& filename, const file_options& opt
 }
 std::vector<char> save_buffer(const program& p, const file_options& options)
 {
-    value v = p.to_value();
     std::vector<char> buffer;
     if(options.format == "msgpack")
     {
-        buffer = to_msgpack(v);
+        data_section section;
+        auto v = to_msgpack(p.to_value(section));
+
+        data_section_header header;
+        header.value_offset = sizeof(data_section_header);
+        header.value_size   = v.size();
+        header.data_offset  = align_to(header.value_offset + header.value_size);
+        header.data_size = section.contents().size();
+
+        buffer.resize(header.data_offset + header.data_size);
+        std::memcpy(buffer.data(), &header, sizeof(data_section_header));
+        std::copy(v.begin(), v.end(), buffer.begin() + header.value_offset);
+        std::copy(section.contents().begin(),
+                  section.contents().end(),
+                  buffer.begin() + header.data_offset);
     }
     else if(options.format == "json")
     {
-        std::string s = to_json_string(v);
+        std::string s = to_json_string(p.to_value());
         buffer        = std::vector<char>(s.begin(), s.end());
     }
     else
@@ -0,0 +1,75 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/mapped_file.hpp>
+#include <migraphx/errors.hpp>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+mapped_file::mapped_file(const std::string& filename)
+{
+    int fd = open(filename.c_str(), O_RDONLY); // NOLINT
+    if(fd < 0)
+        MIGRAPHX_THROW("Error opening file: " + filename + ": " + std::strerror(errno));
+    struct stat st = {};
+    if(fstat(fd, &st) != 0 or st.st_size < 1)
+    {
+        close(fd);
+        MIGRAPHX_THROW("Invalid size for: " + filename);
+    }
+    std::size_t size = st.st_size;
+    // Private mapping: the literals built on top of it are allowed to write to their buffer
+    // without touching the file, while untouched pages stay shared with the page cache
+    void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    // The mapping holds its own reference to the file
+    close(fd);
+    if(addr == MAP_FAILED) // NOLINT
+        MIGRAPHX_THROW("Error mapping file: " + filename + ": " + std::strerror(errno));
+    buffer = std::shared_ptr<char>(static_cast<char*>(addr), [=](char* p) { munmap(p, size); });
+    nbytes = size;
+}
+
+bool mapped_file::empty() const { return buffer == nullptr; }
+
+const char* mapped_file::data() const { return buffer.get(); }
+
+std::size_t mapped_file::size() const { return nbytes; }
+
+std::shared_ptr<char> mapped_file::share(std::size_t offset, std::size_t n) const
+{
+    if(offset > nbytes or n > nbytes - offset)
+        MIGRAPHX_THROW("Out of bounds access to mapped file: offset " + std::to_string(offset) +
+                       " with " + std::to_string(n) + " bytes, but file has " +
+                       std::to_string(nbytes) + " bytes");
+    return {buffer, buffer.get() + offset};
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
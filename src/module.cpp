@@ -36,6 +36,7 @@
 #include <migraphx/register_target.hpp>
 #include <migraphx/make_op.hpp>
 #include <migraphx/json.hpp>
+#include <atomic>
 #include <iostream>
 #include <sstream>
 #include <algorithm>
@@ -48,14 +49,23 @@ inline namespace MIGRAPHX_INLINE_NS {
 
 MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TRACE_FINALIZE)
 
+static std::size_t next_module_version()
+{
+    static std::atomic<std::size_t> version{0};
+    return ++version;
+}
+
 struct module_impl
 {
     // A list is used to keep references to an instruction stable
     std::list<instruction> instructions;
     std::unordered_set<instruction*> instruction_set;
     std::string name;
-    uint32_t nparams = 0;
-    bool bypass      = false;
+    uint32_t nparams    = 0;
+    bool bypass         = false;
+    std::size_t version = next_module_version();
+
+    void changed() { version = next_module_version(); }
 
     bool contains(instruction_ref ins) const
     {
@@ -70,6 +80,7 @@ struct module_impl
         // cppcheck-suppress redundantInitialization
         auto r = instructions.emplace(pos, std::forward<Ts>(xs)...);
         instruction_set.insert(std::addressof(*r));
+        changed();
         return r;
     }
     instruction_ref insert(instruction_ref pos, const instruction& ins)
@@ -82,6 +93,7 @@ struct module_impl
         instructions.clear();
         instruction_set.clear();
         nparams = 0;
+        changed();
     }
 
     void push_front(const instruction& ins) { insert(instructions.begin(), ins); }
@@ -103,12 +115,14 @@ struct module_impl
     instruction_ref erase(instruction_ref pos)
     {
         instruction_set.erase(std::addressof(*pos));
+        changed();
         return instructions.erase(pos);
     }
 
     instruction_ref erase(instruction_ref start, instruction_ref last)
     {
         std::for_each(start, last, [&](auto& ins) { instruction_set.erase(std::addressof(ins)); });
+        changed();
         return instructions.erase(start, last);
     }
 };
@@ -138,6 +152,8 @@ std::string module::name() const { return impl->name; }
 bool module::bypass() const { return impl->bypass; }
 void module::set_bypass(bool b) { impl->bypass = b; }
 
+std::size_t module::version() const { return impl->version; }
+
 void module::assign(const module& m)
 {
     // copy the impl
@@ -301,6 +317,7 @@ instruction_ref module::replace_instruction(instruction_ref ins,
 
     shape r = compute_shape(op, args);
     instruction::replace(ins, op, r, std::move(args));
+    impl->changed();
     assert(ins->valid(begin()));
     return ins;
 }
@@ -314,6 +331,7 @@ instruction_ref module::replace_instruction(instruction_ref ins,
     assert(not starts_with(op.name(), "@"));
     auto out_shape = compute_shape(op, args, module_args);
     instruction::replace(ins, op, out_shape, std::move(args), std::move(module_args));
+    impl->changed();
     assert(ins->valid(begin()));
     return ins;
 }
@@ -334,6 +352,7 @@ instruction_ref module::replace_instruction(instruction_ref ins, instruction_ref
     {
         return rep;
     }
+    impl->changed();
     // Make a copy of outputs which can be changed when calling replace_argument
     auto outputs = ins->outputs();
     for(auto out : outputs)
@@ -356,6 +375,13 @@ instruction_ref module::replace_instruction(instruction_ref ins, instruction_ref
     return rep;
 }
 
+void module::replace_argument(instruction_ref ins, instruction_ref old, instruction_ref new_ins)
+{
+    assert(has_instruction(ins));
+    instruction::replace_argument(ins, old, new_ins);
+    impl->changed();
+}
+
 instruction_ref module::remove_instruction(instruction_ref ins)
 {
     assert(has_instruction(ins));
@@ -380,6 +406,7 @@ instruction_ref module::move_instruction(instruction_ref src, instruction_ref ds
     assert(has_instruction(src));
     assert(has_instruction(dst) or is_end(dst, this->end()));
     impl->instructions.splice(dst, impl->instructions, src);
+    impl->changed();
     return src;
 }
 
@@ -478,6 +505,7 @@ instruction_ref module::replace_return(std::vector<instruction_ref> args)
 
     shape r = compute_shape(last->get_operator(), args);
     instruction::replace(last, last->get_operator(), r, std::move(args));
+    impl->changed();
     assert(last->valid(begin()));
 
     return last;
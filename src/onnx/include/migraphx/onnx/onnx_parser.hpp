@@ -26,6 +26,7 @@
 
 #include <migraphx/config.hpp>
 #include <migraphx/program.hpp>
+#include <migraphx/mapped_file.hpp>
 #include <google/protobuf/text_format.h>
 #include <google/protobuf/io/zero_copy_stream_impl.h>
 #include <onnx.pb.h>
@@ -101,6 +102,8 @@ struct onnx_parser
     int64_t opset_version       = 13;
 
     std::unordered_map<std::string, op_func> ops;
+    // External data files are mapped once and shared by all tensors stored in them
+    mutable std::unordered_map<std::string, mapped_file> external_data_files;
 
     onnx_parser();
     operation load(const std::string& name, const node_info& info) const;
@@ -114,6 +117,8 @@ struct onnx_parser
     void parse_graph(module* mod, const onnx::GraphProto& graph);
     literal parse_value(const onnx::AttributeProto& attr) const;
     literal parse_tensor(const onnx::TensorProto& t) const;
+    literal parse_external_data(const onnx::TensorProto& t,
+                                const std::vector<std::size_t>& dims) const;
     shape parse_type(const onnx::TypeProto& t, const std::vector<std::size_t>& input_dims) const;
 };
 
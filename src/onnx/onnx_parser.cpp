@@ -32,7 +32,6 @@
 #include <migraphx/common.hpp>
 #include <migraphx/type_traits.hpp>
 #include <migraphx/float_equal.hpp>
-#include <migraphx/file_buffer.hpp>
 #include <migraphx/filesystem.hpp>
 #include <migraphx/op/unknown.hpp>
 
@@ -384,13 +383,7 @@ literal onnx_parser::parse_tensor(const onnx::TensorProto& t) const
 {
     std::vector<std::size_t> dims(t.dims().begin(), t.dims().end());
     if(not t.external_data().empty())
-    {
-        const std::string& data_file = t.external_data().at(0).value();
-        auto raw_buffer              = read_buffer(path + "/" + data_file);
-        std::string s(raw_buffer.begin(), raw_buffer.end());
-        auto type = get_type(t.data_type());
-        return create_literal(type, dims, s.data());
-    }
+        return parse_external_data(t, dims);
     if(t.has_raw_data())
     {
         const std::string& s = t.raw_data();
@@ -430,6 +423,45 @@ literal onnx_parser::parse_tensor(const onnx::TensorProto& t) const
     }
     MIGRAPHX_THROW("PARSE_TENSOR: Invalid tensor type");
 }
+literal onnx_parser::parse_external_data(const onnx::TensorProto& t,
+                                         const std::vector<std::size_t>& dims) const
+{
+    std::string location;
+    std::size_t offset = 0;
+    std::size_t length = 0;
+    for(auto&& entry : t.external_data())
+    {
+        if(entry.key() == "location")
+            location = entry.value();
+        else if(entry.key() == "offset")
+            offset = std::stoull(entry.value());
+        else if(entry.key() == "length")
+            length = std::stoull(entry.value());
+    }
+    if(location.empty())
+        MIGRAPHX_THROW("PARSE_TENSOR: No location for external data of " + t.name());
+
+    auto type = get_type(t.data_type());
+    shape s   = dims.empty() ? shape{type} : shape{type, dims};
+    if(s.elements() == 0)
+        return {};
+    if(length != 0 and length < s.bytes())
+        MIGRAPHX_THROW("PARSE_TENSOR: External data of " + t.name() + " has " +
+                       std::to_string(length) + " bytes, but " + std::to_string(s.bytes()) +
+                       " bytes are needed");
+
+    auto filename = path + "/" + location;
+    auto it       = external_data_files.find(filename);
+    if(it == external_data_files.end())
+        it = external_data_files.emplace(filename, mapped_file{filename}).first;
+    auto data = it->second.share(offset, s.bytes());
+    // The mapping is page aligned so an unaligned offset means an unaligned tensor, which
+    // cannot be used in place
+    if(offset % s.type_size() != 0)
+        return literal{s, data.get()};
+    return literal{s, data};
+}
+
 shape onnx_parser::parse_type(const onnx::TypeProto& t,
                               const std::vector<std::size_t>& input_dims) const
 {
@@ -22,18 +22,69 @@
  * THE SOFTWARE.
  */
 #include <migraphx/memory_coloring.hpp>
+#include <migraphx/time.hpp>
 #include "memory_coloring_impl.hpp"
+#include "memory_planner.hpp"
+#include <iomanip>
+#include <iostream>
+#include <sstream>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_MEMORY_PLANNER)
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TRACE_MEMORY_COLORING)
+
 void memory_coloring::apply(module& m) const
 {
-    if(!enabled(MIGRAPHX_DISABLE_MEMORY_COLORING{}))
+    if(enabled(MIGRAPHX_DISABLE_MEMORY_COLORING{}))
+        return;
+    auto name  = planner.empty() ? string_value_of(MIGRAPHX_MEMORY_PLANNER{}, "best_fit") : planner;
+    bool reuse = reuse_pointwise and name == "best_fit";
+    bool trace = report or enabled(MIGRAPHX_TRACE_MEMORY_COLORING{});
+
+    std::size_t nallocs = 0;
+    std::size_t peak    = 0;
+    if(trace)
+    {
+        memory_planner mp{&m, allocation_op, reuse};
+        mp.build();
+        nallocs = mp.allocations();
+        peak    = mp.peak_live_bytes();
+    }
+
+    timer t{};
+    if(name == "coloring")
     {
         memory_coloring_impl opt(&m, allocation_op, verify);
         opt.run();
     }
+    else if(name == "best_fit")
+    {
+        memory_planner mp{&m, allocation_op, reuse};
+        mp.build();
+        auto required = mp.plan();
+        if(verify)
+            mp.verify();
+        mp.rewrite(required);
+    }
+    else
+    {
+        MIGRAPHX_THROW("Unknown memory planner: " + name);
+    }
+    auto ms = t.record<std::chrono::duration<double, std::milli>>();
+
+    if(trace)
+    {
+        auto scratch  = m.get_parameter_shape("scratch").bytes();
+        auto overhead = peak == 0 ? 0.0 : 100.0 * (double(scratch) - double(peak)) / peak;
+        std::stringstream ss;
+        ss << "Memory planner " << name << " for " << m.name() << ": " << nallocs
+           << " allocations, peak live " << peak << " bytes, scratch " << scratch << " bytes ("
+           << std::fixed << std::setprecision(1) << std::showpos << overhead << std::noshowpos
+           << "%), " << std::setprecision(3) << ms << "ms";
+        std::cout << ss.str() << std::endl;
+    }
 }
 
 } // namespace MIGRAPHX_INLINE_NS
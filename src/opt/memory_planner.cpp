@@ -0,0 +1,252 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "memory_planner.hpp"
+#include <migraphx/functional.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/serialize.hpp>
+#include <algorithm>
+#include <map>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+static std::size_t align_to(std::size_t n, std::size_t alignment)
+{
+    return (n + alignment - 1) / alignment * alignment;
+}
+
+void memory_planner::build()
+{
+    std::unordered_map<instruction_ref, std::size_t> points;
+    std::size_t point = 0;
+    for(auto ins : iterator_for(*mod))
+    {
+        points[ins] = point++;
+        if(not is_allocate(ins))
+            continue;
+        const auto& s = ins->get_shape();
+        memory_buffer b;
+        b.begin = b.end = points[ins];
+        b.size          = s.bytes();
+        // Align to the element size, but at least to 4 bytes since miopen int8 convolution can
+        // crash otherwise
+        if(s.elements() > 0)
+            b.alignment = std::max<std::size_t>(b.alignment, s.bytes() / s.elements());
+        buffer_index[ins] = buffers.size();
+        buffers.push_back(b);
+    }
+
+    auto implicit_deps = mod->calc_implicit_deps();
+    for(auto ins : iterator_for(*mod))
+    {
+        auto inputs = ins->inputs();
+        if(contains(implicit_deps, ins))
+        {
+            const auto& deps = implicit_deps.at(ins);
+            inputs.insert(inputs.end(), deps.begin(), deps.end());
+        }
+        for(auto arg : inputs)
+        {
+            if(not mod->has_instruction(arg))
+                continue;
+            auto it = buffer_index.find(instruction::get_output_alias(arg));
+            if(it == buffer_index.end())
+                continue;
+            auto& b = buffers[it->second];
+            b.end   = std::max(b.end, points[ins]);
+        }
+    }
+    if(reuse)
+        reuse_pointwise(points);
+}
+
+// A pointwise operator can write its output over an input that isn't used afterwards, as long
+// as the input has the same layout as the output and no other input reads the same buffer.
+void memory_planner::reuse_pointwise(const std::unordered_map<instruction_ref, std::size_t>& points)
+{
+    for(auto ins : iterator_for(*mod))
+    {
+        if(ins->inputs().empty() or not ins->get_operator().attributes().get("pointwise", false))
+            continue;
+        auto alloc = ins->inputs().back();
+        if(not is_allocate(alloc) or alloc->outputs().size() != 1)
+            continue;
+        auto inputs = ins->inputs();
+        inputs.pop_back();
+        for(auto x : inputs)
+        {
+            auto root = instruction::get_output_alias(x);
+            if(not contains(buffer_index, root))
+                continue;
+            if(x->get_shape() != ins->get_shape() or not x->get_shape().standard() or
+               root->get_shape().bytes() != x->get_shape().bytes())
+                continue;
+            if(std::any_of(inputs.begin(), inputs.end(), [&](auto y) {
+                   return y != x and instruction::get_output_alias(y) == root;
+               }))
+                continue;
+            auto& in  = buffers[buffer_index.at(root)];
+            auto& out = buffers[buffer_index.at(alloc)];
+            if(in.end != points.at(ins) or in.size < out.size)
+                continue;
+            in.end                 = out.end;
+            in.alignment           = std::max(in.alignment, out.alignment);
+            out.size               = 0;
+            buffer_index.at(alloc) = buffer_index.at(root);
+            break;
+        }
+    }
+}
+
+std::size_t memory_planner::plan()
+{
+    std::vector<std::size_t> order;
+    for(std::size_t i = 0; i < buffers.size(); i++)
+    {
+        if(buffers[i].size > 0)
+            order.push_back(i);
+    }
+    std::sort(order.begin(), order.end(), [&](auto i, auto j) {
+        const auto& x = buffers[i];
+        const auto& y = buffers[j];
+        if(x.size != y.size)
+            return x.size > y.size;
+        if(x.end - x.begin != y.end - y.begin)
+            return x.end - x.begin > y.end - y.begin;
+        return x.begin < y.begin;
+    });
+
+    // The placed buffers that overlap a buffer are the ones live at its first point, which are
+    // found in a segment tree over the points, and the ones that begin later within its range
+    std::size_t npoints = 0;
+    for(auto i : order)
+        npoints = std::max(npoints, buffers[i].end + 1);
+    std::vector<std::vector<const memory_buffer*>> spans(2 * npoints);
+    std::multimap<std::size_t, const memory_buffer*> starts;
+    auto insert = [&](const memory_buffer* p) {
+        for(auto l = p->begin + npoints, r = p->end + npoints + 1; l < r; l /= 2, r /= 2)
+        {
+            if(l % 2 == 1)
+                spans[l++].push_back(p);
+            if(r % 2 == 1)
+                spans[--r].push_back(p);
+        }
+        starts.emplace(p->begin, p);
+    };
+
+    std::size_t required = 0;
+    std::vector<const memory_buffer*> live;
+    for(auto i : order)
+    {
+        auto& b = buffers[i];
+        live.clear();
+        for(auto node = b.begin + npoints; node > 0; node /= 2)
+            live.insert(live.end(), spans[node].begin(), spans[node].end());
+        std::transform(starts.upper_bound(b.begin),
+                       starts.upper_bound(b.end),
+                       std::back_inserter(live),
+                       [](const auto& p) { return p.second; });
+        std::sort(live.begin(), live.end(), by(std::less<>{}, [](auto p) { return p->offset; }));
+        std::size_t best     = memory_buffer::invalid;
+        std::size_t best_gap = memory_buffer::invalid;
+        std::size_t last     = 0;
+        for(const auto* p : live)
+        {
+            auto start = align_to(last, b.alignment);
+            if(p->offset >= start + b.size and p->offset - start < best_gap)
+            {
+                best     = start;
+                best_gap = p->offset - start;
+            }
+            last = std::max(last, p->offset + p->size);
+        }
+        if(best == memory_buffer::invalid)
+            best = align_to(last, b.alignment);
+        b.offset = best;
+        required = std::max(required, b.offset + b.size);
+        insert(&b);
+    }
+    return required;
+}
+
+void memory_planner::rewrite(std::size_t required_bytes)
+{
+    if(buffer_index.empty())
+        return;
+    shape s{shape::float_type, {(required_bytes + sizeof(float) - 1) / sizeof(float)}};
+    auto scratch = mod->add_parameter("scratch", s);
+    for(auto&& p : buffer_index)
+    {
+        const auto& b = buffers[p.second];
+        auto offset   = b.offset == memory_buffer::invalid ? 0 : b.offset;
+        mod->replace_instruction(
+            p.first,
+            make_op("load", {{"shape", to_value(p.first->get_shape())}, {"offset", offset}}),
+            scratch);
+    }
+}
+
+void memory_planner::verify() const
+{
+    for(std::size_t i = 0; i < buffers.size(); i++)
+    {
+        const auto& x = buffers[i];
+        if(x.size == 0)
+            continue;
+        for(std::size_t j = i + 1; j < buffers.size(); j++)
+        {
+            const auto& y = buffers[j];
+            if(y.size == 0 or not x.overlaps(y))
+                continue;
+            if(x.offset < y.offset + y.size and y.offset < x.offset + x.size)
+                MIGRAPHX_THROW("Allocations live at the same time overlap in memory");
+        }
+    }
+}
+
+std::size_t memory_planner::peak_live_bytes() const
+{
+    std::vector<std::pair<std::size_t, std::ptrdiff_t>> events;
+    for(const auto& b : buffers)
+    {
+        if(b.size == 0)
+            continue;
+        events.emplace_back(b.begin, b.size);
+        events.emplace_back(b.end + 1, -static_cast<std::ptrdiff_t>(b.size));
+    }
+    std::sort(events.begin(), events.end());
+    std::ptrdiff_t live = 0;
+    std::ptrdiff_t peak = 0;
+    for(const auto& e : events)
+    {
+        live += e.second;
+        peak = std::max(peak, live);
+    }
+    return peak;
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -0,0 +1,94 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_RTGLIB_MEMORY_PLANNER_HPP
+#define MIGRAPHX_GUARD_RTGLIB_MEMORY_PLANNER_HPP
+
+#include <migraphx/instruction.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/config.hpp>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+// A buffer that has to be placed in the scratch memory, which can be shared by several
+// allocations when they are reused in place
+struct memory_buffer
+{
+    static const std::size_t invalid = std::numeric_limits<std::size_t>::max();
+
+    std::size_t begin     = 0; // first instruction the buffer is live at
+    std::size_t end       = 0; // last instruction the buffer is live at
+    std::size_t size      = 0;
+    std::size_t alignment = 4;
+    std::size_t offset    = invalid;
+
+    bool overlaps(const memory_buffer& x) const { return begin <= x.end and x.begin <= end; }
+};
+
+/**
+ * Computes the live range of every allocation of a module, and places them in the scratch
+ * memory by best fit. The buffers are placed from the largest to the smallest, each one in the
+ * smallest gap left between the buffers already placed that are live at the same time.
+ */
+struct memory_planner
+{
+    memory_planner(module* m, std::string alloc_op, bool reuse_pointwise = false)
+        : mod(m), allocation_op(std::move(alloc_op)), reuse(reuse_pointwise)
+    {
+    }
+
+    /// Compute the buffers and their live ranges
+    void build();
+    /// Place the buffers and return the size of the scratch memory
+    std::size_t plan();
+    /// Replace the allocations with loads from the scratch parameter
+    void rewrite(std::size_t required_bytes);
+    /// Check that the buffers live at the same time don't overlap
+    void verify() const;
+
+    /// The largest number of bytes allocated at the same time
+    std::size_t peak_live_bytes() const;
+
+    std::size_t allocations() const { return buffer_index.size(); }
+
+    private:
+    bool is_allocate(instruction_ref ins) const { return ins->name() == allocation_op; }
+    void reuse_pointwise(const std::unordered_map<instruction_ref, std::size_t>& points);
+
+    module* mod;
+    std::string allocation_op;
+    bool reuse;
+    std::vector<memory_buffer> buffers;
+    // The buffer each allocation is placed in
+    std::unordered_map<instruction_ref, std::size_t> buffer_index;
+};
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
@@ -23,6 +23,8 @@
  */
 #include <migraphx/program.hpp>
 #include <migraphx/pass_manager.hpp>
+#include <migraphx/pass_profile.hpp>
+#include <migraphx/algorithm.hpp>
 #include <migraphx/stringutils.hpp>
 #include <migraphx/instruction.hpp>
 #include <migraphx/target.hpp>
@@ -33,12 +35,18 @@
 #include <iostream>
 #include <sstream>
 #include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
 MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TRACE_PASSES);
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_DISABLE_PASS_SKIPPING);
+
+// The module versions seen by the last run of each idempotent pass
+using pass_history = std::unordered_map<std::string, std::unordered_map<module_ref, std::size_t>>;
 
 void validate_pass(module& mod, const pass& p, tracer trace)
 {
@@ -57,10 +65,51 @@ void validate_pass(module& mod, const pass& p, tracer trace)
     trace();
 #endif
 }
-void run_pass(program& prog, const pass& p, tracer trace)
+// Points the match counters at a profile record for the lifetime of the object
+struct profiled_matches_scope
+{
+    std::unordered_map<std::string, std::size_t>* prev;
+    profiled_matches_scope(pass_profile::record& r)
+        : prev(std::exchange(match::profiled_matches(), &r.matches))
+    {
+    }
+    profiled_matches_scope(const profiled_matches_scope&) = delete;
+    profiled_matches_scope& operator=(const profiled_matches_scope&) = delete;
+    ~profiled_matches_scope() { match::profiled_matches() = prev; }
+};
+
+template <class F>
+static void profile_pass(pass_profile::record& r, F f)
+{
+    profiled_matches_scope scope{r};
+    r.ms = time<std::chrono::duration<double, std::milli>>(f);
+}
+
+static std::size_t count_instructions(const program& prog)
+{
+    auto mods = prog.get_modules();
+    return transform_accumulate(
+        mods.begin(), mods.end(), std::size_t{0}, std::plus<>{}, [](const auto* m) {
+            return m->size();
+        });
+}
+
+void run_pass(program& prog, const pass& p, tracer trace, pass_profile* profile)
 {
     trace("Pass: ", p.name());
-    p.apply(prog);
+    if(profile == nullptr)
+    {
+        p.apply(prog);
+    }
+    else
+    {
+        pass_profile::record r;
+        r.pass                = p.name();
+        r.instructions_before = count_instructions(prog);
+        profile_pass(r, [&] { p.apply(prog); });
+        r.instructions_after = count_instructions(prog);
+        profile->records.push_back(std::move(r));
+    }
     trace(prog);
 }
 
@@ -70,6 +119,11 @@ struct module_pm : module_pass_manager
     tracer* t             = nullptr;
     module* common_parent = nullptr;
     program* prog         = nullptr;
+    pass_history* history = nullptr;
+    pass_profile* profile = nullptr;
+    // Modules whose changes can affect this module, which are its ancestors
+    // and its submodules
+    std::vector<module_ref> related;
 
     module_pm(module* pmod = nullptr, tracer* pt = nullptr) : mod(pmod), t(pt) {}
 
@@ -91,33 +145,128 @@ struct module_pm : module_pass_manager
         return prog->create_module(name);
     }
     virtual module* get_common_parent() override { return common_parent; }
+
+    std::size_t version() const
+    {
+        std::size_t result = mod->version();
+        for(const auto* m : related)
+            result = std::max(result, m->version());
+        return result;
+    }
+
+    bool skip(const pass& p) const
+    {
+        if(history == nullptr or not p.idempotent())
+            return false;
+        auto it = history->find(p.name());
+        if(it == history->end())
+            return false;
+        auto last = it->second.find(mod);
+        return last != it->second.end() and last->second == version();
+    }
+
     virtual void run_pass(const pass& p) override
     {
         assert(mod);
+        pass_profile::record r;
+        r.pass                = p.name();
+        r.module              = mod->name();
+        r.instructions_before = mod->size();
+        if(skip(p))
+        {
+            trace("Module: ", mod->name(), ", Pass: ", p.name(), " (skipped)");
+            if(profile != nullptr)
+            {
+                r.skipped            = true;
+                r.instructions_after = r.instructions_before;
+                profile->records.push_back(std::move(r));
+            }
+            return;
+        }
         trace("Module: ", mod->name(), ", Pass: ", p.name());
         assert(mod->validate() == mod->end());
-        p.apply(*this);
+        if(profile == nullptr)
+        {
+            p.apply(*this);
+        }
+        else
+        {
+            profile_pass(r, [&] { p.apply(*this); });
+            r.instructions_after = mod->size();
+            profile->records.push_back(std::move(r));
+        }
         trace(*mod);
         validate_pass(*mod, p, *t);
+        if(history != nullptr and p.idempotent())
+            (*history)[p.name()][mod] = version();
     }
 };
 
+// Collect the ancestors and the submodules of a module from the tree of parents
+static std::vector<module_ref>
+related_modules(const std::unordered_multimap<module_ref, module_ref>& tree, module_ref mod)
+{
+    std::vector<module_ref> result;
+    std::vector<module_ref> stack = {mod};
+    while(not stack.empty())
+    {
+        auto m = stack.back();
+        stack.pop_back();
+        for(const auto& pp : range(tree.equal_range(m)))
+        {
+            if(contains(result, pp.second))
+                continue;
+            result.push_back(pp.second);
+            stack.push_back(pp.second);
+        }
+    }
+    stack = {mod};
+    while(not stack.empty())
+    {
+        auto m = stack.back();
+        stack.pop_back();
+        for(const auto& pp : tree)
+        {
+            if(pp.second != m or contains(result, pp.first))
+                continue;
+            result.push_back(pp.first);
+            stack.push_back(pp.first);
+        }
+    }
+    return result;
+}
+
 module& get_module(module_pass_manager& mpm) { return mpm.get_module(); }
 
-void run_passes(module& mod, const std::vector<pass>& passes, tracer trace)
+void run_passes(module& mod,
+                const std::vector<pass>& passes,
+                tracer trace,
+                pass_profile* profile)
 {
     if(enabled(MIGRAPHX_TRACE_PASSES{}))
         trace = tracer{std::cout};
+    pass_history history;
     for(const auto& p : passes)
     {
-        module_pm{&mod, &trace}.run_pass(p);
+        module_pm mpm{&mod, &trace};
+        mpm.profile = profile;
+        if(p.idempotent() and not enabled(MIGRAPHX_DISABLE_PASS_SKIPPING{}))
+        {
+            mpm.history = &history;
+            mpm.related = mod.get_sub_modules();
+        }
+        mpm.run_pass(p);
     }
 }
 
-void run_passes(program& prog, const std::vector<pass>& passes, tracer trace)
+void run_passes(program& prog,
+                const std::vector<pass>& passes,
+                tracer trace,
+                pass_profile* profile)
 {
     if(enabled(MIGRAPHX_TRACE_PASSES{}))
         trace = tracer{std::cout};
+    pass_history history;
     std::unordered_set<module_ref> visited;
     for(const auto& p : passes)
     {
@@ -132,6 +281,7 @@ void run_passes(program& prog, const std::vector<pass>& passes, tracer trace)
                 continue;
             module_pm mpm{mod, &trace};
             mpm.prog      = &prog;
+            mpm.profile   = profile;
             auto parents  = range(tree.equal_range(mod));
             auto nparents = distance(parents);
             if(nparents == 0)
@@ -142,9 +292,14 @@ void run_passes(program& prog, const std::vector<pass>& passes, tracer trace)
                 // Just set common parent to main module when there is muliple parents for now
                 // TODO: Compute the common parent
                 mpm.common_parent = prog.get_main_module();
+            if(p.idempotent() and not enabled(MIGRAPHX_DISABLE_PASS_SKIPPING{}))
+            {
+                mpm.history = &history;
+                mpm.related = related_modules(tree, mod);
+            }
             mpm.run_pass(p);
         }
-        run_pass(prog, p, trace);
+        run_pass(prog, p, trace, profile);
     }
 }
 
@@ -0,0 +1,123 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/pass_profile.hpp>
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+double pass_profile::total_ms() const
+{
+    return std::accumulate(
+        records.begin(), records.end(), 0.0, [](double x, const record& r) { return x + r.ms; });
+}
+
+value pass_profile::to_value() const
+{
+    value result = value::array{};
+    for(const auto& r : records)
+    {
+        value matches = value::object{};
+        for(const auto& p : r.matches)
+            matches[p.first] = p.second;
+        result.push_back({{"pass", r.pass},
+                          {"module", r.module},
+                          {"ms", r.ms},
+                          {"instructions_before", r.instructions_before},
+                          {"instructions_after", r.instructions_after},
+                          {"skipped", r.skipped},
+                          {"matches", matches}});
+    }
+    return result;
+}
+
+void pass_profile::print_summary(std::ostream& os) const
+{
+    struct summary
+    {
+        std::string pass;
+        double ms            = 0;
+        std::size_t runs     = 0;
+        std::size_t skips    = 0;
+        std::ptrdiff_t delta = 0;
+        std::size_t matches  = 0;
+    };
+    std::vector<summary> passes;
+    std::unordered_map<std::string, std::size_t> index;
+    for(const auto& r : records)
+    {
+        auto it = index.find(r.pass);
+        if(it == index.end())
+        {
+            it = index.emplace(r.pass, passes.size()).first;
+            passes.push_back({r.pass});
+        }
+        auto& s = passes[it->second];
+        s.ms += r.ms;
+        if(r.skipped)
+            s.skips++;
+        else
+            s.runs++;
+        s.delta += std::ptrdiff_t(r.instructions_after) - std::ptrdiff_t(r.instructions_before);
+        for(const auto& p : r.matches)
+            s.matches += p.second;
+    }
+    std::stable_sort(passes.begin(), passes.end(), [](const summary& x, const summary& y) {
+        return x.ms > y.ms;
+    });
+    auto total = total_ms();
+
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(3);
+    ss << std::left << std::setw(40) << "Pass" << std::right << std::setw(12) << "Time(ms)"
+       << std::setw(8) << "%" << std::setw(8) << "Runs" << std::setw(8) << "Skips"
+       << std::setw(12) << "Delta" << std::setw(10) << "Matches" << std::endl;
+    for(const auto& s : passes)
+    {
+        double percent = total > 0 ? 100.0 * s.ms / total : 0.0;
+        ss << std::left << std::setw(40) << s.pass << std::right << std::setw(12) << s.ms
+           << std::setw(8) << std::setprecision(1) << percent << std::setprecision(3)
+           << std::setw(8) << s.runs << std::setw(8) << s.skips << std::setw(12) << s.delta
+           << std::setw(10) << s.matches << std::endl;
+    }
+    ss << "Total: " << total << "ms" << std::endl;
+    os << ss.str();
+}
+
+namespace match {
+
+std::unordered_map<std::string, std::size_t>*& profiled_matches()
+{
+    thread_local std::unordered_map<std::string, std::size_t>* result = nullptr;
+    return result;
+}
+
+} // namespace match
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
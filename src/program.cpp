@@ -30,6 +30,8 @@
 #include <migraphx/ranges.hpp>
 #include <migraphx/time.hpp>
 #include <migraphx/pass_manager.hpp>
+#include <migraphx/pass_profile.hpp>
+#include <migraphx/compile_cache.hpp>
 #include <migraphx/register_target.hpp>
 #include <migraphx/iterator_for.hpp>
 #include <migraphx/iterator.hpp>
@@ -45,19 +47,36 @@
 
 #include <unordered_set>
 #include <map>
+#include <mutex>
 #include <cassert>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_PROFILE_PASSES)
+
 using milliseconds = std::chrono::duration<double, std::milli>;
 
+struct eval_plan;
+
 struct program_impl
 {
     // A map is used to keep references to modules of the program
     std::unordered_map<std::string, module> modules;
     context ctx;
     std::string target_name;
+    // The evaluation plan is cached for compiled programs, and is reset whenever the modules are
+    // accessed for modification
+    std::shared_ptr<const eval_plan> plan = nullptr;
+    std::mutex plan_mutex;
+
+    std::shared_ptr<const eval_plan> get_eval_plan(const module* mm);
+    void update_eval_plan(const module* mm);
+    void reset_eval_plan()
+    {
+        std::lock_guard<std::mutex> lock(plan_mutex);
+        plan = nullptr;
+    }
 };
 
 program::program() : impl(std::make_unique<program_impl>()) { this->create_module("main"); }
@@ -86,6 +105,7 @@ void program::assign(const program& p)
         impl->modules.clear();
     }
 
+    impl->reset_eval_plan();
     impl->ctx         = p.impl->ctx;
     impl->target_name = p.impl->target_name;
     impl->modules     = p.impl->modules;
@@ -161,6 +181,16 @@ instruction_ref program::validate() const
 
 bool program::is_compiled() const { return not this->impl->target_name.empty(); }
 
+context program::create_context() const
+{
+    if(not this->is_compiled())
+        MIGRAPHX_THROW("Program must be compiled to create a context");
+    target t    = make_target(this->impl->target_name);
+    context ctx = t.get_context();
+    ctx.from_value(this->impl->ctx.to_value());
+    return ctx;
+}
+
 void program::compile(const target& t, compile_options options)
 {
     assert(not this->is_compiled());
@@ -172,8 +202,30 @@ void program::compile(const target& t, compile_options options)
     options.trace(*this);
     options.trace();
 
+    pass_profile profile;
+    if(options.profile == nullptr and enabled(MIGRAPHX_PROFILE_PASSES{}))
+        options.profile = &profile;
+
     auto&& passes = t.get_passes(this->impl->ctx, options);
-    run_passes(*this, passes, options.trace);
+
+    // Profiling needs the passes to run, so it skips the cache
+    compile_cache cache{options};
+    std::string cache_key;
+    if(cache.enabled() and options.profile == nullptr)
+    {
+        cache_key   = cache.key(*this, t, passes, options);
+        auto cached = cache.load(cache_key);
+        if(has_value(cached))
+        {
+            *this = std::move(*cached);
+            return;
+        }
+    }
+
+    run_passes(*this, passes, options.trace, options.profile);
+
+    if(options.profile == &profile)
+        profile.print_summary(std::cout);
 
     auto mods = this->get_modules();
 
@@ -195,12 +247,17 @@ void program::compile(const target& t, compile_options options)
         }
         mod->finalize(this->impl->ctx);
     }
+    this->impl->update_eval_plan(this->get_main_module());
+
+    if(not cache_key.empty())
+        cache.store(cache_key, *this);
 }
 
 void program::finalize()
 {
     auto* mm = this->get_main_module();
     mm->finalize(this->impl->ctx);
+    this->impl->update_eval_plan(mm);
 }
 
 template <class T>
@@ -260,97 +317,249 @@ void preview_argument(std::ostream& os, const argument& a)
         });
 }
 
+// A linear evaluation plan for a module. Each instruction gets a dense slot for its result, and
+// the inputs are resolved to slots ahead of time so evaluation doesn't need to look up
+// instructions.
+struct module_plan
+{
+    enum class step_kind
+    {
+        literal,
+        param,
+        outline,
+        ret,
+        op
+    };
+
+    struct slot_ref
+    {
+        const module_plan* owner = nullptr;
+        std::size_t index        = 0;
+    };
+
+    struct step
+    {
+        instruction_ref ins;
+        step_kind kind = step_kind::op;
+        operation op{};
+        std::string param{};
+        std::vector<slot_ref> inputs{};
+    };
+
+    const module* mod   = nullptr;
+    std::size_t version = 0;
+    std::vector<step> steps{};
+};
+
+struct eval_plan
+{
+    explicit eval_plan(const module* mm)
+    {
+        std::unordered_map<instruction_ref, module_plan::slot_ref> slots;
+        add_module(mm, slots);
+    }
+
+    const module_plan& get(const module* m) const
+    {
+        auto it = modules.find(m);
+        if(it == modules.end())
+            MIGRAPHX_THROW("Module not in evaluation plan: " + m->name());
+        return it->second;
+    }
+
+    // Checks whether the modules have been modified since the plan was created
+    bool is_valid() const
+    {
+        return std::all_of(modules.begin(), modules.end(), [](const auto& pp) {
+            return pp.first->version() == pp.second.version;
+        });
+    }
+
+    private:
+    void add_module(const module* m,
+                    std::unordered_map<instruction_ref, module_plan::slot_ref>& slots)
+    {
+        if(contains(modules, m))
+            return;
+        // References stay valid as other modules are added
+        auto& mplan = modules[m];
+        mplan.mod     = m;
+        mplan.version = m->version();
+        mplan.steps.reserve(m->size());
+        for(auto ins : iterator_for(*m))
+        {
+            slots[ins] = module_plan::slot_ref{&mplan, mplan.steps.size()};
+            module_plan::step step;
+            step.ins         = ins;
+            const auto& name = ins->name();
+            if(name == "@literal")
+            {
+                step.kind = module_plan::step_kind::literal;
+            }
+            else if(name == "@param")
+            {
+                step.kind  = module_plan::step_kind::param;
+                step.param = any_cast<builtin::param>(ins->get_operator()).parameter;
+            }
+            else if(name == "@outline")
+            {
+                step.kind = module_plan::step_kind::outline;
+            }
+            else
+            {
+                step.kind = name == "@return" ? module_plan::step_kind::ret
+                                              : module_plan::step_kind::op;
+                step.op   = ins->normalized_operator();
+                std::transform(ins->inputs().begin(),
+                               ins->inputs().end(),
+                               std::back_inserter(step.inputs),
+                               [&](instruction_ref i) { return slots.at(i); });
+            }
+            mplan.steps.push_back(std::move(step));
+        }
+        // Submodules can refer to the instructions of this module, so they are added after
+        for(auto ins : iterator_for(*m))
+        {
+            for(auto* smod : ins->module_inputs())
+                add_module(smod, slots);
+        }
+    }
+
+    std::unordered_map<const module*, module_plan> modules;
+};
+
+void program_impl::update_eval_plan(const module* mm)
+{
+    if(target_name.empty())
+        return;
+    auto p = std::make_shared<eval_plan>(mm);
+    std::lock_guard<std::mutex> lock(plan_mutex);
+    plan = std::move(p);
+}
+
+std::shared_ptr<const eval_plan> program_impl::get_eval_plan(const module* mm)
+{
+    // Programs that aren't compiled are usually still being modified, so they get a new plan
+    if(target_name.empty())
+        return std::make_shared<eval_plan>(mm);
+    std::lock_guard<std::mutex> lock(plan_mutex);
+    if(plan == nullptr or not plan->is_valid())
+        plan = std::make_shared<eval_plan>(mm);
+    return plan;
+}
+
+// The results of a module being evaluated, which links to the module that called it so
+// submodules can read the results of their parents
+struct eval_frame
+{
+    const module_plan* plan  = nullptr;
+    const eval_frame* parent = nullptr;
+    std::vector<argument> results{};
+
+    const argument& operator[](const module_plan::slot_ref& s) const
+    {
+        const eval_frame* f = this;
+        while(f->plan != s.owner)
+        {
+            assert(f->parent != nullptr);
+            f = f->parent;
+        }
+        assert(s.index < f->results.size());
+        return f->results[s.index];
+    }
+};
+
 template <class F>
-std::vector<argument> generic_eval(const module* mod,
+std::vector<argument> generic_eval(const eval_plan& plan,
+                                   const module* mod,
                                    context& ctx,
-                                   std::unordered_map<std::string, argument> params,
-                                   std::unordered_map<instruction_ref, argument> results,
+                                   const std::unordered_map<std::string, argument>& params,
+                                   const eval_frame* parent,
                                    F make_trace)
 {
     assert(mod->validate() == mod->end());
-    results.reserve(mod->size() * 2);
+    const auto& mplan = plan.get(mod);
+    eval_frame frame{&mplan, parent};
+    frame.results.resize(mplan.steps.size());
     std::vector<argument> values;
     values.reserve(16);
     auto trace = make_trace(mod);
-    for(auto ins : iterator_for(*mod))
+    for(std::size_t i = 0; i < mplan.steps.size(); i++)
     {
-        assert(results.find(ins) == results.end());
-        const auto& name = ins->name();
-        if(name == "@literal")
-        {
-            results.emplace(ins, trace(ins, [&] { return ins->get_literal().get_argument(); }));
-        }
-        else if(name == "@param")
-        {
-            results.emplace(
-                ins, trace(ins, [&] {
-                    auto param_name = any_cast<builtin::param>(ins->get_operator()).parameter;
-                    if(not contains(params, param_name))
-                        MIGRAPHX_THROW("Parameter not found: " + param_name);
-                    auto param = params[param_name];
-                    if(param.get_shape() != ins->get_shape())
-                        MIGRAPHX_THROW("Incorrect shape {" + to_string(param.get_shape()) +
-                                       "} for parameter: " + param_name);
-                    return param;
-                }));
-        }
-        else if(name == "@outline")
-        {
-            results.emplace(ins, trace(ins, [&] { return argument{ins->get_shape(), nullptr}; }));
-        }
-        else if(name == "@return")
+        const auto& step = mplan.steps[i];
+        auto ins         = step.ins;
+        auto& result     = frame.results[i];
+        switch(step.kind)
         {
+        case module_plan::step_kind::literal:
+            result = trace(ins, [&] { return ins->get_literal().get_argument(); });
+            break;
+        case module_plan::step_kind::param:
+            result = trace(ins, [&] {
+                auto it = params.find(step.param);
+                if(it == params.end())
+                    MIGRAPHX_THROW("Parameter not found: " + step.param);
+                const auto& param = it->second;
+                if(param.get_shape() != ins->get_shape())
+                    MIGRAPHX_THROW("Incorrect shape {" + to_string(param.get_shape()) +
+                                   "} for parameter: " + step.param);
+                return param;
+            });
+            break;
+        case module_plan::step_kind::outline:
+            result = trace(ins, [&] { return argument{ins->get_shape(), nullptr}; });
+            break;
+        case module_plan::step_kind::ret: {
             std::vector<argument> prog_outputs;
-            std::transform(ins->inputs().begin(),
-                           ins->inputs().end(),
+            std::transform(step.inputs.begin(),
+                           step.inputs.end(),
                            std::back_inserter(prog_outputs),
-                           [&](instruction_ref i) {
-                               assert(results.find(i) != results.end());
-                               return results[i];
-                           });
-
+                           [&](const auto& s) { return frame[s]; });
             return prog_outputs;
         }
-        else
-        {
-            values.resize(ins->inputs().size());
-            std::transform(
-                ins->inputs().begin(), ins->inputs().end(), values.begin(), [&](instruction_ref i) {
-                    assert(results.find(i) != results.end());
-                    return results[i];
-                });
+        case module_plan::step_kind::op: {
+            values.resize(step.inputs.size());
+            std::transform(step.inputs.begin(),
+                           step.inputs.end(),
+                           values.begin(),
+                           [&](const auto& s) { return frame[s]; });
 
             const auto& mod_args = ins->module_inputs();
             auto module_eval     = [&](module_ref smod,
                                    const std::unordered_map<std::string, argument>& inputs) {
-                auto ssctx = ctx;
-                return generic_eval(smod, ssctx, inputs, results, make_trace);
+                return generic_eval(plan, smod, ctx, inputs, &frame, make_trace);
             };
 
-            results.emplace(ins, trace(ins, [&] {
-                                return ins->normalized_operator().compute(
-                                    ctx, ins->get_shape(), values, mod_args, module_eval);
-                            }));
+            result = trace(ins, [&] {
+                return step.op.compute(ctx, ins->get_shape(), values, mod_args, module_eval);
+            });
+            break;
+        }
         }
-        assert(results.find(ins) != results.end());
-        assert(results.at(ins).get_shape() == ins->get_shape());
+        assert(result.get_shape() == ins->get_shape());
     }
-    return {results.at(std::prev(mod->end()))};
+    return {frame.results.back()};
 }
 
 template <class F>
-std::vector<argument> generic_eval(const program& p,
+std::vector<argument> generic_eval(const eval_plan& plan,
+                                   const program& p,
                                    context& ctx,
-                                   std::unordered_map<std::string, argument> params,
+                                   const std::unordered_map<std::string, argument>& params,
                                    F make_trace)
 {
     const module* mm = p.get_main_module();
-    return generic_eval(mm, ctx, params, {}, make_trace);
+    return generic_eval(plan, mm, ctx, params, nullptr, make_trace);
 }
 
 std::vector<argument> program::eval(parameter_map params) const
 {
-    auto& ctx = this->impl->ctx;
+    return this->eval(this->impl->ctx, std::move(params));
+}
+
+std::vector<argument> program::eval(context& ctx, parameter_map params) const
+{
+    auto plan = this->impl->get_eval_plan(this->get_main_module());
 #ifndef NDEBUG
     auto with_check_context = [&](auto f) {
         return [=, &ctx](auto&&) {
@@ -384,7 +593,8 @@ std::vector<argument> program::eval(parameter_map params) const
             ins_out[x] = ss.str();
         });
 
-        return generic_eval(*this,
+        return generic_eval(*plan,
+                            *this,
                             ctx,
                             std::move(params),
                             with_check_context([&](auto& ins, auto f, auto&& check_context) {
@@ -420,7 +630,8 @@ std::vector<argument> program::eval(parameter_map params) const
     }
     else
     {
-        return generic_eval(*this,
+        return generic_eval(*plan,
+                            *this,
                             ctx,
                             std::move(params),
                             with_check_context([&](auto&, auto f, auto&& check_context) {
@@ -431,7 +642,11 @@ std::vector<argument> program::eval(parameter_map params) const
 
 const int program_file_version = 5;
 
-value program::to_value() const
+value program::to_value() const { return to_value(nullptr); }
+
+value program::to_value(data_section& section) const { return to_value(&section); }
+
+value program::to_value(data_section* section) const
 {
     value result;
     result["version"] = program_file_version;
@@ -454,8 +669,13 @@ value program::to_value() const
                 node["shape"]      = migraphx::to_value(ins->get_shape());
                 node["normalized"] = ins->is_normalized();
                 if(ins->name() == "@literal")
-                    node["literal"] = migraphx::to_value(ins->get_literal());
-                node["operator"] = ins->get_operator().to_value();
+                    node["literal"] = section == nullptr ? migraphx::to_value(ins->get_literal())
+                                                         : section->to_value(ins->get_literal());
+                auto fields = ins->get_operator().to_value();
+                // Operators such as compiled literals can hold raw data as well
+                if(section != nullptr)
+                    section->store(fields);
+                node["operator"] = fields;
                 std::vector<std::string> inputs;
                 std::transform(ins->inputs().begin(),
                                ins->inputs().end(),
@@ -492,7 +712,8 @@ value program::to_value() const
 static void mod_from_val(module_ref mod,
                          const value& v,
                          std::unordered_map<std::string, instruction_ref>& instructions,
-                         const std::unordered_map<std::string, module_ref>& map_mods)
+                         const std::unordered_map<std::string, module_ref>& map_mods,
+                         const data_section* section)
 {
     const auto& module_val = v.at(mod->name());
     for(const value& node : module_val.at("nodes"))
@@ -501,6 +722,8 @@ static void mod_from_val(module_ref mod,
         auto name       = node.at("name").to<std::string>();
         auto fields     = node.at("operator");
         auto normalized = node.at("normalized").to<bool>();
+        if(section != nullptr)
+            section->load(fields);
 
         if(name == "@param")
         {
@@ -509,7 +732,9 @@ static void mod_from_val(module_ref mod,
         }
         else if(name == "@literal")
         {
-            output = mod->add_literal(migraphx::from_value<literal>(node.at("literal")));
+            const auto& l = node.at("literal");
+            output        = mod->add_literal(section == nullptr ? migraphx::from_value<literal>(l)
+                                                                : section->literal_from_value(l));
         }
         else
         {
@@ -534,7 +759,7 @@ static void mod_from_val(module_ref mod,
 
                 for(auto& smod : module_inputs)
                 {
-                    mod_from_val(smod, v, instructions, map_mods);
+                    mod_from_val(smod, v, instructions, map_mods, section);
                 }
             }
 
@@ -556,7 +781,11 @@ static void mod_from_val(module_ref mod,
     }
 }
 
-void program::from_value(const value& v)
+void program::from_value(const value& v) { from_value(v, nullptr); }
+
+void program::from_value(const value& v, const data_section& section) { from_value(v, &section); }
+
+void program::from_value(const value& v, const data_section* section)
 {
     auto version = v.at("version").to<int>();
     if(version != program_file_version)
@@ -588,7 +817,7 @@ void program::from_value(const value& v)
 
     std::unordered_map<std::string, instruction_ref> map_insts;
     auto* mm = get_main_module();
-    mod_from_val(mm, module_vals, map_insts, map_mods);
+    mod_from_val(mm, module_vals, map_insts, map_mods, section);
 
     this->finalize();
 }
@@ -616,7 +845,8 @@ void program::mark(const parameter_map& params, marker&& m)
     ctx.finish();
     // Start marking
     m.mark_start(*this);
-    generic_eval(*this, ctx, params, always([&](auto ins, auto f) {
+    auto plan = this->impl->get_eval_plan(this->get_main_module());
+    generic_eval(*plan, *this, ctx, params, always([&](auto ins, auto f) {
         argument result;
         m.mark_start(ins);
         result = f();
@@ -647,8 +877,9 @@ void program::perf_report(std::ostream& os,
     }
     std::sort(total_vec.begin(), total_vec.end());
     std::unordered_map<instruction_ref, std::vector<double>> ins_vec;
+    auto plan = this->impl->get_eval_plan(this->get_main_module());
     // Fill the map
-    generic_eval(*this, ctx, params, always([&](auto ins, auto) {
+    generic_eval(*plan, *this, ctx, params, always([&](auto ins, auto) {
         ins_vec[ins].reserve(n);
         return argument{ins->get_shape(), nullptr};
     }));
@@ -656,7 +887,7 @@ void program::perf_report(std::ostream& os,
     // Run and time each instruction
     for(std::size_t i = 0; i < n; i++)
     {
-        generic_eval(*this, ctx, params, always([&](auto ins, auto f) {
+        generic_eval(*plan, *this, ctx, params, always([&](auto ins, auto f) {
             argument result;
             ins_vec[ins].push_back(time<milliseconds>([&] {
                 result = f();
@@ -808,7 +1039,8 @@ void program::print_cpp(std::ostream& os) const
 void program::dry_run(std::unordered_map<std::string, argument> params) const
 {
     auto& ctx = this->impl->ctx;
-    generic_eval(*this, ctx, std::move(params), always([](auto ins, auto&&...) {
+    auto plan = this->impl->get_eval_plan(this->get_main_module());
+    generic_eval(*plan, *this, ctx, params, always([](auto ins, auto&&...) {
         return argument{ins->get_shape(), nullptr};
     }));
 }
@@ -827,11 +1059,16 @@ const module* program::get_module(const std::string& name) const { return &impl-
 module* program::create_module(const std::string& name)
 {
     assert(not contains(impl->modules, name));
+    impl->reset_eval_plan();
     auto r = impl->modules.emplace(name, name);
     return &(r.first->second);
 }
 
-module* program::get_module(const std::string& name) { return &impl->modules.at(name); }
+module* program::get_module(const std::string& name)
+{
+    impl->reset_eval_plan();
+    return &impl->modules.at(name);
+}
 
 module* program::get_main_module() { return get_module("main"); }
 
@@ -944,6 +1181,7 @@ void program::remove_module(const std::string& name)
         }
     }
 
+    impl->reset_eval_plan();
     impl->modules.erase(name);
 }
 
@@ -958,6 +1196,7 @@ void program::remove_unused_modules()
 
 program& program::sort()
 {
+    impl->reset_eval_plan();
     for(auto& pp : this->impl->modules)
     {
         pp.second.sort();
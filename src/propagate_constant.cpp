@@ -26,12 +26,24 @@
 #include <migraphx/matcher.hpp>
 #include <migraphx/literal.hpp>
 #include <migraphx/functional.hpp>
-#include <migraphx/par_for.hpp>
+#include <migraphx/thread_pool.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/file_buffer.hpp>
+#include <migraphx/filesystem.hpp>
+#include <migraphx/hash.hpp>
+#include <migraphx/tmp_dir.hpp>
+#include <migraphx/env.hpp>
+#include <migraphx/version.h>
+#include <numeric>
+#include <sstream>
+#include <unordered_map>
 #include <unordered_set>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_CONSTANT_CACHE)
+
 bool skip_propogate(instruction_ref ins)
 {
     if(ins->name() == "contiguous")
@@ -46,39 +58,235 @@ bool skip_propogate(instruction_ref ins)
 
 bool is_const(instruction_ref ins) { return ins->can_eval() and not skip_propogate(ins); }
 
+// Folding an instruction that is much larger than its inputs, such as a tile or a broadcast that
+// is made contiguous, would use more memory than it saves
+static bool grows(instruction_ref ins, std::size_t max_growth, std::size_t min_bytes)
+{
+    auto bytes = ins->get_shape().bytes();
+    if(bytes <= min_bytes or ins->inputs().empty())
+        return false;
+    auto input_bytes = std::accumulate(
+        ins->inputs().begin(), ins->inputs().end(), std::size_t{0}, [](auto n, auto input) {
+            return n + input->get_shape().bytes();
+        });
+    return bytes > max_growth * input_bytes;
+}
+
+// Describes the operators and the literals that an instruction is computed from, one line per
+// instruction with the inputs referred to by their line. The contents of the literals are only
+// included as a hash, since they can be large.
+static std::string fold_key(instruction_ref root)
+{
+    std::unordered_map<instruction_ref, std::size_t> ids;
+    std::stringstream ss;
+    ss << MIGRAPHX_VERSION_STRING << " " << MIGRAPHX_GIT_HASH << "\n";
+    fix([&](auto self, instruction_ref ins) {
+        if(contains(ids, ins))
+            return;
+        for(auto input : ins->inputs())
+            self(input);
+        auto id = ids.size();
+        ss << id << ": ";
+        if(ins->name() == "@literal")
+            ss << "@literal " << std::hex << hash_value(ins->get_literal()) << std::dec;
+        else
+            ss << ins->name() << " " << ins->get_operator().to_value();
+        ss << " -> " << ins->get_shape();
+        for(auto input : ins->inputs())
+            ss << " " << ids.at(input);
+        ss << "\n";
+        ids[ins] = id;
+    })(root);
+    return ss.str();
+}
+
+static fs::path cache_file(const fs::path& dir, const std::string& key)
+{
+    std::stringstream ss;
+    ss << std::hex << std::hash<std::string>{}(key);
+    return dir / ss.str();
+}
+
+// The key is stored next to the data and compared when loading to rule out collisions. A cache
+// that can't be read is treated as a miss.
+static argument load_cached(const fs::path& file, const std::string& key, const shape& s)
+{
+    auto data_file = file;
+    data_file += ".bin";
+    auto key_file = file;
+    key_file += ".key";
+    try
+    {
+        std::error_code ec;
+        if(not fs::exists(key_file, ec) or not fs::exists(data_file, ec))
+            return {};
+        if(read_string(key_file.string()) != key)
+            return {};
+        auto buffer = read_buffer(data_file.string());
+        if(buffer.size() != s.bytes())
+            return {};
+        return literal{s, buffer.data()}.get_argument();
+    }
+    catch(const std::exception&)
+    {
+        return {};
+    }
+}
+
+// Write to a temporary file first so another process never reads a partial file
+static void write_atomic(const fs::path& file, const char* buffer, std::size_t size)
+{
+    auto tmp = file;
+    tmp += "." + unique_string("tmp");
+    try
+    {
+        write_buffer(tmp.string(), buffer, size);
+        fs::rename(tmp, file);
+    }
+    catch(...)
+    {
+        std::error_code ec;
+        fs::remove(tmp, ec);
+        throw;
+    }
+}
+
+static void store_cached(const fs::path& file, const std::string& key, const argument& arg)
+{
+    auto data_file = file;
+    data_file += ".bin";
+    auto key_file = file;
+    key_file += ".key";
+    // Failing to cache a literal should not fail the compilation
+    try
+    {
+        write_atomic(data_file, arg.data(), arg.get_shape().bytes());
+        // The key is written last since it marks the entry as complete
+        write_atomic(key_file, key.data(), key.size());
+    }
+    catch(const std::exception&)
+    {
+    }
+}
+
 void propagate_constant::apply(module& m) const
 {
-    std::unordered_set<instruction_ref> const_instrs;
+    auto is_folded = [&](instruction_ref ins) {
+        return is_const(ins) and not grows(ins, max_growth, min_growth_bytes);
+    };
+    std::vector<instruction_ref> const_instrs;
+    std::unordered_set<instruction_ref> visited;
     auto last = std::prev(m.end());
 
     // Find instructions that can be evaluated to a literal
     for(auto i : iterator_for(m))
     {
-        if(is_const(i) and i != last)
+        if(is_folded(i) and i != last)
             continue;
 
-        std::copy_if(
-            i->inputs().begin(),
-            i->inputs().end(),
-            std::inserter(const_instrs, const_instrs.begin()),
-            [&](const instruction_ref ins) { return is_const(ins) and ins->name() != "@literal"; });
+        for(auto ins : i->inputs())
+        {
+            if(is_folded(ins) and ins->name() != "@literal" and visited.insert(ins).second)
+                const_instrs.push_back(ins);
+        }
+    }
+    if(const_instrs.empty())
+        return;
+
+    std::unordered_map<instruction_ref, argument> results;
+    std::string dir = cache_dir.empty() ? string_value_of(MIGRAPHX_CONSTANT_CACHE{}) : cache_dir;
+    std::unordered_map<instruction_ref, std::string> keys;
+    if(not dir.empty())
+    {
+        std::error_code ec;
+        fs::create_directories(dir, ec);
+        for(auto ins : const_instrs)
+        {
+            auto key = fold_key(ins);
+            auto arg = load_cached(cache_file(dir, key), key, ins->get_shape());
+            if(arg.empty())
+                keys[ins] = std::move(key);
+            else
+                results[ins] = arg;
+        }
     }
 
-    // Compute literals in parallel
-    std::vector<instruction_ref> const_instrs_vec{const_instrs.begin(), const_instrs.end()};
-    std::vector<argument> literals(const_instrs_vec.size());
-    par_for(const_instrs_vec.size(), 1, [&](const auto i) {
-        literals[i] = const_instrs_vec[i]->eval();
+    // Find everything that has to be evaluated, and group it by depth so that each level only
+    // depends on the levels before it
+    std::unordered_map<instruction_ref, std::size_t> depth;
+    std::vector<std::vector<instruction_ref>> levels;
+    auto find_depth = fix<std::size_t>([&](auto self, instruction_ref ins) -> std::size_t {
+        if(ins->name() == "@literal" or contains(results, ins))
+            return 0;
+        auto it = depth.find(ins);
+        if(it != depth.end())
+            return it->second;
+        std::size_t d = 0;
+        for(auto input : ins->inputs())
+            d = std::max(d, self(input));
+        depth[ins] = d + 1;
+        if(levels.size() <= d)
+            levels.resize(d + 1);
+        levels[d].push_back(ins);
+        return d + 1;
     });
+    for(auto ins : const_instrs)
+        find_depth(ins);
+
+    // Count the evaluations that still need each result, so that intermediate results can be
+    // released once the last of them is done
+    std::unordered_map<instruction_ref, std::size_t> remaining;
+    for(const auto& level : levels)
+    {
+        for(auto ins : level)
+        {
+            for(auto input : ins->inputs())
+                remaining[input]++;
+        }
+    }
+
+    for(const auto& level : levels)
+    {
+        std::vector<argument> level_results(level.size());
+        thread_pool::global().run(level.size(), [&](std::size_t i) {
+            auto ins = level[i];
+            std::vector<argument> args;
+            std::transform(ins->inputs().begin(),
+                           ins->inputs().end(),
+                           std::back_inserter(args),
+                           [&](auto input) {
+                               if(input->name() == "@literal")
+                                   return input->get_literal().get_argument();
+                               return results.at(input);
+                           });
+            level_results[i] = ins->normalized_operator().compute(ins->get_shape(), args);
+        });
+        for(std::size_t i = 0; i < level.size(); i++)
+        {
+            results[level[i]] = level_results[i];
+            auto it = keys.find(level[i]);
+            if(it != keys.end())
+                store_cached(cache_file(dir, it->second), it->second, level_results[i]);
+        }
+        for(auto ins : level)
+        {
+            for(auto input : ins->inputs())
+            {
+                if(--remaining[input] == 0 and not contains(visited, input))
+                    results.erase(input);
+            }
+        }
+    }
 
     // Replace instructions in m
-    for(size_t i = 0; i < const_instrs_vec.size(); i++)
+    for(auto ins : const_instrs)
     {
-        if(not literals[i].empty())
+        const auto& arg = results.at(ins);
+        if(not arg.empty())
         {
-            assert(literals[i].get_shape() == const_instrs_vec[i]->get_shape());
-            auto l = m.add_literal(literals[i].get_shape(), literals[i].data());
-            m.replace_instruction(const_instrs_vec[i], l);
+            assert(arg.get_shape() == ins->get_shape());
+            auto l = m.add_literal(arg.get_shape(), arg.data());
+            m.replace_instruction(ins, l);
         }
     }
 }
@@ -25,7 +25,9 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 #include <pybind11/numpy.h>
+#include <chrono>
 #include <migraphx/program.hpp>
+#include <migraphx/execution_session.hpp>
 #include <migraphx/instruction_ref.hpp>
 #include <migraphx/operation.hpp>
 #include <migraphx/quantization.hpp>
@@ -233,6 +235,40 @@ migraphx::shape to_shape(const py::buffer_info& info)
     }
 }
 
+migraphx::parameter_map to_parameter_map(const py::dict& params)
+{
+    migraphx::parameter_map pm;
+    for(auto x : params)
+    {
+        std::string key      = x.first.cast<std::string>();
+        py::buffer b         = x.second.cast<py::buffer>();
+        py::buffer_info info = b.request();
+        pm[key]              = migraphx::argument(to_shape(info), info.ptr);
+    }
+    return pm;
+}
+
+std::vector<migraphx::argument> to_arguments(const py::list& buffers)
+{
+    std::vector<migraphx::argument> result;
+    for(auto x : buffers)
+    {
+        py::buffer b         = x.cast<py::buffer>();
+        py::buffer_info info = b.request(true);
+        result.emplace_back(to_shape(info), info.ptr);
+    }
+    return result;
+}
+
+// Keeps the python objects used by the evaluation alive until it finishes
+struct run_future
+{
+    py::object params;
+    py::object outputs;
+    py::object session;
+    std::shared_future<std::vector<migraphx::argument>> result;
+};
+
 MIGRAPHX_PYBIND11_MODULE(migraphx, m)
 {
     py::class_<migraphx::shape>(m, "shape")
@@ -326,15 +362,21 @@ MIGRAPHX_PYBIND11_MODULE(migraphx, m)
         .def("get_output_shapes", &migraphx::program::get_output_shapes)
         .def(
             "compile",
-            [](migraphx::program& p, const migraphx::target& t, bool offload_copy, bool fast_math) {
+            [](migraphx::program& p,
+               const migraphx::target& t,
+               bool offload_copy,
+               bool fast_math,
+               const std::string& cache_dir) {
                 migraphx::compile_options options;
                 options.offload_copy = offload_copy;
                 options.fast_math    = fast_math;
+                options.cache_dir    = cache_dir;
                 p.compile(t, options);
             },
             py::arg("t"),
             py::arg("offload_copy") = true,
-            py::arg("fast_math")    = true)
+            py::arg("fast_math")    = true,
+            py::arg("cache_dir")    = "")
         .def("get_main_module", [](const migraphx::program& p) { return p.get_main_module(); })
         .def(
             "create_module",
@@ -342,15 +384,7 @@ MIGRAPHX_PYBIND11_MODULE(migraphx, m)
             py::arg("name"))
         .def("run",
              [](migraphx::program& p, py::dict params) {
-                 migraphx::parameter_map pm;
-                 for(auto x : params)
-                 {
-                     std::string key      = x.first.cast<std::string>();
-                     py::buffer b         = x.second.cast<py::buffer>();
-                     py::buffer_info info = b.request();
-                     pm[key]              = migraphx::argument(to_shape(info), info.ptr);
-                 }
-                 return p.eval(pm);
+                 return p.eval(to_parameter_map(params));
              })
         .def("sort", &migraphx::program::sort)
         .def("print", [](const migraphx::program& p) { std::cout << p << std::endl; })
@@ -358,6 +392,53 @@ MIGRAPHX_PYBIND11_MODULE(migraphx, m)
         .def("__ne__", std::not_equal_to<migraphx::program>{})
         .def("__repr__", [](const migraphx::program& p) { return migraphx::to_string(p); });
 
+    py::class_<migraphx::execution_session>(m, "execution_session")
+        .def(py::init<const migraphx::program&>(), py::keep_alive<1, 2>(), py::arg("p"))
+        .def(
+            "run",
+            [](migraphx::execution_session& session, py::dict params, py::object outputs) {
+                auto pm = to_parameter_map(params);
+                if(outputs.is_none())
+                {
+                    py::gil_scoped_release nogil;
+                    return session.eval(std::move(pm));
+                }
+                auto outs = to_arguments(outputs.cast<py::list>());
+                py::gil_scoped_release nogil;
+                return session.eval(std::move(pm), outs);
+            },
+            py::arg("params"),
+            py::arg("outputs") = py::none())
+        .def(
+            "run_async",
+            [](py::object self, py::dict params, py::object outputs) {
+                auto& session = self.cast<migraphx::execution_session&>();
+                std::vector<migraphx::argument> outs;
+                if(not outputs.is_none())
+                    outs = to_arguments(outputs.cast<py::list>());
+                return run_future{
+                    params, outputs, self, session.eval_async(to_parameter_map(params), outs)};
+            },
+            py::arg("params"),
+            py::arg("outputs") = py::none())
+        .def("get_output_parameter_names",
+             &migraphx::execution_session::get_output_parameter_names);
+
+    py::class_<run_future>(m, "run_future")
+        .def("get",
+             [](const run_future& f) {
+                 py::gil_scoped_release nogil;
+                 return f.result.get();
+             })
+        .def("wait",
+             [](const run_future& f) {
+                 py::gil_scoped_release nogil;
+                 f.result.wait();
+             })
+        .def("done", [](const run_future& f) {
+            return f.result.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        });
+
     py::class_<migraphx::operation>(m, "op")
         .def(py::init([](const std::string& name, py::kwargs kwargs) {
             migraphx::value v = migraphx::value::object{};
@@ -462,12 +543,40 @@ MIGRAPHX_PYBIND11_MODULE(migraphx, m)
           &migraphx::quantize_fp16,
           py::arg("prog"),
           py::arg("ins_names") = std::vector<std::string>{"all"});
-    m.def("quantize_int8",
-          &migraphx::quantize_int8,
+    m.def(
+        "quantize_int8",
+        [](migraphx::program& prog,
+           const migraphx::target& t,
+           const std::vector<migraphx::parameter_map>& calibration,
+           const std::vector<std::string>& ins_names,
+           const std::string& calibration_method,
+           double percentile,
+           const std::string& calibration_table,
+           bool per_channel,
+           bool asymmetric) {
+            migraphx::calibration_options options;
+            options.method      = migraphx::to_calibration_method(calibration_method);
+            options.percentile  = percentile;
+            options.table       = calibration_table;
+            options.per_channel = per_channel;
+            options.asymmetric  = asymmetric;
+            migraphx::quantize_int8(prog, t, calibration, ins_names, options);
+        },
+        py::arg("prog"),
+        py::arg("t"),
+        py::arg("calibration")        = std::vector<migraphx::parameter_map>{},
+        py::arg("ins_names")          = std::vector<std::string>{"dot", "convolution"},
+        py::arg("calibration_method") = "max",
+        py::arg("percentile")         = 99.99,
+        py::arg("calibration_table")  = "",
+        py::arg("per_channel")        = false,
+        py::arg("asymmetric")         = false);
+    m.def("quantize_weights",
+          &migraphx::quantize_weights,
           py::arg("prog"),
           py::arg("t"),
-          py::arg("calibration") = std::vector<migraphx::parameter_map>{},
-          py::arg("ins_names")   = std::vector<std::string>{"dot", "convolution"});
+          py::arg("bits")       = 8,
+          py::arg("group_size") = 128);
 
 #ifdef HAVE_GPU
     m.def("allocate_gpu", &migraphx::gpu::allocate_gpu, py::arg("s"), py::arg("host") = false);
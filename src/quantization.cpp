@@ -21,11 +21,15 @@
  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
  * THE SOFTWARE.
  */
+#include <migraphx/calibration.hpp>
+#include <migraphx/filesystem.hpp>
 #include <migraphx/float_equal.hpp>
+#include <migraphx/hash.hpp>
 #include <migraphx/instruction_ref.hpp>
 #include <migraphx/quantization.hpp>
 #include <migraphx/quantize_fp16.hpp>
 #include <migraphx/quantize_int8.hpp>
+#include <migraphx/quantize_weights.hpp>
 #include <migraphx/simplify_reshapes.hpp>
 #include <migraphx/simplify_qdq.hpp>
 #include <migraphx/eliminate_common_subexpression.hpp>
@@ -40,6 +44,7 @@
 #include <migraphx/make_op.hpp>
 #include <migraphx/pass_manager.hpp>
 #include <set>
+#include <sstream>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -66,7 +71,8 @@ void quantize_fp16(program& prog, const std::vector<std::string>& ins_names)
 void quantize_int8(program& prog,
                    const target& t,
                    const std::vector<parameter_map>& calibration,
-                   const std::vector<std::string>& ins_names)
+                   const std::vector<std::string>& ins_names,
+                   const calibration_options& options)
 {
     std::set<std::string> op_names = {"convolution", "dot"};
     std::set<std::string> input_ins_names(ins_names.begin(), ins_names.end());
@@ -76,71 +82,97 @@ void quantize_int8(program& prog,
         MIGRAPHX_THROW("QUANTIZE_INT8: only support DOT and CONVOLUTION operation");
     }
 
-    std::shared_ptr<std::vector<std::pair<float, float>>> int8_quant_params =
-        std::make_shared<std::vector<std::pair<float, float>>>();
-    std::shared_ptr<std::vector<float>> max_abs_vals = std::make_shared<std::vector<float>>();
-
-    auto calc_quant_params = [int8_quant_params, max_abs_vals, &t](std::size_t ins_index,
-                                                                   std::vector<argument> args) {
-        std::pair<float, float> param_pair{64.0f, 0.0f};
-        // scale and shift is need for only int8 type, and we do not
-        // consider shift, so set shift to 0
-        std::vector<float> vec_val;
-        argument arg = t.copy_from(args.front());
-        arg.visit([&](auto output) { vec_val.assign(output.begin(), output.end()); });
-        auto max_val                = *std::max_element(vec_val.begin(), vec_val.end());
-        auto min_val                = *std::min_element(vec_val.begin(), vec_val.end());
-        auto max_abs                = std::max(std::fabs(max_val), std::fabs(min_val));
-        max_abs_vals->at(ins_index) = std::max(max_abs_vals->at(ins_index), max_abs);
-
-        // if all values are 0, no need to do scaling
-        if(max_abs_vals->at(ins_index) == 0.0f)
-        {
-            param_pair.first = 1.0f;
-        }
-        else
-        {
-            param_pair.first = 127.0f / max_abs_vals->at(ins_index);
-        }
-        int8_quant_params->at(ins_index) = param_pair;
+    auto histograms        = std::make_shared<std::vector<calibration_histogram>>();
+    auto calc_quant_params = [histograms, &t](std::size_t ins_index, std::vector<argument> args) {
+        histograms->at(ins_index).update(t.copy_from(args.front()));
     };
 
     // pass to add capture argument op
     std::size_t param_num = 0;
     run_passes(prog, {capture_arguments_pass{ins_names, calc_quant_params, &param_num}});
-    int8_quant_params->resize(param_num, std::pair<float, float>(64.0f, 0.0f));
-    max_abs_vals->resize(param_num, 0.0f);
 
-    // use the calibration data to compute the quantization scale
-    auto capture_prog = prog;
-    capture_prog.compile(t);
+    // A table can only be used for the program it was collected from, with the same bins
+    std::string table_key;
+    if(not options.table.empty())
+    {
+        std::size_t seed = hash_value(prog.to_value());
+        hash_combine(seed, options.bins);
+        std::stringstream ss;
+        ss << std::hex << seed;
+        table_key = ss.str();
+    }
 
-    // use all calibration data to run the program to calculate the
-    // quantization scale and shift
-    for(auto&& arg : calibration)
+    bool use_table = not options.table.empty() and fs::exists(options.table);
+    if(use_table)
+    {
+        *histograms = load_calibration_table(options.table, table_key);
+        if(histograms->size() != param_num)
+            MIGRAPHX_THROW("QUANTIZE_INT8: calibration table " + options.table + " has " +
+                           std::to_string(histograms->size()) + " entries but the program has " +
+                           std::to_string(param_num));
+    }
+    else
     {
-        parameter_map m;
-        for(auto&& x : capture_prog.get_parameter_shapes())
+        histograms->resize(param_num, calibration_histogram{options.bins});
+
+        // use the calibration data to compute the quantization scale
+        auto capture_prog = prog;
+        capture_prog.compile(t);
+
+        // use all calibration data to run the program to calculate the
+        // quantization scale and shift
+        for(auto&& arg : calibration)
         {
-            if(arg.count(x.first) > 0)
+            parameter_map m;
+            for(auto&& x : capture_prog.get_parameter_shapes())
             {
-                assert(x.second == arg.at(x.first).get_shape());
-                m[x.first] = t.copy_to(arg.at(x.first));
+                if(arg.count(x.first) > 0)
+                {
+                    assert(x.second == arg.at(x.first).get_shape());
+                    m[x.first] = t.copy_to(arg.at(x.first));
+                }
+                else
+                {
+                    m[x.first] = t.allocate(x.second);
+                }
             }
-            else
+            capture_prog.eval(m);
+        }
+
+        if(not options.table.empty())
+            save_calibration_table(*histograms, table_key, options.table);
+    }
+
+    // Only the activations going into the first input of an operator are asymmetric, since the
+    // zero point can then be folded into the quantized operator
+    std::set<std::size_t> asymmetric_params;
+    if(options.asymmetric)
+    {
+        for(auto* mod : prog.get_modules())
+        {
+            for(auto ins : iterator_for(*mod))
             {
-                m[x.first] = t.allocate(x.second);
+                if(ins->name() != "capture" or ins->inputs().front()->can_eval())
+                    continue;
+                if(ins->outputs().size() != 1 or ins->outputs().front()->inputs().front() != ins)
+                    continue;
+                asymmetric_params.insert(
+                    ins->get_operator().to_value().at("ins_index").to<std::size_t>());
             }
         }
-        capture_prog.eval(m);
     }
 
+    std::vector<std::pair<float, float>> int8_quant_params(param_num);
+    for(std::size_t i = 0; i < param_num; ++i)
+        int8_quant_params[i] =
+            histograms->at(i).quant_params(options, contains(asymmetric_params, i));
+
     // print the quantization parameters in only the main module
     if(enabled(MIGRAPHX_INT8_QUANTIZATION_PARAMS{}))
     {
-        for(std::size_t i = 0; i < int8_quant_params->size(); ++i)
+        for(std::size_t i = 0; i < int8_quant_params.size(); ++i)
         {
-            auto param = int8_quant_params->at(i);
+            auto param = int8_quant_params.at(i);
             std::cout << "ins_index = " << i << ", scale = " << param.first
                       << ", shift = " << param.second << std::endl;
         }
@@ -148,7 +180,8 @@ void quantize_int8(program& prog,
     }
 
     run_passes(prog,
-               {quantize_int8_pass{ins_names, *int8_quant_params},
+               {quantize_int8_pass{
+                    ins_names, int8_quant_params, options.per_channel, asymmetric_params},
                 eliminate_common_subexpression{},
                 dead_code_elimination{},
                 simplify_reshapes{},
@@ -157,5 +190,15 @@ void quantize_int8(program& prog,
                 dead_code_elimination{}});
 }
 
+// Only the weights are quantized so no calibration is needed, and they are dequantized as the
+// dot is computed. Only the cpu and ref targets have an implementation of weight_dot.
+void quantize_weights(program& prog, const target& t, std::size_t bits, std::size_t group_size)
+{
+    if(not contains({"cpu", "ref"}, t.name()))
+        MIGRAPHX_THROW("QUANTIZE_WEIGHTS: weight_dot is not supported on the " + t.name() +
+                       " target");
+    run_passes(prog, {quantize_weights_pass{bits, group_size}, dead_code_elimination{}});
+}
+
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
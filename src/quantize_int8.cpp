@@ -35,6 +35,7 @@
 #include <migraphx/target.hpp>
 #include <migraphx/make_op.hpp>
 #include <migraphx/pass_manager.hpp>
+#include <cmath>
 #include <numeric>
 #include <set>
 
@@ -50,6 +51,43 @@ static std::vector<shape::type_t>& get_quantizable_type()
     return quantable_types;
 }
 
+// The axis of the output channels when the capture is of the constant weights of a convolution or
+// a dot, or -1 otherwise
+static int64_t weights_channel_axis(instruction_ref capture)
+{
+    auto input = capture->inputs().front();
+    if(capture->outputs().size() != 1 or not input->can_eval())
+        return -1;
+    auto op_ins = capture->outputs().front();
+    if(op_ins->inputs().size() < 2 or op_ins->inputs()[1] != capture)
+        return -1;
+    if(op_ins->name() == "convolution")
+        return 0;
+    if(op_ins->name() == "dot")
+        return input->get_shape().lens().size() - 1;
+    return -1;
+}
+
+static literal per_channel_scales(const argument& weights, std::size_t axis, shape::type_t type)
+{
+    const auto& lens  = weights.get_shape().lens();
+    auto channels     = lens[axis];
+    std::size_t inner = std::accumulate(
+        lens.begin() + axis + 1, lens.end(), std::size_t{1}, std::multiplies<>{});
+    std::vector<float> scales(channels, 0.0f);
+    weights.visit([&](auto w) {
+        for(std::size_t i = 0; i < w.size(); i++)
+        {
+            auto& x = scales[(i / inner) % channels];
+            x       = std::max(x, std::fabs(static_cast<float>(w[i])));
+        }
+    });
+    std::transform(scales.begin(), scales.end(), scales.begin(), [](auto x) {
+        return (x == 0.0f) ? 1.0f : x / 127.0f;
+    });
+    return literal{{type, {channels}}, scales};
+}
+
 void quantize_int8_pass::apply(module& m) const // NOLINT
 {
     const auto& quantizable_types = get_quantizable_type();
@@ -68,11 +106,27 @@ void quantize_int8_pass::apply(module& m) const // NOLINT
         auto s     = input->get_shape();
         if(contains(quantizable_types, s.type()) and s.type() != shape::int8_type)
         {
-            auto zero_point  = m.add_literal(static_cast<int8_t>(param.second));
-            auto scale       = m.add_literal(literal({s.type()}, {1.0f / param.first}));
+            auto axis = per_channel ? weights_channel_axis(ins) : -1;
+            instruction_ref zero_point;
+            instruction_ref scale;
             const auto& lens = s.lens();
-            scale =
-                m.insert_instruction(ins, make_op("multibroadcast", {{"out_lens", lens}}), scale);
+            if(axis >= 0)
+            {
+                zero_point = m.add_literal(int8_t{0});
+                scale      = m.add_literal(per_channel_scales(input->eval(), axis, s.type()));
+                scale      = m.insert_instruction(
+                    ins, make_op("broadcast", {{"axis", axis}, {"out_lens", lens}}), scale);
+            }
+            else
+            {
+                if(contains(asymmetric_params, param_index))
+                    zero_point = m.add_literal(static_cast<uint8_t>(param.second));
+                else
+                    zero_point = m.add_literal(static_cast<int8_t>(param.second));
+                scale = m.add_literal(literal({s.type()}, {1.0f / param.first}));
+                scale = m.insert_instruction(
+                    ins, make_op("multibroadcast", {{"out_lens", lens}}), scale);
+            }
             zero_point = m.insert_instruction(
                 ins, make_op("multibroadcast", {{"out_lens", lens}}), zero_point);
             auto q_in =
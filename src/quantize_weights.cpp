@@ -0,0 +1,109 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/quantize_weights.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/shape_for_each.hpp>
+#include <cmath>
+#include <numeric>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+// The weights of a dot when they are constant, looking through a broadcast of 2D weights
+static instruction_ref get_weights(instruction_ref ins)
+{
+    auto w = ins->inputs().at(1);
+    if(w->name() == "multibroadcast")
+        w = w->inputs().front();
+    return w;
+}
+
+void quantize_weights_pass::apply(module& m) const
+{
+    if(bits != 4 and bits != 8)
+        MIGRAPHX_THROW("QUANTIZE_WEIGHTS: only 4 or 8 bits are supported");
+    const int qmax = (1 << (bits - 1)) - 1;
+    for(auto ins : iterator_for(m))
+    {
+        if(ins->name() != "dot" or ins->inputs().size() != 2)
+            continue;
+        auto a = ins->inputs().front();
+        auto w = get_weights(ins);
+        if(not contains({shape::float_type, shape::half_type}, a->get_shape().type()) or
+           w->get_shape().type() != a->get_shape().type())
+            continue;
+        if(w->get_shape().lens().size() != 2 or not w->can_eval())
+            continue;
+        auto k = w->get_shape().lens()[0];
+        auto n = w->get_shape().lens()[1];
+        if(k * bits % 8 != 0)
+            continue;
+        // Fall back to a single group when the inner dimension cannot be split evenly
+        auto group  = (group_size > 0 and k % group_size == 0) ? group_size : k;
+        auto groups = k / group;
+
+        auto weights = w->eval();
+        std::vector<float> values(k * n);
+        weights.visit([&](auto v) {
+            // Transpose so each output column is contiguous
+            shape_for_each(weights.get_shape(), [&](const auto& idx) {
+                values[idx[1] * k + idx[0]] = v(idx[0], idx[1]);
+            });
+        });
+
+        std::vector<float> scales(n * groups);
+        std::vector<int8_t> packed(n * k * bits / 8, 0);
+        for(std::size_t i = 0; i < n * groups; i++)
+        {
+            auto first = values.begin() + i * group;
+            auto x     = std::accumulate(first, first + group, 0.0f, [](auto acc, auto y) {
+                return std::max(acc, std::fabs(y));
+            });
+            scales[i]  = (x == 0.0f) ? 1.0f : x / qmax;
+            for(std::size_t j = i * group; j < (i + 1) * group; j++)
+            {
+                auto q = static_cast<int>(std::round(values[j] / scales[i]));
+                q      = std::max(-qmax, std::min(qmax, q));
+                if(bits == 8)
+                    packed[j] = q;
+                else
+                    packed[j / 2] |= (j % 2 == 0) ? (q & 0xf) : ((q & 0xf) << 4);
+            }
+        }
+
+        auto qw = m.add_literal(literal{{shape::int8_type, {n, k * bits / 8}}, packed});
+        auto qs = m.add_literal(literal{{a->get_shape().type(), {n, groups}}, scales});
+        if(not a->get_shape().standard())
+            a = m.insert_instruction(ins, make_op("contiguous"), a);
+        m.replace_instruction(
+            ins, make_op("weight_dot", {{"bits", bits}, {"group_size", group}}), a, qw, qs);
+    }
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -0,0 +1,291 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/request_batcher.hpp>
+#include <migraphx/execution_session.hpp>
+#include <migraphx/errors.hpp>
+#include <migraphx/functional.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/stringutils.hpp>
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <iterator>
+#include <mutex>
+#include <thread>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+static std::size_t get_batch(const shape& s)
+{
+    if(s.lens().empty())
+        MIGRAPHX_THROW("Batching requires a batch dimension: " + to_string(s));
+    return s.lens().front();
+}
+
+static shape with_batch(const shape& s, std::size_t n)
+{
+    auto lens    = s.lens();
+    lens.front() = n;
+    return {s.type(), lens};
+}
+
+struct batch_bucket
+{
+    std::size_t size = 0;
+    program prog;
+    std::unique_ptr<execution_session> session = nullptr;
+    // Buffers the requests are packed into, which are reused by every batch
+    parameter_map inputs{};
+};
+
+struct batch_request
+{
+    parameter_map params;
+    std::promise<std::vector<argument>> result;
+    std::chrono::steady_clock::time_point arrival;
+};
+
+struct request_batcher_impl
+{
+    batcher_options options;
+    std::vector<batch_bucket> buckets;
+    std::unordered_map<std::string, shape> sample_shapes;
+    std::vector<shape> sample_output_shapes;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<batch_request> queue;
+    bool stopped = false;
+    batcher_stats stats;
+    std::thread worker;
+
+    request_batcher_impl(std::vector<program> programs, batcher_options opts)
+        : options(opts)
+    {
+        if(programs.empty())
+            MIGRAPHX_THROW("No programs to batch requests for");
+        for(auto& p : programs)
+            add_bucket(std::move(p));
+        std::sort(buckets.begin(), buckets.end(), by(std::less<>{}, [](const auto& b) {
+                      return b.size;
+                  }));
+        auto dup = std::adjacent_find(buckets.begin(), buckets.end(), [](auto&& x, auto&& y) {
+            return x.size == y.size;
+        });
+        if(dup != buckets.end())
+            MIGRAPHX_THROW("Multiple programs for batch size " + std::to_string(dup->size));
+        if(options.max_batch == 0)
+            options.max_batch = buckets.back().size;
+        if(options.max_batch > buckets.back().size)
+            MIGRAPHX_THROW("Max batch of " + std::to_string(options.max_batch) +
+                           " is larger than the largest bucket");
+        // The buckets don't move anymore so the sessions can refer to their programs
+        for(auto& b : buckets)
+            b.session = std::make_unique<execution_session>(b.prog);
+        worker = std::thread{[this] { this->run(); }};
+    }
+
+    void add_bucket(program p)
+    {
+        if(not p.is_compiled())
+            MIGRAPHX_THROW("Programs must be compiled to batch requests");
+        auto param_shapes = p.get_parameter_shapes();
+        if(param_shapes.empty())
+            MIGRAPHX_THROW("Batching requires programs with parameters");
+        batch_bucket b;
+        b.size = get_batch(param_shapes.begin()->second);
+        std::unordered_map<std::string, shape> samples;
+        for(auto&& pp : param_shapes)
+        {
+            if(get_batch(pp.second) != b.size or not pp.second.standard())
+                MIGRAPHX_THROW("Parameter " + pp.first +
+                               " must be a standard shape with a batch dimension of " +
+                               std::to_string(b.size));
+            samples[pp.first]  = with_batch(pp.second, 1);
+            b.inputs[pp.first] = argument{pp.second};
+        }
+        std::vector<shape> output_samples;
+        for(auto&& s : p.get_output_shapes())
+        {
+            if(get_batch(s) != b.size or not s.standard())
+                MIGRAPHX_THROW("Outputs must be standard shapes with a batch dimension of " +
+                               std::to_string(b.size));
+            output_samples.push_back(with_batch(s, 1));
+        }
+        if(buckets.empty())
+        {
+            sample_shapes        = samples;
+            sample_output_shapes = output_samples;
+        }
+        else if(samples != sample_shapes or output_samples != sample_output_shapes)
+        {
+            MIGRAPHX_THROW("Programs for batch size " + std::to_string(b.size) +
+                           " and " + std::to_string(buckets.front().size) +
+                           " differ in more than the batch");
+        }
+        b.prog = std::move(p);
+        buckets.push_back(std::move(b));
+    }
+
+    void check_request(const parameter_map& params) const
+    {
+        for(auto&& ps : sample_shapes)
+        {
+            if(not contains(params, ps.first))
+                MIGRAPHX_THROW("Missing parameter: " + ps.first);
+            const auto& s = params.at(ps.first).get_shape();
+            if(s != ps.second)
+                MIGRAPHX_THROW("Parameter " + ps.first + " should be " + to_string(ps.second) +
+                               " but is " + to_string(s));
+        }
+    }
+
+    std::future<std::vector<argument>> submit(parameter_map params)
+    {
+        check_request(params);
+        batch_request r;
+        r.params  = std::move(params);
+        r.arrival = std::chrono::steady_clock::now();
+        auto f    = r.result.get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            queue.push_back(std::move(r));
+        }
+        cv.notify_one();
+        return f;
+    }
+
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        for(;;)
+        {
+            cv.wait(lock, [&] { return stopped or not queue.empty(); });
+            if(queue.empty())
+                return;
+            // Wait for the batch to fill up, but no longer than the oldest request can wait
+            auto deadline = queue.front().arrival + options.max_latency;
+            cv.wait_until(
+                lock, deadline, [&] { return stopped or queue.size() >= options.max_batch; });
+            auto n = std::min(queue.size(), options.max_batch);
+            std::vector<batch_request> requests(std::make_move_iterator(queue.begin()),
+                                                std::make_move_iterator(queue.begin() + n));
+            queue.erase(queue.begin(), queue.begin() + n);
+            auto& b = this->get_bucket(n);
+            stats.requests += n;
+            stats.batches++;
+            stats.padding += b.size - n;
+            lock.unlock();
+            run_batch(b, requests);
+            lock.lock();
+        }
+    }
+
+    batch_bucket& get_bucket(std::size_t n)
+    {
+        return *std::find_if(
+            buckets.begin(), buckets.end(), [&](const auto& b) { return b.size >= n; });
+    }
+
+    static void run_batch(batch_bucket& b, std::vector<batch_request>& requests)
+    {
+        try
+        {
+            for(auto&& input : b.inputs)
+            {
+                auto* data       = input.second.data();
+                std::size_t slot = input.second.get_shape().bytes() / b.size;
+                for(std::size_t i = 0; i < requests.size(); i++)
+                    std::memcpy(data + i * slot, requests[i].params.at(input.first).data(), slot);
+                std::fill(data + requests.size() * slot, data + b.size * slot, 0);
+            }
+            auto outputs = b.session->eval(b.inputs);
+            for(std::size_t i = 0; i < requests.size(); i++)
+            {
+                std::vector<argument> results;
+                std::transform(
+                    outputs.begin(), outputs.end(), std::back_inserter(results), [&](auto&& out) {
+                        argument result{with_batch(out.get_shape(), 1)};
+                        auto slot = result.get_shape().bytes();
+                        std::memcpy(result.data(), out.data() + i * slot, slot);
+                        return result;
+                    });
+                requests[i].result.set_value(std::move(results));
+            }
+        }
+        catch(...)
+        {
+            for(auto&& r : requests)
+                r.result.set_exception(std::current_exception());
+        }
+    }
+
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopped = true;
+        }
+        cv.notify_one();
+        worker.join();
+    }
+};
+
+request_batcher::request_batcher(std::vector<program> programs, batcher_options options)
+    : impl(std::make_unique<request_batcher_impl>(std::move(programs), options))
+{
+}
+
+request_batcher::~request_batcher() { impl->stop(); }
+
+std::future<std::vector<argument>> request_batcher::submit(parameter_map params)
+{
+    return impl->submit(std::move(params));
+}
+
+std::vector<std::size_t> request_batcher::get_bucket_sizes() const
+{
+    std::vector<std::size_t> result;
+    std::transform(impl->buckets.begin(),
+                   impl->buckets.end(),
+                   std::back_inserter(result),
+                   [](const auto& b) { return b.size; });
+    return result;
+}
+
+std::unordered_map<std::string, shape> request_batcher::get_parameter_shapes() const
+{
+    return impl->sample_shapes;
+}
+
+batcher_stats request_batcher::get_stats() const
+{
+    std::lock_guard<std::mutex> lock(impl->mutex);
+    return impl->stats;
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -23,6 +23,7 @@
  */
 #include <migraphx/rewrite_rnn.hpp>
 #include <migraphx/program.hpp>
+#include <migraphx/pass_manager.hpp>
 #include <migraphx/instruction.hpp>
 #include <migraphx/op/add.hpp>
 #include <migraphx/op/broadcast.hpp>
@@ -49,14 +50,30 @@
 #include <migraphx/op/common.hpp>
 #include <migraphx/op/rnn_var_sl_last_output.hpp>
 #include <migraphx/op/rnn_variable_seq_lens.hpp>
+#include <numeric>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
-void rewrite_rnn::apply(module& m) const
+void rewrite_rnn::apply(module_pass_manager& mpm) const
 {
+    auto& m       = mpm.get_module();
+    std::size_t n = 0;
     for(auto ins : iterator_for(m))
     {
+        if(compact and contains({"rnn", "gru", "lstm"}, ins->name()))
+        {
+            auto args     = ins->inputs();
+            auto seq_lens = m.end();
+            if(args.size() >= 5 and args[4]->name() != "undefined")
+                seq_lens = args[4];
+            if(not is_variable_seq_lens(m, seq_lens))
+            {
+                apply_compact(mpm, ins, n++);
+                continue;
+            }
+        }
+
         if(ins->name() == "rnn")
         {
             apply_vanilla_rnn(m, ins);
@@ -1283,6 +1300,344 @@ std::vector<operation> rewrite_rnn::lstm_actv_funcs(instruction_ref ins) const
     }
 }
 
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+void rewrite_rnn::apply_compact(module_pass_manager& mpm, instruction_ref ins, std::size_t n) const
+{
+    auto& m         = mpm.get_module();
+    auto args       = ins->inputs();
+    const auto name = ins->name();
+    auto get_arg    = [&](std::size_t i) {
+        if(i < args.size() and args[i]->name() != "undefined")
+            return args[i];
+        return m.end();
+    };
+
+    // number of gates and activation functions for each direction
+    long num_gates          = 1;
+    std::size_t num_funcs   = 1;
+    op::rnn_direction dirct = op::rnn_direction::forward;
+    std::vector<operation> actv_funcs;
+    if(name == "rnn")
+    {
+        dirct      = any_cast<op::rnn>(ins->get_operator()).direction;
+        actv_funcs = vanilla_rnn_actv_funcs(ins);
+    }
+    else if(name == "gru")
+    {
+        dirct      = any_cast<op::gru>(ins->get_operator()).direction;
+        actv_funcs = gru_actv_funcs(ins);
+        num_gates  = 3;
+        num_funcs  = 2;
+    }
+    else
+    {
+        dirct      = any_cast<op::lstm>(ins->get_operator()).direction;
+        actv_funcs = lstm_actv_funcs(ins);
+        num_gates  = 4;
+        num_funcs  = 3;
+    }
+    bool is_lstm = name == "lstm";
+    bool is_gru_lbr =
+        name == "gru" and any_cast<op::gru>(ins->get_operator()).linear_before_reset != 0;
+
+    auto seq      = args[0];
+    auto bias     = get_arg(3);
+    auto seq_lens = get_arg(4);
+    auto ih       = get_arg(5);
+    auto ic       = is_lstm ? get_arg(6) : m.end();
+    auto pph      = is_lstm ? get_arg(7) : m.end();
+
+    shape seq_shape = seq->get_shape();
+    long hs         = args[2]->get_shape().lens()[2];
+    auto bs         = seq_shape.lens()[1];
+    auto input_size = seq_shape.lens()[2];
+    long seq_len    = get_seq_len(m, seq, seq_lens);
+    shape state_shape{seq_shape.type(), {bs, static_cast<std::size_t>(hs)}};
+    std::vector<float> state_data(state_shape.elements(), 0.0f);
+
+    bool bidirectional    = dirct == op::rnn_direction::bidirectional;
+    std::size_t num_dirct = bidirectional ? 2 : 1;
+    std::vector<int64_t> perm{1, 0};
+    // slice the direction from the weights and states, and squeeze them to 2 dimensions
+    auto get_dirct = [&](instruction_ref x, long d) {
+        if(bidirectional)
+            x = m.insert_instruction(
+                ins, make_op("slice", {{"axes", {0}}, {"starts", {d}}, {"ends", {d + 1}}}), x);
+        return m.insert_instruction(ins, make_op("squeeze", {{"axes", {0}}}), x);
+    };
+    auto make_contiguous = [&](instruction_ref x) {
+        if(x->get_shape().standard())
+            return x;
+        return m.insert_instruction(ins, make_op("contiguous"), x);
+    };
+
+    instruction_ref reverse_indices{};
+    if(dirct != op::rnn_direction::forward)
+    {
+        std::vector<int64_t> indices(seq_len);
+        std::iota(indices.rbegin(), indices.rend(), 0);
+        reverse_indices = m.add_literal(
+            literal{shape{shape::int64_type, {static_cast<std::size_t>(seq_len)}}, indices});
+    }
+    auto iter_num = m.add_literal(literal{shape{shape::int64_type}, {seq_len}});
+    auto cond     = m.add_literal(literal{shape{shape::bool_type}, {true}});
+
+    std::vector<instruction_ref> hidden_states;
+    std::vector<instruction_ref> last_hs_outputs;
+    std::vector<instruction_ref> last_cell_outputs;
+    for(std::size_t d = 0; d < num_dirct; d++)
+    {
+        bool is_forward = bidirectional ? d == 0 : dirct == op::rnn_direction::forward;
+
+        // the input sequence in the order it is processed
+        auto xs = seq;
+        if(not is_forward)
+            xs = m.insert_instruction(ins, make_op("gather", {{"axis", 0}}), seq, reverse_indices);
+        else if(seq_len < seq_shape.lens()[0])
+            xs = m.insert_instruction(
+                ins, make_op("slice", {{"axes", {0}}, {"starts", {0}}, {"ends", {seq_len}}}), seq);
+        xs = m.insert_instruction(
+            ins,
+            make_op("reshape", {{"dims", {seq_len * bs, input_size}}}),
+            make_contiguous(xs));
+
+        // the input does not depend on the hidden state, so the input weights are applied to
+        // all the time steps with a single gemm before the loop
+        auto w  = get_dirct(args[1], d);
+        auto tw = m.insert_instruction(ins, make_op("transpose", {{"permutation", perm}}), w);
+        auto r  = get_dirct(args[2], d);
+        auto tr = m.insert_instruction(ins, make_op("transpose", {{"permutation", perm}}), r);
+        auto xw = m.insert_instruction(ins, make_op("dot"), xs, tw);
+        xw      = m.insert_instruction(
+            ins, make_op("reshape", {{"dims", {seq_len, bs, num_gates * hs}}}), xw);
+
+        // the biases are added to the input projection, except the recurrent bias of gru with
+        // linear_before_reset, which is multiplied by the reset gate
+        instruction_ref bias_h = m.end();
+        if(bias != m.end())
+        {
+            auto b  = get_dirct(bias, d);
+            auto wb = m.insert_instruction(
+                ins,
+                make_op("slice", {{"axes", {0}}, {"starts", {0}}, {"ends", {num_gates * hs}}}),
+                b);
+            auto rb = m.insert_instruction(ins,
+                                           make_op("slice",
+                                                   {{"axes", {0}},
+                                                    {"starts", {num_gates * hs}},
+                                                    {"ends", {2 * num_gates * hs}}}),
+                                           b);
+            auto xb = wb;
+            if(is_gru_lbr)
+                bias_h = m.insert_instruction(
+                    ins,
+                    make_op("broadcast",
+                            {{"axis", 1}, {"out_lens", {bs, static_cast<std::size_t>(3 * hs)}}}),
+                    rb);
+            else
+                xb = m.insert_instruction(ins, make_op("add"), wb, rb);
+            xb = m.insert_instruction(
+                ins, make_op("broadcast", {{"axis", 2}, {"out_lens", xw->get_shape().lens()}}), xb);
+            xw = m.insert_instruction(ins, make_op("add"), xw, xb);
+        }
+
+        instruction_ref pph_dirct = m.end();
+        if(pph != m.end())
+            pph_dirct = get_dirct(pph, d);
+
+        std::vector<instruction_ref> initial_states{ih};
+        if(is_lstm)
+            initial_states.push_back(ic);
+        std::transform(initial_states.begin(),
+                       initial_states.end(),
+                       initial_states.begin(),
+                       [&](auto s) {
+                           if(s == m.end())
+                               return m.add_literal(literal{state_shape, state_data});
+                           return make_contiguous(get_dirct(s, d));
+                       });
+
+        auto* body = mpm.create_module(m.name() + ":" + name + std::to_string(n) +
+                                       (is_forward ? "_forward" : "_reverse"));
+        auto iter  = body->add_parameter("iter", shape{shape::int64_type});
+        auto bcond = body->add_parameter("cond", shape{shape::bool_type});
+        auto h     = body->add_parameter("hidden_state", state_shape);
+        auto c     = is_lstm ? body->add_parameter("cell_state", state_shape) : m.end();
+        auto xt    = body->add_instruction(make_op("gather", {{"axis", 0}}), xw, iter);
+
+        std::vector<operation> funcs(actv_funcs.begin() + d * num_funcs,
+                                     actv_funcs.begin() + (d + 1) * num_funcs);
+        auto states = compact_cell(m, *body, ins, {xt, tr, bias_h, pph_dirct, h, c}, funcs);
+        std::vector<instruction_ref> body_outputs{bcond};
+        body_outputs.insert(body_outputs.end(), states.begin(), states.end());
+        body_outputs.push_back(states.front());
+        body->add_return(body_outputs);
+
+        std::vector<instruction_ref> loop_args{iter_num, cond};
+        loop_args.insert(loop_args.end(), initial_states.begin(), initial_states.end());
+        auto rl = m.insert_instruction(
+            ins, make_op("loop", {{"max_iterations", seq_len}}), loop_args, {body});
+
+        auto get_output = [&](std::size_t i) {
+            return m.insert_instruction(ins, make_op("get_tuple_elem", {{"index", i}}), rl);
+        };
+        auto last_hs = get_output(0);
+        last_hs_outputs.push_back(
+            m.insert_instruction(ins, make_op("unsqueeze", {{"axes", {0}}}), last_hs));
+        if(is_lstm)
+        {
+            auto last_cell = get_output(1);
+            last_cell_outputs.push_back(
+                m.insert_instruction(ins, make_op("unsqueeze", {{"axes", {0}}}), last_cell));
+        }
+        auto hidden = get_output(states.size());
+        if(not is_forward)
+            hidden = m.insert_instruction(
+                ins, make_op("gather", {{"axis", 0}}), hidden, reverse_indices);
+        hidden_states.push_back(hidden);
+    }
+
+    instruction_ref last_hs_output{};
+    instruction_ref last_cell_output{};
+    if(bidirectional)
+    {
+        std::transform(hidden_states.begin(),
+                       hidden_states.end(),
+                       hidden_states.begin(),
+                       [&](auto hidden) {
+                           return m.insert_instruction(
+                               ins, make_op("unsqueeze", {{"axes", {1}}}), hidden);
+                       });
+        last_hs_output =
+            m.insert_instruction(ins, make_op("concat", {{"axis", 0}}), last_hs_outputs);
+        if(is_lstm)
+            last_cell_output =
+                m.insert_instruction(ins, make_op("concat", {{"axis", 0}}), last_cell_outputs);
+        m.replace_instruction(ins, make_op("concat", {{"axis", 1}}), hidden_states);
+    }
+    else
+    {
+        last_hs_output = last_hs_outputs.front();
+        if(is_lstm)
+            last_cell_output = last_cell_outputs.front();
+        m.replace_instruction(ins, make_op("unsqueeze", {{"axes", {1}}}), hidden_states.front());
+    }
+
+    // in case of all sequences are of the same lengths and shorter than the
+    // max sequence length, need to pad 0's at the end for output hidden states
+    auto hidden_state = pad_hidden_states(m, seq, seq_lens, ins);
+    ins               = replace_last_hs_output(m, hidden_state, seq_lens, last_hs_output, dirct);
+    if(is_lstm)
+        replace_last_cell_output(m, ins, seq_lens, last_cell_output, last_cell_output, dirct);
+}
+
+// The gates are sliced from the gemm results before the input and the hidden state are added,
+// so the whole update of the gates can be fused into one pointwise kernel.
+std::vector<instruction_ref>
+rewrite_rnn::compact_cell(const module& m,
+                          module& body,
+                          instruction_ref ins,
+                          std::vector<instruction_ref> inputs,
+                          const std::vector<operation>& actv_funcs) const
+{
+    assert(inputs.size() == 6);
+    auto xt     = inputs.at(0);
+    auto r      = inputs.at(1);
+    auto bias_h = inputs.at(2);
+    auto pph    = inputs.at(3);
+    auto h      = inputs.at(4);
+    auto c      = inputs.at(5);
+
+    auto state_lens = h->get_shape().lens();
+    long hs         = state_lens[1];
+    auto gate       = [&](instruction_ref x, long i) {
+        return body.add_instruction(
+            make_op("slice", {{"axes", {1}}, {"starts", {i * hs}}, {"ends", {(i + 1) * hs}}}), x);
+    };
+    auto add = [&](instruction_ref x, instruction_ref y) {
+        return body.add_instruction(make_op("add"), x, y);
+    };
+    auto mul = [&](instruction_ref x, instruction_ref y) {
+        return body.add_instruction(make_op("mul"), x, y);
+    };
+
+    if(ins->name() == "rnn")
+    {
+        auto hr = body.add_instruction(make_op("dot"), h, r);
+        return {body.add_instruction(actv_funcs.at(0), add(xt, hr))};
+    }
+    else if(ins->name() == "gru")
+    {
+        instruction_ref zt{};
+        instruction_ref rt{};
+        instruction_ref ht{};
+        if(any_cast<op::gru>(ins->get_operator()).linear_before_reset == 0)
+        {
+            // equation g(Xt*(Wh^T) + (rt (.) Ht-1)*(Rh^T) + Rbh + Wbh)
+            auto rzr = body.add_instruction(
+                make_op("slice", {{"axes", {1}}, {"starts", {0}}, {"ends", {2 * hs}}}), r);
+            auto rh = body.add_instruction(
+                make_op("slice", {{"axes", {1}}, {"starts", {2 * hs}}, {"ends", {3 * hs}}}), r);
+            auto hr = body.add_instruction(make_op("dot"), h, rzr);
+            zt      = body.add_instruction(actv_funcs.at(0), add(gate(xt, 0), gate(hr, 0)));
+            rt      = body.add_instruction(actv_funcs.at(0), add(gate(xt, 1), gate(hr, 1)));
+            auto hh = body.add_instruction(make_op("dot"), mul(rt, h), rh);
+            ht      = body.add_instruction(actv_funcs.at(1), add(gate(xt, 2), hh));
+        }
+        else
+        {
+            // equation ht = g(Xt*(Wh^T) + (rt (.) (Ht-1*(Rh^T) + Rbh)) + Wbh)
+            auto hr      = body.add_instruction(make_op("dot"), h, r);
+            auto hr_gate = [&](long i) {
+                if(bias_h == m.end())
+                    return gate(hr, i);
+                return add(gate(hr, i), gate(bias_h, i));
+            };
+            zt = body.add_instruction(actv_funcs.at(0), add(gate(xt, 0), hr_gate(0)));
+            rt = body.add_instruction(actv_funcs.at(0), add(gate(xt, 1), hr_gate(1)));
+            ht = body.add_instruction(actv_funcs.at(1), add(gate(xt, 2), mul(rt, hr_gate(2))));
+        }
+        // equation Ht = (1 - zt) (.) ht + zt (.) Ht-1
+        auto one = body.add_literal(literal{shape{h->get_shape().type()}, {1}});
+        one = body.add_instruction(make_op("multibroadcast", {{"out_lens", state_lens}}), one);
+        auto one_minus_zt = body.add_instruction(make_op("sub"), one, zt);
+        return {add(mul(one_minus_zt, ht), mul(zt, h))};
+    }
+
+    auto hr             = body.add_instruction(make_op("dot"), h, r);
+    auto it_before_actv = add(gate(xt, 0), gate(hr, 0));
+    auto ot_before_actv = add(gate(xt, 1), gate(hr, 1));
+    auto ft_before_actv = add(gate(xt, 2), gate(hr, 2));
+    auto ct_before_actv = add(gate(xt, 3), gate(hr, 3));
+    std::vector<instruction_ref> pph_gates;
+    if(pph != m.end())
+    {
+        for(long i = 0; i < 3; i++)
+        {
+            auto p = body.add_instruction(
+                make_op("slice", {{"axes", {0}}, {"starts", {i * hs}}, {"ends", {(i + 1) * hs}}}),
+                pph);
+            pph_gates.push_back(body.add_instruction(
+                make_op("broadcast", {{"axis", 1}, {"out_lens", state_lens}}), p));
+        }
+        it_before_actv = add(it_before_actv, mul(pph_gates[0], c));
+        ft_before_actv = add(ft_before_actv, mul(pph_gates[2], c));
+    }
+    auto it = body.add_instruction(actv_funcs.at(0), it_before_actv);
+    auto ft = body.add_instruction(actv_funcs.at(0), ft_before_actv);
+    auto ct = body.add_instruction(actv_funcs.at(1), ct_before_actv);
+
+    // equation Ct = ft (.) Ct-1 + it (.) ct
+    auto cellt = add(mul(ft, c), mul(it, ct));
+    if(pph != m.end())
+        ot_before_actv = add(ot_before_actv, mul(pph_gates[1], cellt));
+    auto ot = body.add_instruction(actv_funcs.at(0), ot_before_actv);
+
+    // Ht = ot (.) h(Ct)
+    auto ht = mul(ot, body.add_instruction(actv_funcs.at(2), cellt));
+    return {ht, cellt};
+}
+
 bool rewrite_rnn::is_variable_seq_lens(const module& m, instruction_ref seq_lens) const
 {
     bool is_var_lens = false;
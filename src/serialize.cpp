@@ -25,10 +25,168 @@
 #include <migraphx/argument.hpp>
 #include <migraphx/literal.hpp>
 #include <migraphx/context.hpp>
+#include <migraphx/tmp_dir.hpp>
+#include <mutex>
+#include <unordered_map>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
+static std::shared_ptr<char> read_section(const std::shared_ptr<char>& input,
+                                          std::size_t input_size,
+                                          std::size_t offset,
+                                          std::size_t nbytes)
+{
+    if(offset > input_size or nbytes > input_size - offset)
+        MIGRAPHX_THROW("Data section is too small: offset " + std::to_string(offset) + " with " +
+                       std::to_string(nbytes) + " bytes, but section has " +
+                       std::to_string(input_size) + " bytes");
+    return {input, input.get() + offset};
+}
+
+// Sections that are being read from, by id. Operators are deserialized with from_value, which has
+// no access to the section, so the raw data in their fields refers to the section by its id
+// instead. An id can only be resolved while its section is alive.
+struct section_registry
+{
+    struct buffer
+    {
+        std::shared_ptr<char> data;
+        std::size_t size = 0;
+    };
+    std::mutex mutex;
+    std::unordered_map<std::string, buffer> buffers;
+
+    static section_registry& get()
+    {
+        static section_registry r; // NOLINT
+        return r;
+    }
+
+    static std::shared_ptr<const std::string> add(std::shared_ptr<char> data, std::size_t size)
+    {
+        auto id = unique_string("data-section");
+        {
+            auto& r = get();
+            std::lock_guard<std::mutex> guard(r.mutex);
+            r.buffers[id] = {std::move(data), size};
+        }
+        return {new std::string(id), [](const std::string* p) { // NOLINT
+                    {
+                        auto& r = get();
+                        std::lock_guard<std::mutex> guard(r.mutex);
+                        r.buffers.erase(*p);
+                    }
+                    delete p; // NOLINT
+                }};
+    }
+
+    static std::shared_ptr<char>
+    read(const std::string& id, std::size_t offset, std::size_t nbytes)
+    {
+        buffer b;
+        {
+            auto& r = get();
+            std::lock_guard<std::mutex> guard(r.mutex);
+            auto it = r.buffers.find(id);
+            if(it == r.buffers.end())
+                MIGRAPHX_THROW("Raw data refers to a data section that is no longer available");
+            b = it->second;
+        }
+        return read_section(b.data, b.size, offset, nbytes);
+    }
+};
+
+data_section::data_section() : writable(true) {}
+
+data_section::data_section(std::shared_ptr<char> data, std::size_t size)
+    : input(std::move(data)), input_size(size), id(section_registry::add(input, input_size))
+{
+}
+
+bool data_section::is_writable() const { return writable; }
+
+const std::vector<char>& data_section::contents() const { return output; }
+
+std::size_t data_section::write(const char* data, std::size_t nbytes)
+{
+    assert(writable);
+    std::size_t offset = (output.size() + alignment - 1) / alignment * alignment;
+    output.resize(offset);
+    output.insert(output.end(), data, data + nbytes);
+    return offset;
+}
+
+std::shared_ptr<char> data_section::read(std::size_t offset, std::size_t nbytes) const
+{
+    return read_section(input, input_size, offset, nbytes);
+}
+
+// Raw data stored in a data section has its offset in the section instead of the data. The key
+// differs from "offset" so it isn't confused with the fields of operators like load.
+static bool is_section_raw_data(const value& v)
+{
+    return v.is_object() and v.contains("shape") and v.contains("data_offset");
+}
+
+static bool is_inline_raw_data(const value& v)
+{
+    return v.is_object() and v.contains("shape") and v.contains("data") and
+           v.at("data").is_binary();
+}
+
+value data_section::to_value(const literal& l)
+{
+    value result;
+    result["shape"]       = migraphx::to_value(l.get_shape());
+    result["data_offset"] = write(l.data(), l.get_shape().bytes());
+    return result;
+}
+
+literal data_section::literal_from_value(const value& v) const
+{
+    if(not is_section_raw_data(v))
+        return migraphx::from_value<literal>(v);
+    auto s = migraphx::from_value<shape>(v.at("shape"));
+    return literal(s, read(v.at("data_offset").to<std::size_t>(), s.bytes()));
+}
+
+void data_section::store(value& v)
+{
+    if(is_inline_raw_data(v))
+    {
+        const auto& data = v.at("data").get_binary();
+        value result;
+        result["shape"] = v.at("shape");
+        result["data_offset"] =
+            write(reinterpret_cast<const char*>(data.data()), data.size()); // NOLINT
+        v = result;
+        return;
+    }
+    if(not v.is_object() and not v.is_array())
+        return;
+    for(auto& x : v)
+        store(x);
+}
+
+void data_section::load(value& v) const
+{
+    if(is_section_raw_data(v))
+    {
+        // Check the bounds now rather than when the operator is created
+        auto s = migraphx::from_value<shape>(v.at("shape"));
+        read(v.at("data_offset").to<std::size_t>(), s.bytes());
+        if(id == nullptr)
+            MIGRAPHX_THROW("Data section has no data to load");
+        v["data_section"] = *id;
+        return;
+    }
+    if(not v.is_object() and not v.is_array())
+        return;
+    for(auto& x : v)
+        load(x);
+}
+
 template <class RawData>
 void raw_data_to_value(value& v, const RawData& rd)
 {
@@ -45,13 +203,25 @@ void migraphx_to_value(value& v, const literal& l) { raw_data_to_value(v, l); }
 void migraphx_from_value(const value& v, literal& l)
 {
     auto s = migraphx::from_value<shape>(v.at("shape"));
-    l      = literal(s, v.at("data").get_binary().data());
+    if(is_section_raw_data(v))
+    {
+        if(not v.contains("data_section"))
+            MIGRAPHX_THROW(
+                "Raw data is stored in a data section, but no data section is available");
+        // Share the section's buffer instead of copying the data
+        l = literal(s,
+                    section_registry::read(v.at("data_section").to<std::string>(),
+                                           v.at("data_offset").to<std::size_t>(),
+                                           s.bytes()));
+        return;
+    }
+    l = literal(s, v.at("data").get_binary().data());
 }
 
 void migraphx_to_value(value& v, const argument& a) { raw_data_to_value(v, a); }
 void migraphx_from_value(const value& v, argument& a)
 {
-    if(v.contains("data"))
+    if(v.contains("data") or is_section_raw_data(v))
     {
         literal l = migraphx::from_value<literal>(v);
         a         = l.get_argument();
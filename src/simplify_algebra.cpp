@@ -175,7 +175,7 @@ struct find_mul_slice_conv
         auto outputs = conv_ins->outputs();
         for(auto output : outputs)
             if(output != slice_ins)
-                instruction::replace_argument(output, conv_ins, new_conv);
+                m.replace_argument(output, conv_ins, new_conv);
     }
 };
 
@@ -371,6 +371,9 @@ struct find_concat_op
                    i->outputs().size() == i->outputs().size();
         };
         group_unique(ins->inputs().begin(), ins->inputs().end(), update_args, pred);
+        // Nothing could be moved before the concat
+        if(args == ins->inputs())
+            return;
         if(args.size() == 1)
             m.replace_instruction(ins, args.front());
         else
@@ -552,13 +555,13 @@ struct find_splits
                    }))
                     return;
 
-                for(auto data : data_args)
-                    m.move_instructions(data, ins);
-
                 auto slice_op = any_cast<op::slice>(splits.front()->get_operator());
                 assert(not slice_op.axes.empty());
                 if(slice_op.axes.size() > 1)
                     return;
+
+                for(auto data : data_args)
+                    m.move_instructions(data, ins);
                 auto concat_axis = slice_op.axes.front();
                 // TODO: Check if axises match
                 auto concat = m.insert_instruction(
@@ -1036,28 +1039,24 @@ struct find_split_transpose
 
 void simplify_algebra::apply(module& m) const
 {
-    // Run simplifications multiple times
-    for(int i = 0; i < 8; i++)
-    {
-        match::find_matches(m,
-                            find_inner_broadcast{},
-                            find_double_add_lit_broadcast{},
-                            find_add_lit_broadcast{},
-                            find_add_convs{},
-                            find_conv_dot_horiz_fusion{},
-                            find_mul_conv{},
-                            find_mul_slice_conv{},
-                            find_mul_add{},
-                            find_div_const{},
-                            find_sub_const{},
-                            find_rsqrt{},
-                            find_concat_op{},
-                            find_split_concat{},
-                            find_splits{},
-                            find_split_reshape{},
-                            find_split_transpose{});
-        dead_code_elimination{}.apply(m);
-    }
+    match::rewrite_matches(m,
+                           find_inner_broadcast{},
+                           find_double_add_lit_broadcast{},
+                           find_add_lit_broadcast{},
+                           find_add_convs{},
+                           find_conv_dot_horiz_fusion{},
+                           find_mul_conv{},
+                           find_mul_slice_conv{},
+                           find_mul_add{},
+                           find_div_const{},
+                           find_sub_const{},
+                           find_rsqrt{},
+                           find_concat_op{},
+                           find_split_concat{},
+                           find_splits{},
+                           find_split_reshape{},
+                           find_split_transpose{});
+    dead_code_elimination{}.apply(m);
 }
 
 } // namespace MIGRAPHX_INLINE_NS
@@ -35,6 +35,7 @@
 #include <migraphx/op/dot.hpp>
 #include <migraphx/op/quant_dot.hpp>
 #include <migraphx/register_op.hpp>
+#include <algorithm>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -45,7 +46,7 @@ std::unordered_set<std::string> get_quantizable_op_names()
     return s;
 }
 
-MIGRAPHX_PRED_MATCHER(has_same_value, instruction_ref ins)
+static bool all_same_value(instruction_ref ins)
 {
     if(ins->name() != "@literal")
         return false;
@@ -58,22 +59,51 @@ MIGRAPHX_PRED_MATCHER(has_same_value, instruction_ref ins)
     return all_same;
 }
 
+MIGRAPHX_PRED_MATCHER(has_same_value, instruction_ref ins) { return all_same_value(ins); }
+
+// The axis of the output channels of the weights, which are the second input, and of the output
+static std::pair<std::size_t, std::size_t> channel_axes(instruction_ref qop)
+{
+    if(qop->name() == "convolution")
+        return {0, 1};
+    auto n = qop->get_shape().lens().size();
+    return {n - 1, n - 1};
+}
+
+// The scale of each output channel when the scale of the weights only varies along the output
+// channels, or an empty vector otherwise
+static std::vector<double>
+weight_scales(instruction_ref qop, instruction_ref dq_scale, instruction_ref scale)
+{
+    std::vector<double> result;
+    auto axis           = channel_axes(qop).first;
+    const auto& s       = dq_scale->get_shape();
+    const auto& strides = s.strides();
+    if(s.lens()[axis] != scale->get_shape().elements() or strides[axis] != 1 or
+       std::count(strides.begin(), strides.end(), 0) != strides.size() - 1)
+        return result;
+    scale->get_literal().visit([&](auto x) { result.assign(x.begin(), x.end()); });
+    return result;
+}
+
 struct match_find_quantizable_ops
 {
 
-    static auto dequantizelinear_op(const std::string& name, const std::string& scale)
+    static auto dequantizelinear_op(const std::string& name,
+                                    const std::string& scale,
+                                    const std::string& zero_point)
     {
         return match::name("dequantizelinear")(
             match::arg(0)(match::skip(match::name("quantizelinear"))(match::any().bind(name))),
-            match::arg(1)(match::skip_broadcasts(has_same_value().bind(scale))),
-            match::arg(2)(match::skip_broadcasts(match::all_of(match::has_value(0)))));
+            match::arg(1)(match::skip_broadcasts(match::name("@literal").bind(scale))),
+            match::arg(2)(match::skip_broadcasts(has_same_value().bind(zero_point))));
     }
 
     auto matcher() const
     {
         return match::name(get_quantizable_op_names())(
-            match::arg(0)(dequantizelinear_op("x1", "scale1")),
-            match::arg(1)(dequantizelinear_op("x2", "scale2")));
+            match::arg(0)(dequantizelinear_op("x1", "scale1", "zp1")),
+            match::arg(1)(dequantizelinear_op("x2", "scale2", "zp2")));
     }
 
     void apply(module& m, const match::matcher_result& r) const
@@ -83,39 +113,96 @@ struct match_find_quantizable_ops
         auto q2     = r.instructions["x2"];
         auto scale1 = r.instructions["scale1"];
         auto scale2 = r.instructions["scale2"];
+        auto zp1    = r.instructions["zp1"];
+        auto zp2    = r.instructions["zp2"];
 
-        // Only INT8 type currently supported
-        if(q1->get_shape().type() != migraphx::shape::int8_type or
-           q2->get_shape().type() != migraphx::shape::int8_type)
+        // The weights have to be symmetric int8, while the first input can also be uint8 with
+        // a zero point
+        if(q2->get_shape().type() != migraphx::shape::int8_type or
+           not contains({migraphx::shape::int8_type, migraphx::shape::uint8_type},
+                        q1->get_shape().type()))
+            return;
+        if(not all_same_value(scale1) or
+           zp2->get_literal().at<int64_t>() != 0)
             return;
 
-        double scale;
-        visit_all(scale1->get_literal(), scale2->get_literal())(
-            [&](const auto s1, const auto s2) { scale = s1.front() * s2.front(); });
+        // A scale per output channel of the weights
+        std::vector<double> scales;
+        if(all_same_value(scale2))
+            scales = {scale2->get_literal().at<double>()};
+        else
+            scales = weight_scales(qop, qop->inputs()[1]->inputs()[1], scale2);
+        if(scales.empty())
+            return;
+        auto s1 = scale1->get_literal().at<double>();
+        std::transform(
+            scales.begin(), scales.end(), scales.begin(), [&](auto s2) { return s1 * s2; });
 
-        auto qop_args  = qop->inputs();
-        qop_args.at(0) = q1;
-        qop_args.at(1) = q2;
-        instruction_ref dq;
-        instruction_ref dq_scale;
-        instruction_ref zero_point;
-        if(qop->name() == "convolution")
+        int64_t zero_point = zp1->get_literal().at<int64_t>();
+        auto qop_args      = qop->inputs();
+        qop_args.at(0)     = q1;
+        qop_args.at(1)     = q2;
+        if(q1->get_shape().type() == migraphx::shape::uint8_type)
         {
-            auto conv_val = qop->get_operator().to_value();
-            dq            = m.insert_instruction(
-                qop, migraphx::make_op("quant_convolution", conv_val), qop_args);
+            if(q1->name() != "quantizelinear")
+                return;
+            // Shift to int8 so the quantized operators can be used
+            zero_point -= 128;
+            auto lens = q1->get_shape().lens();
+            auto zp   = m.add_literal(static_cast<int8_t>(zero_point));
+            zp = m.insert_instruction(qop, make_op("multibroadcast", {{"out_lens", lens}}), zp);
+            auto q1_inputs = q1->inputs();
+            q1_inputs.resize(3);
+            q1_inputs.at(2) = zp;
+            qop_args.at(0)  = m.insert_instruction(qop, q1->get_operator(), q1_inputs);
         }
-        else if(qop->name() == "dot")
+
+        auto quant_op = [&](const std::vector<instruction_ref>& args) {
+            if(qop->name() == "convolution")
+            {
+                auto conv_val = qop->get_operator().to_value();
+                return m.insert_instruction(
+                    qop, migraphx::make_op("quant_convolution", conv_val), args);
+            }
+            return m.insert_instruction(qop, migraphx::make_op("quant_dot"), args);
+        };
+        auto dq       = quant_op(qop_args);
+        auto lens     = dq->get_shape().lens();
+        auto ins_type = qop->get_shape().type();
+
+        if(zero_point != 0)
         {
-            dq = m.insert_instruction(qop, migraphx::make_op("quant_dot"), qop_args);
+            // Subtract the zero point times the sum of the weights that each output uses, which
+            // is computed by applying the operator to ones so that it folds to a constant
+            auto ones_lens = qop_args.at(0)->get_shape().lens();
+            ones_lens.at((qop->name() == "convolution") ? 0 : ones_lens.size() - 2) = 1;
+            shape ones_s{shape::int8_type, ones_lens};
+            auto ones = m.add_literal(literal{ones_s, std::vector<int8_t>(ones_s.elements(), 1)});
+            auto corr = quant_op({ones, q2});
+            auto zp   = m.add_literal(literal{{corr->get_shape().type()}, {zero_point}});
+            zp        = m.insert_instruction(
+                qop, make_op("multibroadcast", {{"out_lens", corr->get_shape().lens()}}), zp);
+            corr = m.insert_instruction(qop, make_op("mul"), corr, zp);
+            corr = m.insert_instruction(qop, make_op("multibroadcast", {{"out_lens", lens}}), corr);
+            dq   = m.insert_instruction(qop, make_op("sub"), dq, corr);
         }
-        auto ins_type = qop->get_shape().type();
-        dq_scale      = m.add_literal(literal({ins_type}, {scale}));
 
-        auto lens = dq->get_shape().lens();
-        auto scale_mb =
-            m.insert_instruction(qop, make_op("multibroadcast", {{"out_lens", lens}}), dq_scale);
-        dq = m.insert_instruction(qop, make_op("dequantizelinear"), dq, scale_mb);
+        instruction_ref dq_scale;
+        if(scales.size() == 1)
+        {
+            dq_scale = m.add_literal(literal({ins_type}, scales));
+            dq_scale = m.insert_instruction(
+                qop, make_op("multibroadcast", {{"out_lens", lens}}), dq_scale);
+        }
+        else
+        {
+            dq_scale = m.add_literal(literal({ins_type, {scales.size()}}, scales));
+            dq_scale = m.insert_instruction(
+                qop,
+                make_op("broadcast", {{"axis", channel_axes(qop).second}, {"out_lens", lens}}),
+                dq_scale);
+        }
+        dq = m.insert_instruction(qop, make_op("dequantizelinear"), dq, dq_scale);
         m.replace_instruction(qop, dq);
     }
 };
@@ -160,7 +247,7 @@ void remove_qdq_pairs(module& m)
                    compare_literals(arg->inputs().at(1), q->inputs().at(1)) and
                    compare_literals(arg->inputs().at(2), q->inputs().at(2)))
                 {
-                    instruction::replace_argument(ins, arg, q->inputs().front());
+                    m.replace_argument(ins, arg, q->inputs().front());
                 }
             }
         }
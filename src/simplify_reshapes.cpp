@@ -666,23 +666,20 @@ struct find_slice_transpose
 
 void simplify_reshapes::apply(module& m) const
 {
-    for(int i = 0; i < 2; i++)
-    {
-        match::find_matches(m,
-                            find_where_op{},
-                            find_resize{},
-                            find_reshape_cont{},
-                            find_nop_reshapes{},
-                            find_reshaper{},
-                            find_transpose{},
-                            find_concat_transpose{},
-                            find_nested_convert{},
-                            find_nested_slice{},
-                            find_nested_concat{},
-                            find_slice_transpose{},
-                            find_transpose_contiguous_reshaper_unary{});
-        dead_code_elimination{}.apply(m);
-    }
+    match::rewrite_matches(m,
+                           find_where_op{},
+                           find_resize{},
+                           find_reshape_cont{},
+                           find_nop_reshapes{},
+                           find_reshaper{},
+                           find_transpose{},
+                           find_concat_transpose{},
+                           find_nested_convert{},
+                           find_nested_slice{},
+                           find_nested_concat{},
+                           find_slice_transpose{},
+                           find_transpose_contiguous_reshaper_unary{});
+    dead_code_elimination{}.apply(m);
 }
 
 } // namespace MIGRAPHX_INLINE_NS
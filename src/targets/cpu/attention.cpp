@@ -0,0 +1,178 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/config.hpp>
+#include <migraphx/context.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/check_shapes.hpp>
+#include <migraphx/register_op.hpp>
+#include <migraphx/reflect.hpp>
+#include <cmath>
+#include <limits>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+/**
+ * softmax(q * k * scale + mask) * v over the last two dimensions. The keys are processed a tile
+ * at a time with a running maximum and sum for the softmax, so only a tile of the scores is ever
+ * stored. The inputs can have any strides, so a transposed k or a broadcast mask is read directly.
+ */
+struct cpu_attention : auto_register_op<cpu_attention>
+{
+    static constexpr std::size_t tile = 64;
+
+    float scale = 1.0f;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.scale, "scale"));
+    }
+
+    std::string name() const { return "cpu::attention"; }
+
+    shape compute_shape(std::vector<shape> inputs) const
+    {
+        // Compensate for allocation
+        inputs.pop_back();
+        check_shapes{inputs, *this}.has(3, 4).same_type().same_ndims();
+        const auto& q = inputs[0].lens();
+        const auto& k = inputs[1].lens();
+        const auto& v = inputs[2].lens();
+        auto n        = q.size();
+        if(n < 2 or q[n - 1] != k[n - 2] or k[n - 1] != v[n - 2] or
+           not std::equal(q.begin(), q.end() - 2, k.begin()) or
+           not std::equal(q.begin(), q.end() - 2, v.begin()))
+        {
+            MIGRAPHX_THROW("ATTENTION: mismatched dimensions: {" + to_string_range(q) + "}, {" +
+                           to_string_range(k) + "}, {" + to_string_range(v) + "}");
+        }
+        auto scores_lens   = q;
+        scores_lens.back() = k.back();
+        if(inputs.size() == 4 and inputs[3].lens() != scores_lens)
+            MIGRAPHX_THROW("ATTENTION: mask does not match the scores");
+        auto out_lens   = q;
+        out_lens.back() = v.back();
+        return {inputs[0].type(), out_lens};
+    }
+
+    // Offset of the start of a matrix in the batch
+    static std::size_t batch_offset(const shape& s, const shape& batch, std::size_t i)
+    {
+        auto idx = batch.multi(i);
+        return std::inner_product(idx.begin(), idx.end(), s.strides().begin(), std::size_t{0});
+    }
+
+    argument
+    compute(context& ctx, const shape& output_shape, const std::vector<argument>& args) const
+    {
+        const auto& out_lens = output_shape.lens();
+        auto n               = out_lens.size();
+        std::vector<shape> shapes;
+        std::transform(args.begin(), args.end(), std::back_inserter(shapes), [](const auto& a) {
+            return a.get_shape();
+        });
+        shape batch{shape::float_type, {out_lens.begin(), out_lens.end() - 2}};
+        auto seq_q    = out_lens[n - 2];
+        auto dv       = out_lens[n - 1];
+        auto d        = shapes[0].lens()[n - 1];
+        auto seq_k    = shapes[1].lens()[n - 1];
+        bool has_mask = args.size() == 5;
+        // Stride of the rows (dim 0) or the columns (dim 1) of an input
+        auto stride = [&](std::size_t a, std::size_t dim) {
+            return shapes[a].strides()[n - 2 + dim];
+        };
+        const auto* q_ptr    = args[0].cast<float>();
+        const auto* k_ptr    = args[1].cast<float>();
+        const auto* v_ptr    = args[2].cast<float>();
+        const auto* mask_ptr = has_mask ? args[3].cast<float>() : nullptr;
+        auto* out_ptr        = args.back().cast<float>();
+        ctx.bulk_execute(seq_q * (n > 2 ? batch.elements() : 1), 1, [&](auto start, auto end) {
+            std::vector<float> scores(tile);
+            std::vector<float> acc(dv);
+            for(auto i = start; i < end; i++)
+            {
+                auto b      = i / seq_q;
+                auto row    = i % seq_q;
+                auto offset = [&](std::size_t a) {
+                    return (n == 2) ? 0 : batch_offset(shapes[a], batch, b);
+                };
+                const auto* q = q_ptr + offset(0) + row * stride(0, 0);
+                const auto* k = k_ptr + offset(1);
+                const auto* v = v_ptr + offset(2);
+                const auto* mask =
+                    has_mask ? mask_ptr + offset(3) + row * stride(3, 0) : nullptr;
+                float max_score = std::numeric_limits<float>::lowest();
+                float sum       = 0;
+                std::fill(acc.begin(), acc.end(), 0.0f);
+                for(std::size_t first = 0; first < seq_k; first += tile)
+                {
+                    auto count     = std::min(tile, seq_k - first);
+                    float tile_max = std::numeric_limits<float>::lowest();
+                    for(std::size_t j = 0; j < count; j++)
+                    {
+                        const auto* kj = k + (first + j) * stride(1, 1);
+                        float s        = 0;
+                        for(std::size_t x = 0; x < d; x++)
+                            s += q[x * stride(0, 1)] * kj[x * stride(1, 0)];
+                        s *= scale;
+                        if(has_mask)
+                            s += mask[(first + j) * stride(3, 1)];
+                        scores[j] = s;
+                        tile_max  = std::max(tile_max, s);
+                    }
+                    // Rescale what has been accumulated so far to the new maximum
+                    auto new_max = std::max(max_score, tile_max);
+                    auto factor  = std::exp(max_score - new_max);
+                    sum *= factor;
+                    for(auto& y : acc)
+                        y *= factor;
+                    for(std::size_t j = 0; j < count; j++)
+                    {
+                        auto p = std::exp(scores[j] - new_max);
+                        sum += p;
+                        const auto* vj = v + (first + j) * stride(2, 0);
+                        for(std::size_t y = 0; y < dv; y++)
+                            acc[y] += p * vj[y * stride(2, 1)];
+                    }
+                    max_score = new_max;
+                }
+                auto* out = out_ptr + i * dv;
+                for(std::size_t y = 0; y < dv; y++)
+                    out[y] = acc[y] / sum;
+            }
+        });
+        return args.back();
+    }
+
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return shapes.size() - 1;
+    }
+};
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
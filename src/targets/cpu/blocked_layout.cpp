@@ -0,0 +1,161 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/cpu/blocked_layout.hpp>
+#include <migraphx/cpu/dnnl.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/serialize.hpp>
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+// Grouped convolutions are left alone, since their channels per group don't have to be a
+// multiple of the block
+static bool is_blocked_op(instruction_ref ins)
+{
+    if(ins->name() == "dnnl::convolution")
+        return ins->get_operator().to_value().at("group").to<int>() == 1;
+    return ins->name() == "dnnl::pooling";
+}
+
+static bool has_binary_post_ops(instruction_ref ins)
+{
+    auto v = ins->get_operator().to_value();
+    return std::any_of(v.at("post_ops").begin(), v.at("post_ops").end(), [](const auto& po) {
+        return contains(po.at("algo").template to<std::string>(), "binary");
+    });
+}
+
+static bool can_block(const shape& s, std::size_t block)
+{
+    auto n = s.lens().size();
+    return s.type() == shape::float_type and s.standard() and n >= 3 and n <= 5 and
+           s.lens()[1] % block == 0;
+}
+
+// The input is only used as the source, since the binary post ops and the weights are always
+// read in the plain layout
+static bool can_read_blocked(instruction_ref ins, std::size_t block)
+{
+    if(not is_blocked_op(ins))
+        return false;
+    auto input = ins->inputs().front();
+    return can_block(input->get_shape(), block) and
+           std::count(ins->inputs().begin(), ins->inputs().end(), input) == 1;
+}
+
+// The binary post ops would need to be blocked the same as the output
+static bool can_write_blocked(instruction_ref ins, std::size_t block)
+{
+    return is_blocked_op(ins) and can_block(ins->get_shape(), block) and
+           ins->inputs().back()->name() == "cpu::allocate" and not has_binary_post_ops(ins);
+}
+
+void blocked_layout::apply(module& m) const
+{
+    auto b = (block == 0) ? dnnl_preferred_block() : block;
+    if(b == 0)
+        return;
+
+    // An output is worth blocking when a convolution reads it, either directly or through
+    // poolings that keep it blocked
+    std::unordered_set<instruction_ref> wanted;
+    for(auto ins : reverse_iterator_for(m))
+    {
+        if(not can_write_blocked(ins, b))
+            continue;
+        if(std::any_of(ins->outputs().begin(), ins->outputs().end(), [&](auto output) {
+               return output->inputs().front() == ins and can_read_blocked(output, b) and
+                      (output->name() == "dnnl::convolution" or contains(wanted, output));
+           }))
+            wanted.insert(ins);
+    }
+
+    // Pooling keeps the layout of its input, while a convolution can change it
+    std::unordered_set<instruction_ref> blocked;
+    for(auto ins : iterator_for(m))
+    {
+        if(not can_write_blocked(ins, b))
+            continue;
+        if(ins->name() == "dnnl::pooling")
+        {
+            if(can_read_blocked(ins, b) and contains(blocked, ins->inputs().front()))
+                blocked.insert(ins);
+        }
+        else if(contains(wanted, ins))
+        {
+            blocked.insert(ins);
+        }
+    }
+    if(blocked.empty())
+        return;
+
+    // The blocked version of each instruction that has been replaced by a reorder to the plain
+    // layout
+    std::unordered_map<instruction_ref, instruction_ref> blocked_inputs;
+    std::vector<instruction_ref> instructions;
+    for(auto ins : iterator_for(m))
+        instructions.push_back(ins);
+    for(auto ins : instructions)
+    {
+        auto inputs = ins->inputs();
+        // A pooling only reads the blocked layout when it writes it too
+        bool reads = not inputs.empty() and can_read_blocked(ins, b) and
+                     contains(blocked_inputs, inputs.front()) and
+                     (ins->name() != "dnnl::pooling" or contains(blocked, ins));
+        if(reads)
+            inputs.front() = blocked_inputs.at(inputs.front());
+        if(contains(blocked, ins))
+        {
+            auto s            = to_blocked_shape(ins->get_shape(), b);
+            auto v            = ins->get_operator().to_value();
+            v["output_block"] = b;
+            inputs.back() =
+                m.insert_instruction(ins, make_op("cpu::allocate", {{"shape", to_value(s)}}));
+            auto blocked_ins = m.insert_instruction(ins, make_op(ins->name(), v), inputs);
+            // Any operator that reads the plain layout gets a copy, which is removed when there
+            // are none
+            auto alloc = m.insert_instruction(
+                ins, make_op("cpu::allocate", {{"shape", to_value(ins->get_shape())}}));
+            auto plain = m.insert_instruction(ins, make_op("dnnl::reorder"), blocked_ins, alloc);
+            m.replace_instruction(ins, plain);
+            blocked_inputs[plain] = blocked_ins;
+        }
+        else if(reads)
+        {
+            m.replace_instruction(ins, ins->get_operator(), inputs);
+        }
+    }
+}
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
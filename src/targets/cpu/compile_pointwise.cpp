@@ -0,0 +1,336 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/cpu/compile_pointwise.hpp>
+#include <migraphx/cpu/code_object_op.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/cpu/device_name.hpp>
+#include <migraphx/compile_src.hpp>
+#include <migraphx/cpp_generator.hpp>
+#include <migraphx/dead_code_elimination.hpp>
+#include <migraphx/eliminate_common_subexpression.hpp>
+#include <migraphx/env.hpp>
+#include <migraphx/file_buffer.hpp>
+#include <migraphx/filesystem.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/pass_manager.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/reduce_dims.hpp>
+#include <migraphx/stringutils.hpp>
+#include <functional>
+#include <random>
+#include <sstream>
+
+#ifndef MIGRAPHX_CPU_JIT_COMPILER
+#define MIGRAPHX_CPU_JIT_COMPILER "c++"
+#endif
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_CPU_JIT_CACHE_DIR)
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_CPU_JIT_DISABLE_CACHE)
+
+// The kernel is self-contained so it can be compiled without the migraphx headers
+static const char* const pointwise_kernel = R"__migraphx__(
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace migraphx {
+
+#ifdef __FLT16_MAX__
+using half = _Float16;
+inline float promote(half x) { return x; }
+#endif
+
+template <class T>
+T promote(T x)
+{
+    return x;
+}
+
+#define MIGRAPHX_CPU_MATH(name)                  \
+    template <class... Ts>                       \
+    auto name(Ts... xs)                          \
+    {                                            \
+        return std::name(promote(xs)...);        \
+    }
+
+MIGRAPHX_CPU_MATH(acos)
+MIGRAPHX_CPU_MATH(acosh)
+MIGRAPHX_CPU_MATH(asin)
+MIGRAPHX_CPU_MATH(asinh)
+MIGRAPHX_CPU_MATH(atan)
+MIGRAPHX_CPU_MATH(atanh)
+MIGRAPHX_CPU_MATH(ceil)
+MIGRAPHX_CPU_MATH(cos)
+MIGRAPHX_CPU_MATH(cosh)
+MIGRAPHX_CPU_MATH(erf)
+MIGRAPHX_CPU_MATH(exp)
+MIGRAPHX_CPU_MATH(floor)
+MIGRAPHX_CPU_MATH(isnan)
+MIGRAPHX_CPU_MATH(log)
+MIGRAPHX_CPU_MATH(pow)
+MIGRAPHX_CPU_MATH(round)
+MIGRAPHX_CPU_MATH(sin)
+MIGRAPHX_CPU_MATH(sinh)
+MIGRAPHX_CPU_MATH(sqrt)
+MIGRAPHX_CPU_MATH(tan)
+MIGRAPHX_CPU_MATH(tanh)
+
+template <class T>
+auto abs(T x)
+{
+    if constexpr(std::is_unsigned<T>{})
+        return x;
+    else
+        return std::abs(promote(x));
+}
+
+template <class T>
+auto rsqrt(T x)
+{
+    return 1 / std::sqrt(promote(x));
+}
+
+template <class T, class U>
+auto max(T x, U y)
+{
+    return x < y ? y : x;
+}
+
+template <class T, class U>
+auto min(T x, U y)
+{
+    return y < x ? y : x;
+}
+
+template <class T, class U>
+T convert(U x)
+{
+    return static_cast<T>(x);
+}
+
+${preamble}
+
+extern "C" void ${kernel}(void** params, std::size_t start, std::size_t end)
+{
+${params}
+    for(std::size_t i = start; i < end;)
+    {
+        const std::size_t outer = i / ${inner};
+        const std::size_t first = i - outer * ${inner};
+        const std::size_t last  = std::min<std::size_t>(${inner}, first + (end - i));
+${offsets}
+        for(std::size_t j = first; j < last; j++)
+            ${store} = convert<${output_type}>(${function}(${loads}));
+        i += last - first;
+    }
+}
+
+} // namespace migraphx
+
+)__migraphx__";
+
+static std::vector<std::string> get_op_names(const module& m)
+{
+    std::vector<std::string> result;
+    for(auto& ins : m)
+    {
+        if(starts_with(ins.name(), "@"))
+            continue;
+        result.push_back(ins.name());
+    }
+    return result;
+}
+
+static std::string make_identifier(const std::string& s)
+{
+    return transform_string(s, [](char c) {
+        if(with_char(::isalnum)(c) or c == '_')
+            return c;
+        return '_';
+    });
+}
+
+// The offset of the element at `j` in the inner dimension of the tensor
+static std::string
+index_tensor(const std::string& name, const shape& s, std::size_t i, std::stringstream& offsets)
+{
+    const auto& lens    = s.lens();
+    const auto& strides = s.strides();
+    std::vector<std::string> terms;
+    for(std::size_t d = 0; d + 1 < lens.size(); d++)
+    {
+        if(lens[d] == 1 or strides[d] == 0)
+            continue;
+        terms.push_back("idx" + std::to_string(d) + " * " + std::to_string(strides[d]));
+    }
+    std::string offset = "o" + std::to_string(i);
+    offsets << "        const std::size_t " << offset << " = "
+            << (terms.empty() ? "0" : join_strings(terms, " + ")) << ";\n";
+    return name + "[" + offset + " + j * " + std::to_string(strides.back()) + "]";
+}
+
+static std::string generate_kernel(const std::vector<shape>& inputs,
+                                   const std::string& kernel,
+                                   const std::string& function,
+                                   const std::string& preamble)
+{
+    auto rinputs = reduce_dims(inputs);
+    if(rinputs.size() != inputs.size())
+        rinputs = inputs;
+    const auto& lens = rinputs.back().lens();
+    std::stringstream params;
+    std::stringstream offsets;
+    // Multi-index of the outer dimensions, which is constant across the inner loop
+    std::size_t stride = 1;
+    for(std::size_t d = lens.size() - 1; d > 0; d--)
+    {
+        auto dim = d - 1;
+        offsets << "        const std::size_t idx" << dim << " = (outer / " << stride << ")";
+        if(dim > 0)
+            offsets << " % " << lens[dim];
+        offsets << ";\n";
+        stride *= lens[dim];
+    }
+    std::vector<std::string> loads;
+    for(std::size_t i = 0; i < rinputs.size(); i++)
+    {
+        const auto& s    = rinputs[i];
+        bool is_output   = i == rinputs.size() - 1;
+        std::string name = is_output ? "out" : "x" + std::to_string(i);
+        std::string type = shape::cpp_type(s.type());
+        // No restrict qualifiers since the memory planner can place the output over an input
+        params << "    auto* " << name << " = static_cast<"
+               << (is_output ? "" : "const ") << type << "*>(params[" << i << "]);\n";
+        loads.push_back(index_tensor(name, s, i, offsets));
+    }
+    // The output is the last tensor
+    auto store = loads.back();
+    loads.pop_back();
+    return interpolate_string(pointwise_kernel,
+                              {{"preamble", preamble},
+                               {"kernel", kernel},
+                               {"params", params.str()},
+                               {"inner", std::to_string(lens.back())},
+                               {"offsets", offsets.str()},
+                               {"store", store},
+                               {"output_type", shape::cpp_type(rinputs.back().type())},
+                               {"function", function},
+                               {"loads", join_strings(loads, ", ")}});
+}
+
+static fs::path get_cache_dir()
+{
+    auto dir = string_value_of(MIGRAPHX_CPU_JIT_CACHE_DIR{});
+    if(dir.empty())
+        return fs::temp_directory_path() / "migraphx-cpu-jit";
+    return dir;
+}
+
+// Write to a temporary file first so other processes never see a partial file
+static void write_atomic(const fs::path& p, const char* buffer, std::size_t size)
+{
+    auto tmp = p;
+    tmp += "." + std::to_string(std::random_device{}()) + ".tmp";
+    write_buffer(tmp.string(), buffer, size);
+    fs::rename(tmp, p);
+}
+
+// Compiled kernels are cached on disk keyed by a hash of the source, the compiler options and the
+// host cpu, since -march=native ties the library to it. The source is stored next to the library
+// and compared when loading to rule out collisions.
+static std::vector<char> compile_cached(const src_compiler& compiler, const std::string& src)
+{
+    auto compile = [&] {
+        return compiler.compile({src_file{fs::path{"pointwise.cpp"},
+                                          std::make_pair(src.data(), src.data() + src.size())}});
+    };
+    if(enabled(MIGRAPHX_CPU_JIT_DISABLE_CACHE{}))
+        return compile();
+    auto key      = std::to_string(std::hash<std::string>{}(
+        compiler.compiler + " " + compiler.flags + "\n" + get_device_name() + "\n" + src));
+    auto dir      = get_cache_dir();
+    auto lib_path = dir / (key + ".so");
+    auto src_path = dir / (key + ".cpp");
+    std::error_code ec;
+    if(fs::exists(src_path, ec) and fs::exists(lib_path, ec) and
+       read_string(src_path.string()) == src)
+        return read_buffer(lib_path.string());
+    auto image = compile();
+    // A cache that can't be written to is not an error
+    try
+    {
+        fs::create_directories(dir);
+        write_atomic(lib_path, image.data(), image.size());
+        // The source is written last since it marks the entry as complete
+        write_atomic(src_path, src.data(), src.size());
+    }
+    catch(const std::exception&)
+    {
+    }
+    return image;
+}
+
+operation compile_pointwise(const std::vector<shape>& inputs, module& m)
+{
+    run_passes(m, {eliminate_common_subexpression{}, dead_code_elimination{}});
+    cpp_generator g;
+    g.fmap([](const std::string& fname) { return "migraphx::" + fname; });
+    g.add_point_op("where", "(${0} ? ${1} : ${2})");
+    g.add_point_op("prelu", "(${0} < 0 ? ${0} * ${1} : ${0})");
+    // Add explict conversions
+    g.fresult(
+        [](const shape& s) { return "migraphx::convert<" + shape::cpp_type(s.type()) + ">"; });
+    auto f = g.generate_module(m).set_generic_types(m);
+    f.set_name(make_identifier(m.name()));
+    auto function = g.create_function(f.set_attributes({"static", "inline"}));
+
+    auto op_names = get_op_names(m);
+    op_names.push_back("kernel");
+    auto kernel = make_identifier(join_strings(op_names, "_"));
+    auto src    = generate_kernel(inputs, kernel, function, g.str());
+
+    src_compiler compiler;
+    compiler.compiler = MIGRAPHX_CPU_JIT_COMPILER;
+    compiler.flags    = "-std=c++17 -O3 -march=native -fPIC -shared -fno-math-errno -w";
+    compiler.output   = "pointwise.so";
+
+    code_object_op op;
+    op.code_object     = value::binary{compile_cached(compiler, src)};
+    op.symbol_name     = kernel;
+    op.expected_inputs = inputs;
+    op.output          = inputs.back();
+    op.pointwise       = true;
+    return op;
+}
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -30,30 +30,46 @@
 #include <migraphx/cpu/dnnl.hpp>
 #include <migraphx/op/convolution.hpp>
 #include <migraphx/op/quant_convolution.hpp>
+#include <memory>
+#include <mutex>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 namespace cpu {
 
-struct dnnl_convolution
-    : dnnl_extend_op<dnnl_convolution, dnnl::convolution_forward, op::convolution>
+template <class Derived, class Op>
+struct dnnl_convolution_base : dnnl_blocked_op<Derived, dnnl::convolution_forward, Op>
 {
+    using base = dnnl_blocked_op<Derived, dnnl::convolution_forward, Op>;
+    // Set by write_literals when the weights are a constant, so they can be
+    // reordered once into the layout preferred by the primitive
+    bool prepack_weights = false;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack_join(base::reflect(self, f),
+                         pack(f(self.prepack_weights, "prepack_weights")));
+    }
+
     std::vector<int> arg_map(int) const
     {
         return {MIGRAPHX_DNNL_PREFIX(ARG_SRC), MIGRAPHX_DNNL_PREFIX(ARG_WEIGHTS)};
     }
 
+    std::size_t kdims() const { return this->op.kdims(); }
+
     shape adjust_shape(const shape& x, int i) const
     {
-        auto s = base_adjust_shape(x);
-        if(i == 1 and op.group > 1)
+        auto s = this->base_adjust_shape(x);
+        if(i == 1 and this->op.group > 1)
         {
             // TODO: Add support for transposed weights
             if(not s.standard())
                 MIGRAPHX_THROW("Weights for grouped convolution must be standard");
             auto lens = s.lens();
-            lens.insert(lens.begin(), op.group);
-            lens.at(1) /= op.group;
+            lens.insert(lens.begin(), this->op.group);
+            lens.at(1) /= this->op.group;
             return shape{s.type(), lens};
         }
         return s;
@@ -62,6 +78,7 @@ struct dnnl_convolution
     dnnl::convolution_forward::desc
     get_desc(const std::unordered_map<int, dnnl::memory::desc>& m) const
     {
+        const auto& op = this->op;
         // In DNNL dilation is zero-based
         auto dilation = op.dilation;
         std::transform(
@@ -79,6 +96,74 @@ struct dnnl_convolution
                 to_dnnl_dims(padding_l),
                 to_dnnl_dims(padding_r)};
     }
+
+    struct packed_weights
+    {
+        std::once_flag flag;
+        dnnl::memory data;
+    };
+
+    void finalize(migraphx::context& ctx, const shape& output_shape, std::vector<shape> inputs)
+    {
+        if(not prepack_weights)
+        {
+            base::finalize(ctx, output_shape, std::move(inputs));
+            return;
+        }
+        // Compensate for allocation
+        inputs.pop_back();
+        const auto weights_arg = MIGRAPHX_DNNL_PREFIX(ARG_WEIGHTS);
+        auto md                = this->to_memory_desc(output_shape, inputs);
+        auto weights_md        = md.at(weights_arg);
+        // Let dnnl pick the weights layout
+        auto any_md         = md;
+        any_md[weights_arg] = dnnl::memory::desc(
+            weights_md.dims(), weights_md.data_type(), dnnl::memory::format_tag::any);
+        const auto& self = static_cast<const Derived&>(*this);
+        auto attr        = this->get_primitive_attr(md);
+        auto pd          = self.get_primitive_desc(self.get_desc(any_md), attr);
+        auto packed_md   = pd.weights_desc();
+        if(packed_md == weights_md)
+        {
+            base::finalize(ctx, output_shape, std::move(inputs));
+            return;
+        }
+        auto prim       = dnnl::convolution_forward(pd);
+        auto arg_lookup = this->create_arg_map(inputs.size());
+        auto packed     = std::make_shared<packed_weights>();
+        this->execute   = [=](migraphx::context&, const std::vector<argument>& args) {
+            // The weights are constant so only reorder them on the first run
+            std::call_once(packed->flag, [&] {
+                auto& dctx   = get_dnnl_context();
+                auto weights = to_dnnl_memory(weights_md, args[1]);
+                packed->data = dnnl::memory(packed_md, dctx.engine);
+                dnnl::reorder(weights, packed->data).execute(dctx.stream, weights, packed->data);
+                dctx.stream.wait();
+            });
+            std::unordered_map<int, dnnl::memory> m;
+            m[MIGRAPHX_DNNL_PREFIX(ARG_DST)] =
+                to_dnnl_memory(md.at(MIGRAPHX_DNNL_PREFIX(ARG_DST)), args.back());
+            for(int i = 0; i < args.size() - 1; i++)
+            {
+                if(arg_lookup[i] == weights_arg)
+                    m[arg_lookup[i]] = packed->data;
+                else
+                    m[arg_lookup[i]] = to_dnnl_memory(md.at(arg_lookup[i]), args[i]);
+            }
+            prim.execute(get_dnnl_context().stream, m);
+            return args.back();
+        };
+    }
+};
+
+struct dnnl_convolution : dnnl_convolution_base<dnnl_convolution, op::convolution>
+{
+};
+
+// int8 inputs with an int32 output
+struct dnnl_quant_convolution
+    : dnnl_convolution_base<dnnl_quant_convolution, op::quant_convolution>
+{
 };
 
 } // namespace cpu
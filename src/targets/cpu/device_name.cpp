@@ -0,0 +1,74 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/cpu/device_name.hpp>
+#include <migraphx/stringutils.hpp>
+#include <migraphx/ranges.hpp>
+#include <array>
+#include <fstream>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+static std::string read_device_name()
+{
+    // The fields that identify the cpu on x86 and arm
+    const std::array<std::string, 10> keys = {"vendor_id",
+                                              "cpu family",
+                                              "model",
+                                              "model name",
+                                              "flags",
+                                              "CPU implementer",
+                                              "CPU architecture",
+                                              "CPU variant",
+                                              "CPU part",
+                                              "Features"};
+    std::ifstream is("/proc/cpuinfo");
+    std::string result;
+    std::string line;
+    // Only the first processor is read, the others are the same
+    while(std::getline(is, line) and not trim(line).empty())
+    {
+        auto pos = line.find(':');
+        if(pos == std::string::npos)
+            continue;
+        auto key = trim(line.substr(0, pos));
+        if(not contains(keys, key))
+            continue;
+        result += key + "=" + trim(line.substr(pos + 1)) + ";";
+    }
+    if(result.empty())
+        return "unknown";
+    return result;
+}
+
+std::string get_device_name()
+{
+    static const std::string name = read_device_name();
+    return name;
+}
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
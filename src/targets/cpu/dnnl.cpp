@@ -22,6 +22,7 @@
  * THE SOFTWARE.
  */
 #include <migraphx/cpu/dnnl.hpp>
+#include <migraphx/stringutils.hpp>
 
 #if defined(__GNUC__) && __GNUC__ <= 5
 namespace std {
@@ -49,7 +50,10 @@ namespace cpu {
 
 dnnl_context& get_dnnl_context()
 {
-    static dnnl_context ctx{}; // NOLINT
+    static dnnl::engine engine{dnnl::engine::kind::cpu, 0}; // NOLINT
+    // Primitives are executed on a stream per thread so the streams of the cpu context can
+    // execute them concurrently
+    thread_local dnnl_context ctx{engine}; // NOLINT
     return ctx;
 }
 
@@ -94,6 +98,99 @@ dnnl::memory::desc to_dnnl_memory_desc(const shape& s)
     return {to_dnnl_dims(s.lens()), to_dnnl_memory_data_type(s.type()), to_dnnl_dims(s.strides())};
 }
 
+shape to_blocked_shape(const shape& s, std::size_t block)
+{
+    auto lens = s.lens();
+    if(lens.size() < 3 or lens[1] % block != 0)
+        MIGRAPHX_THROW("Channels of " + migraphx::to_string(s) + " can't be blocked by " +
+                       std::to_string(block));
+    lens[1] /= block;
+    lens.push_back(block);
+    return {s.type(), lens};
+}
+
+shape from_blocked_shape(const shape& s)
+{
+    auto lens = s.lens();
+    lens[1] *= lens.back();
+    lens.pop_back();
+    return {s.type(), lens};
+}
+
+dnnl::memory::desc to_dnnl_blocked_memory_desc(const shape& s)
+{
+    using tag   = dnnl::memory::format_tag;
+    auto plain  = from_blocked_shape(s);
+    auto block  = s.lens().back();
+    auto result = [&](tag t) {
+        return dnnl::memory::desc{
+            to_dnnl_dims(plain.lens()), to_dnnl_memory_data_type(s.type()), t};
+    };
+    switch(plain.lens().size())
+    {
+    case 3:
+        if(block == 8)
+            return result(tag::nCw8c);
+        if(block == 16)
+            return result(tag::nCw16c);
+        break;
+    case 4:
+        if(block == 8)
+            return result(tag::nChw8c);
+        if(block == 16)
+            return result(tag::nChw16c);
+        break;
+    case 5:
+        if(block == 8)
+            return result(tag::nCdhw8c);
+        if(block == 16)
+            return result(tag::nCdhw16c);
+        break;
+    default: break;
+    }
+    MIGRAPHX_THROW("Unsupported blocked shape: " + migraphx::to_string(s));
+}
+
+// Ask for the source layout of a typical 3x3 convolution when dnnl is free to choose it
+static std::size_t find_preferred_block()
+{
+    using tag = dnnl::memory::format_tag;
+    shape x{shape::float_type, {1, 64, 28, 28}};
+    shape w{shape::float_type, {64, 64, 3, 3}};
+    auto any = [](const shape& s) {
+        return dnnl::memory::desc{
+            to_dnnl_dims(s.lens()), to_dnnl_memory_data_type(s.type()), tag::any};
+    };
+    try
+    {
+        dnnl::convolution_forward::desc desc{dnnl::prop_kind::forward_inference,
+                                             dnnl::algorithm::convolution_auto,
+                                             any(x),
+                                             any(w),
+                                             any(x),
+                                             {1, 1},
+                                             {0, 0},
+                                             {1, 1},
+                                             {1, 1}};
+        dnnl::convolution_forward::primitive_desc pd{desc, get_dnnl_context().engine};
+        for(std::size_t block : {16, 8})
+        {
+            if(pd.src_desc() == to_dnnl_blocked_memory_desc(to_blocked_shape(x, block)))
+                return block;
+        }
+    }
+    catch(const dnnl::error&)
+    {
+    }
+    return 0;
+}
+
+std::size_t dnnl_preferred_block()
+{
+    static const std::size_t block = find_preferred_block();
+    return block;
+}
+
 dnnl::memory to_dnnl_memory(const dnnl::memory::desc& desc, const argument& a)
 {
     return {desc, get_dnnl_context().engine, a.data()};
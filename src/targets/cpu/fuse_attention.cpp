@@ -0,0 +1,125 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/cpu/fuse_attention.hpp>
+#include <migraphx/match/attention.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/matcher.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/float_equal.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/serialize.hpp>
+#include <algorithm>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+// The value of a constant that is the same everywhere
+static optional<float> get_scalar(instruction_ref ins)
+{
+    auto arg = ins->eval();
+    if(arg.empty())
+        return nullopt;
+    optional<float> result;
+    arg.visit([&](auto x) {
+        if(std::all_of(x.begin(), x.end(), [&](auto y) { return float_equal(y, x.front()); }))
+            result = x.front();
+    });
+    return result;
+}
+
+struct find_attention
+{
+    auto matcher() const { return match::attention(); }
+
+    void apply(module& m, const match::matcher_result& r) const
+    {
+        auto ins     = r.result;
+        auto softmax = r.instructions["softmax"];
+        auto v       = r.instructions["v"];
+        auto rank    = ins->get_shape().lens().size();
+        if(ins->get_shape().type() != shape::float_type or rank < 2)
+            return;
+        if(softmax->get_operator().to_value()["axis"].to<int64_t>() != rank - 1)
+            return;
+
+        // Walk back from the softmax to the product of the queries and keys, since the matcher
+        // has optional parts
+        std::vector<instruction_ref> intermediates = {softmax};
+        auto x = softmax->inputs().front();
+        optional<instruction_ref> mask;
+        if(x->name() == "add")
+        {
+            if(not contains(r.instructions, "mask") or
+               not contains(x->inputs(), r.instructions["mask"]))
+                return;
+            mask = r.instructions["mask"];
+            intermediates.push_back(x);
+            x = (x->inputs().front() == *mask) ? x->inputs().back() : x->inputs().front();
+        }
+        float scale = 1.0f;
+        if(contains({"mul", "div"}, x->name()))
+        {
+            auto i = (x->name() == "mul" and x->inputs().front()->name() != "dot") ? 0 : 1;
+            auto s = get_scalar(x->inputs()[i]);
+            if(not s.has_value() or float_equal(*s, 0.0f))
+                return;
+            scale = (x->name() == "div") ? 1.0f / *s : *s;
+            intermediates.push_back(x);
+            x = x->inputs()[1 - i];
+        }
+        if(x->name() != "dot")
+            return;
+        intermediates.push_back(x);
+        // The intermediate results have to be unused elsewhere to be skipped
+        if(std::any_of(intermediates.begin(), intermediates.end(), [](auto i) {
+               return i->outputs().size() != 1;
+           }))
+            return;
+
+        std::vector<instruction_ref> inputs = {x->inputs()[0], x->inputs()[1], v};
+        if(mask.has_value())
+            inputs.push_back(*mask);
+        // auto_contiguous has already copied strided inputs such as a transposed k, but the fused
+        // operator reads any strides so it can use the input of the copy instead
+        std::transform(inputs.begin(), inputs.end(), inputs.begin(), [](auto i) {
+            return (i->name() == "contiguous") ? i->inputs().front() : i;
+        });
+        if(std::any_of(inputs.begin(), inputs.end(), [&](auto i) {
+               return i->get_shape().type() != shape::float_type or
+                      i->get_shape().lens().size() != rank;
+           }))
+            return;
+        auto alloc = make_op("allocate", {{"shape", to_value(ins->get_shape())}});
+        inputs.push_back(m.insert_instruction(ins, alloc));
+        m.replace_instruction(ins, make_op("cpu::attention", {{"scale", scale}}), inputs);
+    }
+};
+
+void fuse_attention::apply(module& m) const { match::find_matches(m, find_attention{}); }
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -0,0 +1,121 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/config.hpp>
+#include <migraphx/context.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/op/gathernd.hpp>
+#include <migraphx/register_op.hpp>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+struct cpu_gathernd : auto_register_op<cpu_gathernd>
+{
+    op::gathernd op;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return migraphx::reflect(self.op, f);
+    }
+    std::string name() const { return "cpu::" + op.name(); }
+    shape compute_shape(std::vector<shape> inputs) const
+    {
+        // Compensate for allocation
+        inputs.pop_back();
+        check_shapes(inputs, *this).standard();
+        return migraphx::compute_shape(op, inputs);
+    }
+
+    argument compute(context& ctx, const shape&, const std::vector<argument>& args) const
+    {
+        const auto& data_lens  = args[0].get_shape().lens();
+        const auto& ind_lens   = args[1].get_shape().lens();
+        std::size_t k          = ind_lens.back();
+        std::size_t batch_dims = op.batch_dims;
+        std::size_t num_slices = std::accumulate(
+            ind_lens.begin(), ind_lens.end() - 1, std::size_t{1}, std::multiplies<>{});
+        std::size_t slice_size       = std::accumulate(data_lens.begin() + batch_dims + k,
+                                                 data_lens.end(),
+                                                 std::size_t{1},
+                                                 std::multiplies<>{});
+        std::size_t num_batches      = std::accumulate(data_lens.begin(),
+                                                  data_lens.begin() + batch_dims,
+                                                  std::size_t{1},
+                                                  std::multiplies<>{});
+        std::size_t batch_stride     = args[0].get_shape().elements() / num_batches;
+        std::size_t slices_per_batch = num_slices / num_batches;
+
+        // The offsets are computed up front so that a bad index throws here rather than on a
+        // worker thread
+        std::vector<std::size_t> offsets(num_slices);
+        args[1].visit([&](auto indices) {
+            for(std::size_t i = 0; i < num_slices; i++)
+            {
+                std::size_t offset = (i / slices_per_batch) * batch_stride;
+                std::size_t stride = batch_stride;
+                for(std::size_t j = 0; j < k; j++)
+                {
+                    auto dim   = static_cast<int64_t>(data_lens[batch_dims + j]);
+                    auto index = static_cast<int64_t>(indices[i * k + j]);
+                    if(index < -dim or index >= dim)
+                        MIGRAPHX_THROW("GATHERND: index " + std::to_string(index) +
+                                       " is out of bounds for dim of len " + std::to_string(dim));
+                    if(index < 0)
+                        index += dim;
+                    stride /= dim;
+                    offset += index * stride;
+                }
+                offsets[i] = offset;
+            }
+        });
+
+        visit_all(args.back(), args[0])([&](auto output, auto data) {
+            const auto* data_ptr = data.data();
+            auto* output_ptr     = output.data();
+            const auto* off_ptr  = offsets.data();
+            // Each slice is contiguous in both the data and the output
+            auto grain = std::max<std::size_t>(1, 1024 / std::max<std::size_t>(1, slice_size));
+            ctx.bulk_execute(num_slices, grain, [=](auto start, auto end) {
+                for(auto i = start; i < end; i++)
+                {
+                    const auto* first = data_ptr + off_ptr[i];
+                    std::copy(first, first + slice_size, output_ptr + i * slice_size);
+                }
+            });
+        });
+
+        return args.back();
+    }
+
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return shapes.size() - 1;
+    }
+};
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -25,17 +25,99 @@
 #define MIGRAPHX_GUARD_RTGLIB_CONTEXT_HPP
 
 #include <migraphx/config.hpp>
+#include <migraphx/argument.hpp>
 #include <migraphx/cpu/dnnl.hpp>
 #include <migraphx/cpu/parallel.hpp>
+#include <migraphx/cpu/stream.hpp>
+#include <migraphx/env.hpp>
 #include <migraphx/par_for.hpp>
+#include <migraphx/value.hpp>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 namespace cpu {
 
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_NSTREAMS)
+
 struct context
 {
-    void finish() const {}
+    explicit context(std::size_t n = value_of(MIGRAPHX_NSTREAMS{}, 1)) { create_streams(n); }
+
+    // Stream 0 runs on the thread that evaluates the program, the other streams run on the
+    // global thread pool. The threads available for each operator are split evenly across
+    // streams.
+    void create_streams(std::size_t n)
+    {
+        n             = std::max<std::size_t>(n, 1);
+        auto nthreads = std::max<std::size_t>(max_threads() / n, 1);
+        streams.clear();
+        for(std::size_t i = 0; i < n; i++)
+            streams.push_back(std::make_shared<stream>(i > 0, nthreads));
+        current_stream = 0;
+    }
+
+    stream& get_stream() { return *streams.at(current_stream); }
+
+    stream& get_stream(std::size_t n) { return *streams.at(n); }
+
+    void set_stream(std::size_t n) { current_stream = n; }
+
+    std::size_t nstreams() const { return streams.size(); }
+
+    std::size_t stream_id() const { return current_stream; }
+
+    void create_events(std::size_t num_of_events)
+    {
+        for(std::size_t i = events.size(); i < num_of_events + 1; ++i)
+            events.push_back(std::make_shared<event>());
+    }
+
+    event& get_event(std::size_t i) const { return *events.at(i); }
+
+    void check() const
+    {
+        for(auto&& s : streams)
+            s->check();
+    }
+
+    void finish() const
+    {
+        for(auto&& s : streams)
+            s->wait();
+    }
+
+    value to_value() const
+    {
+        value result;
+        result["events"]  = events.size();
+        result["streams"] = streams.size();
+        return result;
+    }
+
+    void from_value(const value& v)
+    {
+        auto n_events = v.at("events").without_key().to<std::size_t>();
+        events.clear();
+        if(n_events > 0)
+            this->create_events(n_events - 1);
+        this->create_streams(v.at("streams").without_key().to<std::size_t>());
+    }
+
+    // Buffers for global allocations such as the scratch memory. They belong to the context
+    // rather than the operator so that each context evaluating a program gets its own.
+    argument get_preallocation(const std::string& id, const shape& s)
+    {
+        std::lock_guard<std::mutex> lock(preallocations->mutex);
+        auto it = preallocations->buffers.find(id);
+        if(it == preallocations->buffers.end() or it->second.get_shape() != s)
+            it = preallocations->buffers.insert_or_assign(id, argument{s}).first;
+        return it->second;
+    }
 
     template <class F>
     void bulk_execute(std::size_t n, std::size_t min_grain, F f)
@@ -48,8 +130,25 @@ struct context
     {
         this->bulk_execute(n, 256, f);
     }
+
+    private:
+    struct preallocation_map
+    {
+        std::mutex mutex;
+        std::unordered_map<std::string, argument> buffers;
+    };
+
+    std::size_t current_stream = 0;
+    // Copies of the context share the streams and events. The streams are destroyed first since
+    // they wait for their work, which can signal the events.
+    std::vector<std::shared_ptr<event>> events;
+    std::vector<std::shared_ptr<stream>> streams;
+    std::shared_ptr<preallocation_map> preallocations = std::make_shared<preallocation_map>();
 };
 
+inline void migraphx_to_value(value& v, const context& ctx) { v = ctx.to_value(); }
+inline void migraphx_from_value(const value& v, context& ctx) { ctx.from_value(v); }
+
 } // namespace cpu
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
@@ -55,6 +55,7 @@ struct dnnl_context
     dnnl::engine engine;
     dnnl::stream stream;
     dnnl_context() : engine(dnnl::engine::kind::cpu, 0), stream(engine) {}
+    dnnl_context(const dnnl::engine& e) : engine(e), stream(engine) {}
 };
 
 dnnl_context& get_dnnl_context();
@@ -71,6 +72,19 @@ inline dnnl::memory::dims to_dnnl_dims(R&& r)
 
 dnnl::memory::desc to_dnnl_memory_desc(const shape& s);
 
+/// Shape of an activation blocked over the channels, such as nChw16c. It is stored as a standard
+/// shape with the block as an extra last dimension: {N, C / block, spatial..., block}
+shape to_blocked_shape(const shape& s, std::size_t block);
+
+/// Plain shape of an activation blocked over the channels
+shape from_blocked_shape(const shape& s);
+
+dnnl::memory::desc to_dnnl_blocked_memory_desc(const shape& s);
+
+/// Channel block of the layout dnnl prefers for float activations on this cpu, or 0 when it
+/// prefers a plain layout
+std::size_t dnnl_preferred_block();
+
 dnnl::memory to_dnnl_memory(const dnnl::memory::desc& desc, const argument& a);
 
 dnnl::memory to_dnnl_memory(const argument& a);
@@ -205,6 +219,11 @@ struct dnnl_op : auto_register_op<Derived>
         }
     }
     shape adjust_shape(const shape& s, int) const { return base_adjust_shape(s); }
+    dnnl::memory::desc memory_desc(const shape& s, int i) const
+    {
+        const auto& self = static_cast<const Derived&>(*this);
+        return to_dnnl_memory_desc(self.adjust_shape(s, i));
+    }
     std::vector<int> create_arg_map(std::size_t input_size) const
     {
         const auto& self     = static_cast<const Derived&>(*this);
@@ -223,13 +242,12 @@ struct dnnl_op : auto_register_op<Derived>
     {
         const auto& self = static_cast<const Derived&>(*this);
         std::unordered_map<int, dnnl::memory::desc> result;
-        result[MIGRAPHX_DNNL_PREFIX(ARG_DST)] =
-            to_dnnl_memory_desc(self.adjust_shape(output_shape, inputs.size()));
+        result[MIGRAPHX_DNNL_PREFIX(ARG_DST)] = self.memory_desc(output_shape, inputs.size());
         auto m = create_arg_map(inputs.size());
         assert(m.size() >= inputs.size());
         for(int i = 0; i < inputs.size(); i++)
         {
-            result[m[i]] = to_dnnl_memory_desc(self.adjust_shape(inputs[i], i));
+            result[m[i]] = self.memory_desc(inputs[i], i);
         }
         return result;
     }
@@ -286,9 +304,10 @@ struct dnnl_op : auto_register_op<Derived>
     {
         // Compensate for allocation
         inputs.pop_back();
-        auto md        = to_memory_desc(output_shape, inputs);
-        auto prim      = get_primitive(md);
-        auto impl_name = impl(prim);
+        const auto& self = static_cast<const Derived&>(*this);
+        auto md          = self.to_memory_desc(output_shape, inputs);
+        auto prim        = get_primitive(md);
+        auto impl_name   = impl(prim);
         return {{"impl", impl_name}};
     }
 
@@ -298,7 +317,7 @@ struct dnnl_op : auto_register_op<Derived>
         inputs.pop_back();
         const auto& self = static_cast<const Derived&>(*this);
         auto name        = self.name();
-        auto md          = to_memory_desc(output_shape, inputs);
+        auto md          = self.to_memory_desc(output_shape, inputs);
         auto prim        = get_primitive(md);
         auto arg_lookup  = create_arg_map(inputs.size());
 #ifndef NDEBUG
@@ -309,7 +328,8 @@ struct dnnl_op : auto_register_op<Derived>
             // Check that the memory descriptors have not changed
             auto debug_args = args;
             debug_args.pop_back();
-            auto debug_md = to_memory_desc(output_shape, to_shapes(debug_args));
+            auto debug_md = static_cast<const Derived&>(*this).to_memory_desc(
+                output_shape, to_shapes(debug_args));
             for(auto&& p : debug_md)
             {
                 if(md.count(p.first) == 0)
@@ -412,6 +432,52 @@ struct dnnl_extend_op : dnnl_op<Derived, Primitive>
     }
 };
 
+// Operators that can read and write activations blocked over the channels. The input is read
+// blocked when it has one more dimension than the plain layout, and the output is written
+// blocked when output_block is set.
+template <class Derived, class Primitive, class Op>
+struct dnnl_blocked_op : dnnl_extend_op<Derived, Primitive, Op>
+{
+    using base = dnnl_extend_op<Derived, Primitive, Op>;
+    std::size_t output_block = 0;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack_join(base::reflect(self, f), pack(f(self.output_block, "output_block")));
+    }
+
+    bool is_blocked(const shape& s) const
+    {
+        const auto& self = static_cast<const Derived&>(*this);
+        return s.lens().size() == self.kdims() + 3;
+    }
+
+    dnnl::memory::desc memory_desc(const shape& s, int i) const
+    {
+        if(is_blocked(s))
+            return to_dnnl_blocked_memory_desc(s);
+        return base::memory_desc(s, i);
+    }
+
+    shape compute_shape(std::vector<shape> inputs) const
+    {
+        const auto& self = static_cast<const Derived&>(*this);
+        // Compensate for allocation
+        inputs.pop_back();
+        self.required(check_shapes(inputs, self));
+        auto plain = this->trim_post_op_inputs(inputs);
+        if(is_blocked(plain.front()))
+            plain.front() = from_blocked_shape(plain.front());
+        auto r = migraphx::compute_shape(this->op, plain);
+        if(output_block > 0)
+            r = to_blocked_shape(r, output_block);
+        // Call to get_primitive to make sure an algo is available
+        this->get_primitive(this->to_memory_desc(r, inputs));
+        return r;
+    }
+};
+
 } // namespace cpu
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
@@ -34,8 +34,11 @@ struct module;
 
 namespace cpu {
 
+struct context;
+
 struct lowering
 {
+    context* ctx = nullptr;
     std::string name() const { return "cpu::lowering"; }
     void apply(module& m) const;
 };
@@ -28,7 +28,8 @@
 
 #include <migraphx/config.hpp>
 #ifdef MIGRAPHX_DISABLE_OMP
-#include <migraphx/par_for.hpp>
+#include <migraphx/thread_pool.hpp>
+#include <cmath>
 #else
 
 #ifdef __clang__
@@ -48,7 +49,7 @@ namespace cpu {
 
 #ifdef MIGRAPHX_DISABLE_OMP
 
-inline std::size_t max_threads() { return std::thread::hardware_concurrency(); }
+inline std::size_t max_threads() { return thread_pool::global().size(); }
 
 template <class F>
 void parallel_for_impl(std::size_t n, std::size_t threadsize, F f)
@@ -59,22 +60,11 @@ void parallel_for_impl(std::size_t n, std::size_t threadsize, F f)
     }
     else
     {
-        std::vector<joinable_thread> threads(threadsize);
-// Using const here causes gcc 5 to ICE
-#if(!defined(__GNUC__) || __GNUC__ != 5)
-        const
-#endif
-            std::size_t grainsize = std::ceil(static_cast<double>(n) / threads.size());
-
-        std::size_t work = 0;
-        std::generate(threads.begin(), threads.end(), [=, &work] {
-            auto result =
-                joinable_thread([=]() mutable { f(work, std::min(n, work + grainsize)); });
-            work += grainsize;
-            return result;
+        const std::size_t grainsize = std::ceil(static_cast<double>(n) / threadsize);
+        thread_pool::global().run(threadsize, [&](std::size_t tid) {
+            std::size_t work = tid * grainsize;
+            f(work, std::min(n, work + grainsize));
         });
-        // cppcheck-suppress unsignedLessThanZero
-        assert(work >= n);
     }
 }
 #else
@@ -0,0 +1,115 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_AMDMIGRAPHX_CPU_STREAM_HPP
+#define MIGRAPHX_GUARD_AMDMIGRAPHX_CPU_STREAM_HPP
+
+#include <migraphx/config.hpp>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+/**
+ * @brief Synchronizes work between streams
+ * @details Each time a record is submitted the event expects one more signal, and a wait
+ * blocks until all the signals that were expected when it was submitted have happened. This
+ * lets the same event be reused on every evaluation.
+ */
+struct event
+{
+    /// Expects one more signal
+    void record();
+    /// Returns the number of signals a wait submitted now has to wait for
+    std::size_t recorded() const;
+    void signal();
+    void wait(std::size_t n) const;
+    /// Returns false if `n` signals already happened, otherwise `f` is called by the signal that
+    /// reaches `n`
+    bool notify(std::size_t n, std::function<void()> f);
+
+    private:
+    mutable std::mutex m;
+    mutable std::condition_variable cv;
+    std::size_t nrecorded = 0;
+    std::size_t nsignaled = 0;
+    std::vector<std::pair<std::size_t, std::function<void()>>> waiters;
+};
+
+/**
+ * @brief An in-order queue of work
+ * @details An asynchronous stream executes its work as a task on the global thread pool, and
+ * a wait for an event releases the thread until the event is signaled. Otherwise work is
+ * executed directly on the thread that submits it. Either way, the work is run with at most
+ * `nthreads` threads available for intra-op parallelism, so that concurrent streams share the
+ * cores rather than oversubscribe them.
+ */
+struct stream
+{
+    stream(bool async, std::size_t nthreads);
+    stream(const stream&) = delete;
+    stream& operator=(const stream&) = delete;
+    ~stream();
+
+    bool is_async() const;
+    void submit(std::function<void()> f);
+    /// Waits for `n` signals of the event before running the work submitted after it
+    void submit_wait(event& e, std::size_t n);
+    /// Waits for all the submitted work to finish, and rethrows the first error from it
+    void wait();
+    /// Rethrows the first error from the submitted work without waiting
+    void check();
+
+    private:
+    struct item
+    {
+        std::function<void()> f;
+        event* e      = nullptr;
+        std::size_t n = 0;
+    };
+    void push(item x);
+    void drain();
+    void execute(const std::function<void()>& f);
+
+    std::size_t nthreads;
+    bool async;
+    std::mutex m;
+    std::condition_variable cv;
+    std::deque<item> queue;
+    // Set while a task of the pool is draining the queue or parked on an event
+    bool running = false;
+    std::exception_ptr error;
+};
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
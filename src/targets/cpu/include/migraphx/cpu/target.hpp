@@ -44,6 +44,7 @@ struct target
     argument copy_to(const argument& arg) const { return arg; }
     argument copy_from(const argument& arg) const { return arg; }
     argument allocate(const shape& s) const;
+    std::string device_identity() const;
 };
 
 MIGRAPHX_REGISTER_TARGET(target);
@@ -0,0 +1,113 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/config.hpp>
+#include <migraphx/context.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/op/loop.hpp>
+#include <migraphx/register_op.hpp>
+#include <migraphx/run_loop.hpp>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+struct cpu_loop : auto_register_op<cpu_loop>
+{
+    op::loop op;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return migraphx::reflect(self.op, f);
+    }
+    std::string name() const { return "cpu::loop"; }
+    shape compute_shape(std::vector<shape> inputs, std::vector<module_ref> mods) const
+    {
+        // Compensate for allocation
+        inputs.pop_back();
+        return op.compute_shape(inputs, std::move(mods));
+    }
+
+    argument
+    compute(context& ctx,
+            const shape&,
+            const std::vector<argument>& args,
+            const std::vector<module_ref>& mods,
+            const std::function<std::vector<argument>(
+                module_ref&, const std::unordered_map<std::string, argument>&)>& run) const
+    {
+        auto output  = args.back();
+        auto outputs = output.get_sub_objects();
+        std::vector<argument> inputs(args.begin(), args.end() - 1);
+        auto dep_num = inputs.size() - 2;
+
+        // The results of the body are in its scratch memory, which is overwritten by the next
+        // iteration while the carried values are still read, so they are copied to the output
+        auto copy_carried = [&](std::vector<argument>& results, std::size_t start) {
+            for(std::size_t i = 0; i < dep_num; i++)
+            {
+                auto& result    = results.at(start + i);
+                const auto& out = outputs.at(i);
+                if(result.data() == out.data())
+                    continue;
+                visit_all(out, result)(
+                    [&](auto y, auto x) { std::copy(x.begin(), x.end(), y.begin()); });
+                result = out;
+            }
+        };
+        auto run_body = [&](module_ref& mod,
+                            const std::unordered_map<std::string, argument>& params) {
+            auto results = run(mod, params);
+            copy_carried(results, 1);
+            return results;
+        };
+
+        bool cond      = inputs.at(1).at<bool>();
+        int64_t iter   = 0;
+        auto s_cond    = inputs.at(1).get_shape();
+        auto s_iter    = inputs.at(0).get_shape();
+        auto loop_args = inputs;
+        loop_args.push_back({s_iter, &iter});
+        loop_args.push_back({s_cond, &cond});
+        loop_args.insert(loop_args.end(), inputs.begin() + 2, inputs.end());
+        loop_args.push_back(argument(s_cond));
+        loop_args.push_back(output);
+
+        auto result =
+            run_loop(op::loop::ref_loop{op.max_iterations}, ctx, loop_args, mods, run_body)
+                .get_sub_objects();
+        // Without any iteration the carried values are still the inputs
+        copy_carried(result, 0);
+        return output;
+    }
+
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return shapes.size() - 1;
+    }
+};
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
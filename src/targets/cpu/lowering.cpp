@@ -46,8 +46,10 @@
 #include <migraphx/shape_for_each.hpp>
 #include <migraphx/iterator_for.hpp>
 #include <migraphx/par_dfor.hpp>
+#include <migraphx/par_for.hpp>
 #include <migraphx/clamp.hpp>
 #include <migraphx/cpu/context.hpp>
+#include <migraphx/cpu/compile_pointwise.hpp>
 #include <migraphx/register_op.hpp>
 #include <migraphx/make_op.hpp>
 #include <migraphx/program.hpp>
@@ -313,6 +315,7 @@ MIGRAPHX_REGISTER_OP(cpu_rnn_var_sl_last_output)
 struct cpu_apply
 {
     module* modl;
+    std::size_t nstreams = 1;
     std::unordered_map<std::string, std::function<instruction_ref(instruction_ref)>> apply_map{};
     instruction_ref last{};
 
@@ -354,8 +357,7 @@ struct cpu_apply
                            bind_inputs.end(),
                            std::back_inserter(inputs),
                            [&](const auto& s) { return r.instructions[s]; });
-            inputs.push_back(this->insert_allocation(ins, ins->get_shape()));
-            modl->replace_instruction(ins, op, inputs);
+            this->replace(ins, op, inputs);
         });
     }
 
@@ -395,18 +397,40 @@ struct cpu_apply
 #ifndef MIGRAPHX_ENABLE_ZENDNN
         extend_op("deconvolution", "dnnl::deconvolution");
         extend_op("dot", "dnnl::dot");
+        extend_op("quant_dot", "dnnl::quant_dot");
 #endif
         extend_op("erf", "cpu::erf");
         extend_op("gather", "cpu::gather");
+        extend_op("gathernd", "cpu::gathernd");
         extend_op("logsoftmax", "dnnl::logsoftmax");
         extend_op("lrn", "dnnl::lrn");
+        extend_op("nonmaxsuppression", "cpu::nonmaxsuppression");
+        extend_op("quant_convolution", "dnnl::quant_convolution");
+        extend_op("roialign", "cpu::roialign");
+        extend_op("scatter_add", "cpu::scatter_add");
+        extend_op("scatter_mul", "cpu::scatter_mul");
+        extend_op("scatter_none", "cpu::scatter_none");
+        extend_op("scatternd_add", "cpu::scatternd_add");
+        extend_op("scatternd_mul", "cpu::scatternd_mul");
+        extend_op("scatternd_none", "cpu::scatternd_none");
         extend_op("softmax", "dnnl::softmax");
         extend_op("sub", "cpu::sub");
+        extend_op("topk", "cpu::topk");
+        extend_op("weight_dot", "cpu::weight_dot");
 
         extend_op("im2col", "cpu::im2col", false);
         extend_op("leaky_relu", "cpu::leaky_relu", false);
         extend_op("pad", "cpu::pad", false);
         extend_op("rnn_var_sl_last_output", "cpu::rnn_var_sl_last_output", false);
+
+        apply_map.emplace("loop", [=](instruction_ref ins) {
+            auto inputs = ins->inputs();
+            inputs.push_back(insert_allocation(ins, ins->get_shape()));
+            return modl->replace_instruction(ins,
+                                             make_op("cpu::loop", ins->get_operator().to_value()),
+                                             inputs,
+                                             ins->module_inputs());
+        });
     }
 
     void apply()
@@ -429,6 +453,7 @@ struct cpu_apply
                 apply_pow(it);
             }
         }
+        apply_pointwise();
         for(auto it : iterator_for(*modl))
         {
             if(it->name() == "pooling")
@@ -440,6 +465,98 @@ struct cpu_apply
                 apply_map.at(it->name())(it);
             }
         }
+        // Wrap the reference operators that are left so they are evaluated with the context,
+        // which lets the scheduler assign them to a stream
+        if(nstreams < 2)
+            return;
+        for(auto it : iterator_for(*modl))
+        {
+            if(is_reference_op(it))
+                modl->replace_instruction(it, cpu_op{it->get_operator()}, it->inputs());
+        }
+    }
+
+    static bool is_reference_op(instruction_ref ins)
+    {
+        if(ins->name().front() == '@' or ins->inputs().empty() or
+           not ins->module_inputs().empty())
+            return false;
+        const auto& op = ins->get_operator();
+        return is_context_free(op) and op.output_alias(to_shapes(ins->inputs())) < 0;
+    }
+
+    // Compile the fused pointwise modules in parallel. Modules that can't be compiled are inlined
+    // so their operators are lowered individually, and the error is reported.
+    void apply_pointwise() const
+    {
+        struct compiled
+        {
+            instruction_ref ins;
+            operation op;
+            std::string error;
+        };
+        std::vector<compiled> results;
+        for(auto it : iterator_for(*modl))
+        {
+            if(it->name() == "pointwise")
+                results.push_back({it});
+        }
+        par_for(results.size(), 1, [&](std::size_t i) {
+            auto& r     = results[i];
+            auto inputs = to_shapes(r.ins->inputs());
+            inputs.push_back(r.ins->get_shape());
+            try
+            {
+                r.op = compile_pointwise(inputs, *r.ins->module_inputs().front());
+            }
+            catch(const std::exception& e)
+            {
+                r.error = e.what();
+            }
+        });
+        for(const auto& r : results)
+        {
+            if(r.error.empty())
+            {
+                replace(r.ins, r.op);
+                continue;
+            }
+            std::cerr << "WARNING: Failed to compile " << r.ins->module_inputs().front()->name()
+                      << ", its operators are lowered individually: " << r.error << std::endl;
+            inline_pointwise(r.ins);
+        }
+    }
+
+    instruction_ref inline_pointwise(instruction_ref ins) const
+    {
+        auto* pm    = ins->module_inputs().front();
+        auto pnames = pm->get_parameter_names();
+        std::sort(pnames.begin(), pnames.end());
+        std::unordered_map<instruction_ref, instruction_ref> map_ins;
+        std::transform(pnames.begin(),
+                       pnames.end(),
+                       ins->inputs().begin(),
+                       std::inserter(map_ins, map_ins.end()),
+                       [&](const auto& name, auto input) {
+                           return std::make_pair(pm->get_parameter(name), input);
+                       });
+        // Literals in the pointwise module are scalars, so they need to be broadcasted
+        for(auto pins : iterator_for(*pm))
+        {
+            if(pins->name() != "@literal")
+                continue;
+            auto l = modl->add_literal(pins->get_literal());
+            if(ins->get_shape().scalar())
+                map_ins[pins] = l;
+            else
+                map_ins[pins] = modl->insert_instruction(
+                    ins,
+                    make_op("multibroadcast", {{"out_lens", ins->get_shape().lens()}}),
+                    l);
+        }
+        auto results = modl->insert_instructions(ins, pm, map_ins);
+        assert(results.size() == 1);
+        return modl->replace_instruction(ins, results.front());
     }
 
     instruction_ref apply_pow(instruction_ref ins) const
@@ -484,17 +601,66 @@ struct cpu_apply
     instruction_ref
     replace(instruction_ref ins, const operation& op, std::vector<instruction_ref> inputs) const
     {
+        if(not is_float(inputs, ins->get_shape()) and
+           not is_supported(op, to_shapes(inputs), ins->get_shape()))
+            return replace_with_float(ins, op, inputs);
         inputs.push_back(insert_allocation(ins, ins->get_shape()));
         return modl->replace_instruction(ins, op, inputs);
     }
 
+    static bool is_float(const std::vector<instruction_ref>& inputs, const shape& output)
+    {
+        return output.type() == shape::float_type and
+               std::all_of(inputs.begin(), inputs.end(), [](instruction_ref i) {
+                   return i->get_shape().type() == shape::float_type;
+               });
+    }
+
+    // Check if dnnl has an implementation for the data types, which depends on the cpu
+    static bool is_supported(const operation& op, std::vector<shape> inputs, const shape& output)
+    {
+        inputs.push_back(output);
+        try
+        {
+            op.compute_shape(inputs);
+            return true;
+        }
+        catch(const std::exception&)
+        {
+            return false;
+        }
+    }
+
+    // Compute in float and convert back to the original type
+    instruction_ref
+    replace_with_float(instruction_ref ins, operation op, std::vector<instruction_ref> inputs) const
+    {
+        auto attributes = ins->get_operator().attributes();
+        if(attributes.contains("general_data_type"))
+            op = make_op("dnnl::" + attributes["general_data_type"].to<std::string>(),
+                         op.to_value());
+        std::transform(inputs.begin(), inputs.end(), inputs.begin(), [&](auto input) {
+            if(input->get_shape().type() == shape::float_type)
+                return input;
+            return modl->insert_instruction(
+                ins, make_op("convert", {{"target_type", shape::float_type}}), input);
+        });
+        inputs.push_back(insert_allocation(ins, ins->get_shape().with_type(shape::float_type)));
+        auto result = modl->insert_instruction(ins, op, inputs);
+        return modl->replace_instruction(
+            ins, make_op("convert", {{"target_type", ins->get_shape().type()}}), result);
+    }
+
     instruction_ref insert_allocation(instruction_ref ins, const shape& s) const
     {
         return modl->insert_instruction(ins, make_op("allocate", {{"shape", to_value(s)}}));
     }
 };
 
-void lowering::apply(module& m) const { cpu_apply{&m}.apply(); }
+void lowering::apply(module& m) const
+{
+    cpu_apply{&m, ctx == nullptr ? 1 : ctx->nstreams()}.apply();
+}
 
 } // namespace cpu
 } // namespace MIGRAPHX_INLINE_NS
@@ -0,0 +1,205 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/config.hpp>
+#include <migraphx/context.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/op/nonmaxsuppression.hpp>
+#include <migraphx/register_op.hpp>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+struct cpu_nonmaxsuppression : auto_register_op<cpu_nonmaxsuppression>
+{
+    op::nonmaxsuppression op;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return migraphx::reflect(self.op, f);
+    }
+    std::string name() const { return "cpu::" + op.name(); }
+    shape compute_shape(std::vector<shape> inputs) const
+    {
+        // Compensate for allocation
+        inputs.pop_back();
+        check_shapes(inputs, *this).standard();
+        return migraphx::compute_shape(op, inputs);
+    }
+
+    // Boxes stored as separate arrays of sorted corners so the IoU against all the selected
+    // boxes is a simple loop over contiguous memory
+    struct box_list
+    {
+        std::vector<double> x1;
+        std::vector<double> y1;
+        std::vector<double> x2;
+        std::vector<double> y2;
+        std::vector<double> area;
+
+        void reserve(std::size_t n)
+        {
+            for(auto* v : {&x1, &y1, &x2, &y2, &area})
+                v->reserve(n);
+        }
+
+        void clear()
+        {
+            for(auto* v : {&x1, &y1, &x2, &y2, &area})
+                v->clear();
+        }
+
+        std::size_t size() const { return area.size(); }
+
+        void push_back(const op::nonmaxsuppression::box& b)
+        {
+            x1.push_back(b.x[0]);
+            y1.push_back(b.y[0]);
+            x2.push_back(b.x[1]);
+            y2.push_back(b.y[1]);
+            area.push_back(b.area());
+        }
+
+        void push_back(const box_list& bl, std::size_t i)
+        {
+            x1.push_back(bl.x1[i]);
+            y1.push_back(bl.y1[i]);
+            x2.push_back(bl.x2[i]);
+            y2.push_back(bl.y2[i]);
+            area.push_back(bl.area[i]);
+        }
+
+        // Same result as op::nonmaxsuppression::suppress_by_iou against each box in the list
+        bool suppress(const box_list& bl, std::size_t i, double iou_threshold) const
+        {
+            bool result = false;
+            for(std::size_t j = 0; j < size(); j++)
+            {
+                double ix1   = std::max(bl.x1[i], x1[j]);
+                double iy1   = std::max(bl.y1[i], y1[j]);
+                double ix2   = std::min(bl.x2[i], x2[j]);
+                double iy2   = std::min(bl.y2[i], y2[j]);
+                double inter = (ix2 - ix1) * (iy2 - iy1);
+                double uni   = bl.area[i] + area[j] - inter;
+                bool valid   = ix1 <= ix2 and iy1 <= iy2 and bl.area[i] > 0 and area[j] > 0 and
+                             uni > 0;
+                result = result or (valid and inter / uni > iou_threshold);
+            }
+            return result;
+        }
+    };
+
+    argument compute(context& ctx, const shape&, const std::vector<argument>& args) const
+    {
+        auto result = args.back();
+        result.visit([&](auto output) { std::fill(output.begin(), output.end(), 0); });
+
+        std::size_t max_output_boxes_per_class =
+            (args.size() > 3) ? (args.at(2).at<std::size_t>()) : 0;
+        if(max_output_boxes_per_class == 0)
+            return result;
+        double iou_threshold   = (args.size() > 4) ? (args.at(3).at<double>()) : 0.0f;
+        double score_threshold = (args.size() > 5) ? (args.at(4).at<double>()) : 0.0f;
+
+        const auto& lens = args.at(1).get_shape().lens();
+        auto num_batches = lens[0];
+        auto num_classes = lens[1];
+        auto num_boxes   = lens[2];
+
+        // The corners and areas of every box are only computed once per batch
+        std::vector<box_list> batch_boxes(num_batches);
+        args.at(0).visit([&](auto boxes) {
+            const auto* boxes_ptr = boxes.data();
+            ctx.bulk_execute(num_batches, 1, [&](auto start, auto end) {
+                for(auto b = start; b < end; b++)
+                {
+                    batch_boxes[b].reserve(num_boxes);
+                    for(std::size_t i = 0; i < num_boxes; i++)
+                    {
+                        auto bx = op.batch_box(boxes_ptr + b * num_boxes * 4, i);
+                        bx.sort();
+                        batch_boxes[b].push_back(bx);
+                    }
+                }
+            });
+        });
+
+        // Each batch and class is suppressed independently, and the selected indices are
+        // gathered in order afterwards
+        std::vector<std::vector<int64_t>> selected(num_batches * num_classes);
+        args.at(1).visit([&](auto scores) {
+            const auto* scores_ptr = scores.data();
+            ctx.bulk_execute(selected.size(), 1, [&](auto start, auto end) {
+                std::vector<std::pair<double, int64_t>> candidates;
+                box_list kept;
+                kept.reserve(max_output_boxes_per_class);
+                for(auto i = start; i < end; i++)
+                {
+                    int64_t batch_idx = i / num_classes;
+                    int64_t class_idx = i % num_classes;
+                    const auto& bl    = batch_boxes[batch_idx];
+                    const auto* sc    = scores_ptr + i * num_boxes;
+                    candidates.clear();
+                    kept.clear();
+                    for(std::size_t j = 0; j < num_boxes; j++)
+                    {
+                        if(sc[j] >= score_threshold)
+                            candidates.emplace_back(sc[j], j);
+                    }
+                    // Highest score first, and the highest index first for equal scores
+                    std::sort(candidates.begin(), candidates.end(), std::greater<>{});
+                    for(const auto& c : candidates)
+                    {
+                        if(kept.size() >= max_output_boxes_per_class)
+                            break;
+                        if(kept.suppress(bl, c.second, iou_threshold))
+                            continue;
+                        kept.push_back(bl, c.second);
+                        selected[i].insert(selected[i].end(), {batch_idx, class_idx, c.second});
+                    }
+                }
+            });
+        });
+
+        auto* output = result.cast<int64_t>();
+        auto n       = result.get_shape().elements();
+        for(const auto& s : selected)
+        {
+            auto m = std::min(s.size(), n);
+            output = std::copy(s.begin(), s.begin() + m, output);
+            n -= m;
+        }
+        return result;
+    }
+
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return shapes.size() - 1;
+    }
+};
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
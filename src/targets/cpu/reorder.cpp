@@ -34,6 +34,21 @@ struct dnnl_reorder : dnnl_op<dnnl_reorder, dnnl::reorder>
 
     shape adjust_shape(const shape& x, int) const { return x; }
 
+    // A reorder to or from a layout blocked over the channels has one more dimension on the
+    // blocked side
+    std::unordered_map<int, dnnl::memory::desc>
+    to_memory_desc(const shape& output_shape, const std::vector<shape>& inputs) const
+    {
+        auto result     = dnnl_op::to_memory_desc(output_shape, inputs);
+        const auto& src = inputs.front();
+        auto n          = output_shape.lens().size();
+        if(src.lens().size() == n + 1)
+            result[MIGRAPHX_DNNL_PREFIX(ARG_SRC)] = to_dnnl_blocked_memory_desc(src);
+        else if(src.lens().size() + 1 == n)
+            result[MIGRAPHX_DNNL_PREFIX(ARG_DST)] = to_dnnl_blocked_memory_desc(output_shape);
+        return result;
+    }
+
     shape compute_shape(const std::vector<shape>& inputs) const
     {
         check_shapes{inputs, *this}.has(2);
@@ -0,0 +1,161 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/config.hpp>
+#include <migraphx/context.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/op/roialign.hpp>
+#include <migraphx/register_op.hpp>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+struct cpu_roialign : auto_register_op<cpu_roialign>
+{
+    op::roialign op;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return migraphx::reflect(self.op, f);
+    }
+    std::string name() const { return "cpu::" + op.name(); }
+    shape compute_shape(std::vector<shape> inputs) const
+    {
+        // Compensate for allocation
+        inputs.pop_back();
+        check_shapes(inputs, *this).standard();
+        return migraphx::compute_shape(op, inputs);
+    }
+
+    // The sample positions and bilinear weights of one roi, shared by all of its channels
+    struct roi_samples
+    {
+        std::size_t batch = 0;
+        std::size_t count = 0;
+        std::vector<op::roialign::pos_weight> pos_weights;
+    };
+
+    template <class T>
+    static double pool(const T* data, const roi_samples& rs, std::size_t start, bool average)
+    {
+        const auto* pw = rs.pos_weights.data() + start;
+        if(average)
+        {
+            double sum = 0.0;
+            for(std::size_t i = 0; i < rs.count; i++)
+            {
+                for(std::size_t j = 0; j < 4; j++)
+                    sum += double(data[pw[i].pos[j]]) * pw[i].w[j];
+            }
+            return (rs.count == 0) ? 0.0 : sum / rs.count;
+        }
+        double m = std::numeric_limits<double>::lowest();
+        for(std::size_t i = 0; i < rs.count; i++)
+        {
+            for(std::size_t j = 0; j < 4; j++)
+                m = std::max(m, double(data[pw[i].pos[j]]) * pw[i].w[j]);
+        }
+        return m;
+    }
+
+    argument
+    compute(context& ctx, const shape& output_shape, const std::vector<argument>& args) const
+    {
+        const auto& out_lens = output_shape.lens();
+        std::size_t n_rois   = out_lens[0];
+        std::size_t channels = out_lens[1];
+        // output dims of height and width, in all 2-dim arrays, the first dim
+        // is for height and second dim is for width
+        std::array<std::size_t, 2> out_dims = {out_lens[2], out_lens[3]};
+        const auto& x_lens                  = args.at(0).get_shape().lens();
+        std::array<std::size_t, 2> in_dims  = {x_lens[2], x_lens[3]};
+        std::size_t in_size                 = in_dims[0] * in_dims[1];
+        std::size_t out_size                = out_dims[0] * out_dims[1];
+        const auto* batch_indices           = args.at(2).cast<int64_t>();
+
+        // Precompute the samples of each roi once, instead of for every channel
+        std::vector<roi_samples> samples(n_rois);
+        args.at(1).visit([&](auto roi) {
+            ctx.bulk_execute(n_rois, 1, [&](auto start, auto end) {
+                for(auto n = start; n < end; n++)
+                {
+                    // Do not using rounding; this implementation detail is critical
+                    std::array<float, 2> roi_starts = {
+                        static_cast<float>(roi[n * 4 + 1] * op.spatial_scale),
+                        static_cast<float>(roi[n * 4] * op.spatial_scale)};
+                    std::array<float, 2> roi_ends = {
+                        static_cast<float>(roi[n * 4 + 3] * op.spatial_scale),
+                        static_cast<float>(roi[n * 4 + 2] * op.spatial_scale)};
+
+                    std::array<float, 2> bin_size{};
+                    std::array<std::size_t, 2> bin_grid_size{};
+                    for(auto ii : range(bin_size.size()))
+                    {
+                        // Force malformed ROIs to be 1x1
+                        float roi_size    = std::max(roi_ends[ii] - roi_starts[ii], 1.0f);
+                        bin_size[ii]      = roi_size / out_dims[ii];
+                        bin_grid_size[ii] = (op.sampling_ratio > 0)
+                                                ? op.sampling_ratio
+                                                : std::ceil(roi_size / out_dims[ii]);
+                    }
+
+                    shape comp_s{shape::float_type,
+                                 {out_dims[0], out_dims[1], bin_grid_size[0], bin_grid_size[1]}};
+                    samples[n].batch = batch_indices[n];
+                    samples[n].count = bin_grid_size[0] * bin_grid_size[1];
+                    samples[n].pos_weights =
+                        op.calc_pos_weight(in_dims, comp_s, roi_starts, bin_size, bin_grid_size);
+                }
+            });
+        });
+
+        bool average = op.mode == op::pooling_mode::average;
+        visit_all(args.back(), args.at(0))([&](auto output, auto x) {
+            const auto* x_ptr = x.data();
+            auto* out_ptr     = output.data();
+            ctx.bulk_execute(n_rois * channels, 1, [&](auto start, auto end) {
+                for(auto i = start; i < end; i++)
+                {
+                    const auto& rs   = samples[i / channels];
+                    const auto* data = x_ptr + (rs.batch * channels + i % channels) * in_size;
+                    auto* out        = out_ptr + i * out_size;
+                    for(std::size_t j = 0; j < out_size; j++)
+                        out[j] = pool(data, rs, j * rs.count, average);
+                }
+            });
+        });
+
+        return args.back();
+    }
+
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return shapes.size() - 1;
+    }
+};
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
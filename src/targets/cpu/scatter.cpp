@@ -0,0 +1,207 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/config.hpp>
+#include <migraphx/context.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/op/scatter_add.hpp>
+#include <migraphx/op/scatter_mul.hpp>
+#include <migraphx/op/scatter_none.hpp>
+#include <migraphx/op/scatternd_add.hpp>
+#include <migraphx/op/scatternd_mul.hpp>
+#include <migraphx/op/scatternd_none.hpp>
+#include <migraphx/register_op.hpp>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+template <class F>
+void copy_data(context& ctx, const argument& data, const argument& result, F f)
+{
+    visit_all(result, data)([&](auto output, auto input) {
+        const auto* in_ptr = input.data();
+        auto* out_ptr      = output.data();
+        ctx.bulk_execute(output.get_shape().elements(), 4096, [=](auto start, auto end) {
+            std::copy(in_ptr + start, in_ptr + end, out_ptr + start);
+        });
+        f(out_ptr);
+    });
+}
+
+// Updates that land on the same output element are always applied by the same thread, in the
+// order of the indices, so duplicate indices give the same result as the reference operator
+template <class Op>
+struct cpu_scatter
+{
+    Op op;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return migraphx::reflect(self.op, f);
+    }
+    std::string name() const { return "cpu::" + op.name(); }
+    shape compute_shape(std::vector<shape> inputs) const
+    {
+        // Compensate for allocation
+        inputs.pop_back();
+        check_shapes(inputs, *this).standard();
+        return migraphx::compute_shape(op, inputs);
+    }
+
+    argument
+    compute(context& ctx, const shape& output_shape, const std::vector<argument>& args) const
+    {
+        auto axis      = op.axis;
+        auto ind_s     = args[1].get_shape();
+        auto comp_lens = ind_s.lens();
+        auto axis_len  = comp_lens[axis];
+        auto axis_dim  = static_cast<int64_t>(output_shape.lens()[axis]);
+        auto out_step  = output_shape.strides()[axis];
+        auto ind_step  = ind_s.strides()[axis];
+        // Every position of the indices outside of the axis owns a separate line of the output
+        comp_lens[axis] = 1;
+        shape comp_s{ind_s.type(), comp_lens};
+
+        copy_data(ctx, args[0], args.back(), [&](auto* out_ptr) {
+            using type = std::remove_pointer_t<decltype(out_ptr)>;
+
+            const auto* upd_ptr = args[2].cast<type>();
+            args[1].visit([&](auto indices) {
+                const auto* ind_ptr = indices.data();
+                ctx.bulk_execute(comp_s.elements(), 16, [=](auto start, auto end) {
+                    for(auto i = start; i < end; i++)
+                    {
+                        auto idx     = comp_s.multi(i);
+                        auto out_pos = output_shape.index(idx);
+                        auto ind_pos = ind_s.index(idx);
+                        for(std::size_t j = 0; j < axis_len; j++)
+                        {
+                            auto pos   = ind_pos + j * ind_step;
+                            auto index = static_cast<int64_t>(ind_ptr[pos]);
+                            index      = (index < 0) ? index + axis_dim : index;
+                            op.reduction()(out_ptr[out_pos + index * out_step], upd_ptr[pos]);
+                        }
+                    }
+                });
+            });
+        });
+
+        return args.back();
+    }
+
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return shapes.size() - 1;
+    }
+};
+
+MIGRAPHX_REGISTER_OP(cpu_scatter<op::scatter_none>)
+MIGRAPHX_REGISTER_OP(cpu_scatter<op::scatter_add>)
+MIGRAPHX_REGISTER_OP(cpu_scatter<op::scatter_mul>)
+
+// The output is split into ranges of each slice, and every thread applies all the updates in
+// order to its range, so duplicate indices are handled the same as the reference operator
+template <class Op>
+struct cpu_scatternd
+{
+    Op op;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return migraphx::reflect(self.op, f);
+    }
+    std::string name() const { return "cpu::" + op.name(); }
+    shape compute_shape(std::vector<shape> inputs) const
+    {
+        // Compensate for allocation
+        inputs.pop_back();
+        check_shapes(inputs, *this).standard();
+        return migraphx::compute_shape(op, inputs);
+    }
+
+    argument
+    compute(context& ctx, const shape& output_shape, const std::vector<argument>& args) const
+    {
+        const auto& out_lens = output_shape.lens();
+        const auto& ind_lens = args[1].get_shape().lens();
+        std::size_t k        = ind_lens.back();
+        std::size_t nupdates = std::accumulate(
+            ind_lens.begin(), ind_lens.end() - 1, std::size_t{1}, std::multiplies<>{});
+        std::size_t slice_size = std::accumulate(
+            out_lens.begin() + k, out_lens.end(), std::size_t{1}, std::multiplies<>{});
+
+        std::vector<std::size_t> offsets(nupdates);
+        args[1].visit([&](auto indices) {
+            for(std::size_t i = 0; i < nupdates; i++)
+            {
+                std::size_t offset = 0;
+                for(std::size_t j = 0; j < k; j++)
+                {
+                    auto dim   = static_cast<int64_t>(out_lens[j]);
+                    auto index = static_cast<int64_t>(indices[i * k + j]);
+                    if(index < -dim or index >= dim)
+                        MIGRAPHX_THROW("SCATTERND: index " + std::to_string(index) +
+                                       " is out of bounds for dim of len " + std::to_string(dim));
+                    if(index < 0)
+                        index += dim;
+                    offset += index * output_shape.strides()[j];
+                }
+                offsets[i] = offset;
+            }
+        });
+
+        copy_data(ctx, args[0], args.back(), [&](auto* out_ptr) {
+            using type = std::remove_pointer_t<decltype(out_ptr)>;
+
+            const auto* upd_ptr = args[2].cast<type>();
+            const auto* off_ptr = offsets.data();
+            ctx.bulk_execute(slice_size, 256, [=](auto start, auto end) {
+                for(std::size_t i = 0; i < nupdates; i++)
+                {
+                    auto* out       = out_ptr + off_ptr[i];
+                    const auto* upd = upd_ptr + i * slice_size;
+                    for(auto j = start; j < end; j++)
+                        op.reduction()(out[j], upd[j]);
+                }
+            });
+        });
+
+        return args.back();
+    }
+
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return shapes.size() - 1;
+    }
+};
+
+MIGRAPHX_REGISTER_OP(cpu_scatternd<op::scatternd_none>)
+MIGRAPHX_REGISTER_OP(cpu_scatternd<op::scatternd_add>)
+MIGRAPHX_REGISTER_OP(cpu_scatternd<op::scatternd_mul>)
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
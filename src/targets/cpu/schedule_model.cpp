@@ -0,0 +1,285 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/cpu/schedule_model.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/register_op.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/operation.hpp>
+#include <migraphx/op/identity.hpp>
+#include <cstring>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+struct record_event
+{
+    std::size_t event = 0;
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.event, "event"));
+    }
+    std::string name() const { return "cpu::record_event"; }
+    shape compute_shape(const std::vector<shape>&) const { return {}; }
+
+    argument compute(context& ctx, const shape&, const std::vector<argument>&) const
+    {
+        auto& e = ctx.get_event(event);
+        e.record();
+        ctx.get_stream().submit([&e] { e.signal(); });
+        return {};
+    }
+
+    void finalize(context& ctx, const shape&, const std::vector<shape>&) const
+    {
+        ctx.create_events(event);
+    }
+};
+
+struct wait_event
+{
+    std::size_t event = 0;
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.event, "event"));
+    }
+    std::string name() const { return "cpu::wait_event"; }
+    shape compute_shape(const std::vector<shape>&) const { return {}; }
+
+    argument compute(context& ctx, const shape&, const std::vector<argument>&) const
+    {
+        auto& e = ctx.get_event(event);
+        auto n  = e.recorded();
+        auto& s = ctx.get_stream();
+        s.submit_wait(e, n);
+        // Report the errors from the other streams once their results are used
+        if(not s.is_async())
+            ctx.check();
+        return {};
+    }
+};
+
+struct set_stream
+{
+    std::size_t stream = 0;
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.stream, "stream"));
+    }
+    std::string name() const { return "cpu::set_stream"; }
+    shape compute_shape(const std::vector<shape>&) const { return {}; }
+
+    argument compute(context& ctx, const shape&, const std::vector<argument>&) const
+    {
+        ctx.set_stream(stream);
+        return {};
+    }
+    void finalize(context& ctx, const shape&, const std::vector<shape>&) const
+    {
+        ctx.set_stream(stream);
+    }
+};
+
+// Submits the operator to the current stream. The output is returned before the stream has
+// computed it, which is safe since the scheduler inserts waits before it is read on another
+// stream. Operators that don't write to one of their inputs are given an allocation as the last
+// input, so that the output buffer is planned by memory_coloring.
+struct async_op
+{
+    operation op  = op::identity{};
+    bool allocate = false;
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return migraphx::reflect(self.op, f);
+    }
+    std::string name() const { return "cpu::async"; }
+    shape compute_shape(std::vector<shape> inputs, const std::vector<module_ref>& mods) const
+    {
+        if(allocate)
+            inputs.pop_back();
+        return op.compute_shape(inputs, mods);
+    }
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        if(allocate)
+            return shapes.size() - 1;
+        return op.output_alias(shapes);
+    }
+    void finalize(migraphx::context& ctx, const shape& output, std::vector<shape> inputs)
+    {
+        if(allocate)
+            inputs.pop_back();
+        op.finalize(ctx, output, inputs);
+    }
+    static std::vector<shape> to_shapes(const std::vector<argument>& args)
+    {
+        std::vector<shape> shapes(args.size());
+        std::transform(args.begin(), args.end(), shapes.begin(), [](const argument& a) {
+            return a.get_shape();
+        });
+        return shapes;
+    }
+    argument
+    compute(migraphx::context& gctx,
+            const shape& output_shape,
+            std::vector<argument> args,
+            const std::vector<module_ref>& mods,
+            const std::function<std::vector<argument>(
+                module_ref&, const std::unordered_map<std::string, argument>&)>& run) const
+    {
+        auto& s = any_cast<context>(gctx).get_stream();
+        argument result;
+        if(allocate)
+        {
+            result = args.back();
+            args.pop_back();
+        }
+        if(not s.is_async())
+        {
+            s.submit([&] {
+                result = copy_to(result, op.compute(gctx, output_shape, args, mods, run));
+            });
+            return result;
+        }
+        // Submodules are evaluated on this thread so wait for the inputs from the stream first
+        if(not mods.empty() or output_shape.type() == shape::tuple_type or
+           (not allocate and op.output_alias(to_shapes(args)) < 0))
+        {
+            s.wait();
+            return op.compute(gctx, output_shape, args, mods, run);
+        }
+        if(not allocate)
+            result = args[op.output_alias(to_shapes(args))].reshape(output_shape);
+        s.submit([=, ctx = gctx]() mutable {
+            copy_to(result, op.compute(ctx, output_shape, args, mods, run));
+        });
+        return result;
+    }
+    // Copies the output of the operator into the planned buffer, if it didn't write to it
+    static argument copy_to(const argument& result, const argument& r)
+    {
+        if(result.empty())
+            return r;
+        if(r.get_shape() != result.get_shape())
+            MIGRAPHX_THROW("cpu::async: Unexpected output shape");
+        if(r.data() != result.data())
+            std::memcpy(result.data(), r.data(), result.get_shape().bytes());
+        return result;
+    }
+    value to_value() const
+    {
+        value v;
+        v["name"]     = op.name();
+        v["operator"] = op.to_value();
+        v["allocate"] = allocate;
+        return v;
+    }
+    void from_value(const value& v)
+    {
+        op       = make_op(v.at("name").to<std::string>(), v.at("operator"));
+        allocate = v.at("allocate").to<bool>();
+    }
+    friend std::ostream& operator<<(std::ostream& os, const async_op& x)
+    {
+        os << "cpu::async::" << x.op;
+        return os;
+    }
+};
+
+MIGRAPHX_REGISTER_OP(record_event)
+MIGRAPHX_REGISTER_OP(wait_event)
+MIGRAPHX_REGISTER_OP(set_stream)
+MIGRAPHX_REGISTER_OP(async_op)
+
+std::size_t schedule_model::concurrency() const { return streams; }
+void schedule_model::sched(module& m, instruction_ref ins, std::size_t n) const
+{
+    if(ins->name().front() != '@')
+    {
+        const auto& op = ins->get_operator();
+        auto inputs    = ins->inputs();
+        bool allocate  = ins->module_inputs().empty() and
+                        ins->get_shape().type() != shape::tuple_type and
+                        op.output_alias(to_shapes(inputs)) < 0;
+        if(allocate)
+            inputs.push_back(m.insert_instruction(
+                ins, make_op("cpu::allocate", {{"shape", to_value(ins->get_shape())}})));
+        m.replace_instruction(ins, async_op{op, allocate}, inputs, ins->module_inputs());
+    }
+    auto last_stream = std::find_if(std::make_reverse_iterator(ins),
+                                    std::make_reverse_iterator(m.begin()),
+                                    [&](auto&& i) { return i.name() == "cpu::set_stream"; });
+    if(last_stream != std::make_reverse_iterator(m.begin()))
+    {
+        auto&& op = any_cast<set_stream>(last_stream->get_operator());
+        // If the same stream was set earlier then skip
+        if(op.stream == n)
+            return;
+    }
+    m.insert_instruction(ins, set_stream{n});
+}
+
+void schedule_model::wait(module& m, instruction_ref ins, std::size_t wait_id) const
+{
+    m.insert_instruction(ins, wait_event{wait_id});
+}
+void schedule_model::record(module& m, instruction_ref ins, std::size_t wait_id) const
+{
+    m.insert_instruction(std::next(ins), record_event{wait_id});
+}
+
+static std::unordered_map<std::string, std::size_t> create_weight_map()
+{
+    return {{"cpu::allocate", 0},
+            {"cpu::literal", 0},
+            {"dnnl::convolution", 8},
+            {"dnnl::deconvolution", 8},
+            {"dnnl::pooling", 4},
+            {"dnnl::dot", 4}};
+}
+
+static const std::unordered_map<std::string, std::size_t>& weight_map()
+{
+    static const std::unordered_map<std::string, std::size_t> m = create_weight_map();
+    return m;
+}
+
+std::size_t schedule_model::weight(const operation& op) const
+{
+    if(weight_map().count(op.name()) == 0)
+    {
+        return 2;
+    }
+    return weight_map().at(op.name());
+}
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -0,0 +1,209 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/cpu/stream.hpp>
+#include <migraphx/cpu/parallel.hpp>
+#include <migraphx/thread_pool.hpp>
+#include <algorithm>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+void event::record()
+{
+    std::lock_guard<std::mutex> lock(m);
+    nrecorded++;
+}
+
+std::size_t event::recorded() const
+{
+    std::lock_guard<std::mutex> lock(m);
+    return nrecorded;
+}
+
+void event::signal()
+{
+    std::vector<std::function<void()>> ready;
+    {
+        std::lock_guard<std::mutex> lock(m);
+        nsignaled++;
+        auto it = std::partition(
+            waiters.begin(), waiters.end(), [&](const auto& w) { return w.first > nsignaled; });
+        std::transform(std::make_move_iterator(it),
+                       std::make_move_iterator(waiters.end()),
+                       std::back_inserter(ready),
+                       [](auto w) { return std::move(w.second); });
+        waiters.erase(it, waiters.end());
+    }
+    cv.notify_all();
+    // The callbacks are called without the lock since they can submit more work
+    for(auto& f : ready)
+        f();
+}
+
+void event::wait(std::size_t n) const
+{
+    std::unique_lock<std::mutex> lock(m);
+    cv.wait(lock, [&] { return nsignaled >= n; });
+}
+
+bool event::notify(std::size_t n, std::function<void()> f)
+{
+    std::lock_guard<std::mutex> lock(m);
+    if(nsignaled >= n)
+        return false;
+    waiters.emplace_back(n, std::move(f));
+    return true;
+}
+
+template <class F>
+static void with_max_threads(std::size_t n, F f)
+{
+#ifdef MIGRAPHX_DISABLE_OMP
+    (void)n;
+    f();
+#else
+    auto prev = omp_get_max_threads();
+    omp_set_num_threads(n);
+    try
+    {
+        f();
+    }
+    catch(...)
+    {
+        omp_set_num_threads(prev);
+        throw;
+    }
+    omp_set_num_threads(prev);
+#endif
+}
+
+stream::stream(bool a, std::size_t n) : nthreads(std::max<std::size_t>(n, 1)), async(a) {}
+
+stream::~stream()
+{
+    std::unique_lock<std::mutex> lock(m);
+    cv.wait(lock, [&] { return not running; });
+}
+
+bool stream::is_async() const { return async; }
+
+void stream::execute(const std::function<void()>& f)
+{
+    try
+    {
+        with_max_threads(nthreads, f);
+    }
+    catch(...)
+    {
+        std::lock_guard<std::mutex> lock(m);
+        if(error == nullptr)
+            error = std::current_exception();
+    }
+}
+
+void stream::drain()
+{
+    for(;;)
+    {
+        item x;
+        {
+            std::lock_guard<std::mutex> lock(m);
+            if(queue.empty())
+            {
+                running = false;
+                cv.notify_all();
+                return;
+            }
+            x = std::move(queue.front());
+            queue.pop_front();
+        }
+        if(x.e != nullptr)
+        {
+            // Give the thread back to the pool until the event is signaled
+            if(x.e->notify(x.n, [this] { thread_pool::global().submit([this] { drain(); }); }))
+                return;
+            continue;
+        }
+        // Keep going after an error so that events are still signaled
+        execute(x.f);
+    }
+}
+
+void stream::push(item x)
+{
+    {
+        std::lock_guard<std::mutex> lock(m);
+        queue.push_back(std::move(x));
+        if(running)
+            return;
+        running = true;
+    }
+    thread_pool::global().submit([this] { drain(); });
+}
+
+void stream::submit(std::function<void()> f)
+{
+    if(not is_async())
+    {
+        execute(f);
+        check();
+        return;
+    }
+    push({std::move(f)});
+}
+
+void stream::submit_wait(event& e, std::size_t n)
+{
+    if(not is_async())
+    {
+        e.wait(n);
+        return;
+    }
+    push({nullptr, &e, n});
+}
+
+void stream::wait()
+{
+    {
+        std::unique_lock<std::mutex> lock(m);
+        cv.wait(lock, [&] { return not running; });
+    }
+    check();
+}
+
+void stream::check()
+{
+    std::exception_ptr e;
+    {
+        std::lock_guard<std::mutex> lock(m);
+        std::swap(e, error);
+    }
+    if(e != nullptr)
+        std::rethrow_exception(e);
+}
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -33,6 +33,7 @@
 #include <migraphx/eliminate_data_type.hpp>
 #include <migraphx/eliminate_identity.hpp>
 #include <migraphx/eliminate_pad.hpp>
+#include <migraphx/fuse_pointwise.hpp>
 #include <migraphx/memory_coloring.hpp>
 #include <migraphx/propagate_constant.hpp>
 #include <migraphx/register_target.hpp>
@@ -47,12 +48,17 @@
 #include <migraphx/simplify_qdq.hpp>
 #include <migraphx/simplify_reshapes.hpp>
 #include <migraphx/preallocate_param.hpp>
+#include <migraphx/cpu/blocked_layout.hpp>
+#include <migraphx/cpu/fuse_attention.hpp>
 #include <migraphx/cpu/fuse_ops.hpp>
 #include <migraphx/cpu/write_literals.hpp>
 #include <migraphx/cpu/allocation_model.hpp>
 #include <migraphx/cpu/target.hpp>
 #include <migraphx/cpu/context.hpp>
+#include <migraphx/cpu/device_name.hpp>
 #include <migraphx/cpu/lowering.hpp>
+#include <migraphx/cpu/prefuse_ops.hpp>
+#include <migraphx/cpu/schedule_model.hpp>
 #include <migraphx/pass.hpp>
 #include <migraphx/generate.hpp>
 #include <migraphx/normalize_ops.hpp>
@@ -61,6 +67,26 @@ namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 namespace cpu {
 
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_DISABLE_SCHEDULE_PASS)
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_DISABLE_POINTWISE_FUSION)
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_DISABLE_ATTENTION_FUSION)
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_DISABLE_BLOCKED_LAYOUT)
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_DISABLE_COMPACT_RNN)
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_DISABLE_DNNL_POST_OPS_WORKAROUND)
+
+struct id_pass
+{
+    std::string name() const { return "id"; }
+    void apply(const module&) const {}
+};
+
+static pass enable_pass(bool enabled, pass p)
+{
+    if(enabled)
+        return p;
+    return id_pass{};
+}
+
 std::string target::name() const { return "cpu"; }
 
 // cppcheck-suppress constParameter
@@ -68,7 +94,17 @@ std::vector<pass> target::get_passes(migraphx::context& gctx, const compile_opti
 {
     auto& ctx = any_cast<context>(gctx);
     std::set<shape::type_t> unsupported_types(shape::types().begin(), shape::types().end());
-    unsupported_types.erase(shape::type_t::float_type);
+    // These types are executed natively, and lowering converts to float for any operator
+    // that doesn't have an implementation for them
+    for(auto t : {shape::type_t::float_type,
+                  shape::type_t::half_type,
+                  shape::type_t::int8_type,
+                  shape::type_t::uint8_type,
+                  shape::type_t::int32_type})
+        unsupported_types.erase(t);
+    memory_coloring coloring{"cpu::allocate"};
+    // The jit pointwise kernels can run in place
+    coloring.reuse_pointwise = true;
     return {normalize_ops{},
             rewrite_quantization{},
             dead_code_elimination{},
@@ -80,7 +116,7 @@ std::vector<pass> target::get_passes(migraphx::context& gctx, const compile_opti
             dead_code_elimination{},
             rewrite_batchnorm{},
             dead_code_elimination{},
-            rewrite_rnn{},
+            rewrite_rnn{not enabled(MIGRAPHX_DISABLE_COMPACT_RNN{})},
             dead_code_elimination{},
             eliminate_common_subexpression{},
             dead_code_elimination{},
@@ -91,7 +127,17 @@ std::vector<pass> target::get_passes(migraphx::context& gctx, const compile_opti
             simplify_reshapes{},
             propagate_constant{},
             dead_code_elimination{},
-            lowering{},
+            prefuse_ops{},
+            dead_code_elimination{},
+            enable_pass(not enabled(MIGRAPHX_DISABLE_ATTENTION_FUSION{}), fuse_attention{}),
+            dead_code_elimination{},
+            // With the post ops workaround disabled fuse_ops merges elementwise operators into
+            // the dnnl operators that produce their inputs, which the fused modules would hide
+            enable_pass(not enabled(MIGRAPHX_DISABLE_POINTWISE_FUSION{}) and
+                            not enabled(MIGRAPHX_DISABLE_DNNL_POST_OPS_WORKAROUND{}),
+                        fuse_pointwise{}),
+            dead_code_elimination{},
+            lowering{&ctx},
             eliminate_contiguous{"dnnl::reorder"},
             dead_code_elimination{},
             replace_allocate{cpu_allocation_model{}},
@@ -100,9 +146,13 @@ std::vector<pass> target::get_passes(migraphx::context& gctx, const compile_opti
             dead_code_elimination{},
             fuse_ops{&ctx},
             dead_code_elimination{},
+            enable_pass(not enabled(MIGRAPHX_DISABLE_BLOCKED_LAYOUT{}), blocked_layout{}),
+            dead_code_elimination{},
             write_literals{},
             dead_code_elimination{},
-            memory_coloring{"cpu::allocate"},
+            schedule{cpu::schedule_model{ctx.nstreams()},
+                     ctx.nstreams() > 1 and not enabled(MIGRAPHX_DISABLE_SCHEDULE_PASS{})},
+            coloring,
             dead_code_elimination{},
             preallocate_param{"scratch", cpu_allocation_model{}},
             dead_code_elimination{}};
@@ -110,6 +160,9 @@ std::vector<pass> target::get_passes(migraphx::context& gctx, const compile_opti
 
 argument target::allocate(const shape& s) const { return fill_argument(s, 0); }
 
+// Pointwise kernels are built with -march=native, so they are tied to the host cpu
+std::string target::device_identity() const { return get_device_name(); }
+
 MIGRAPHX_REGISTER_TARGET(target);
 
 } // namespace cpu
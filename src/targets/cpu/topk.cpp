@@ -0,0 +1,114 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/config.hpp>
+#include <migraphx/context.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/op/topk.hpp>
+#include <migraphx/register_op.hpp>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+struct cpu_topk : auto_register_op<cpu_topk>
+{
+    op::topk op;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return migraphx::reflect(self.op, f);
+    }
+    std::string name() const { return "cpu::" + op.name(); }
+    shape compute_shape(std::vector<shape> inputs) const
+    {
+        // Compensate for allocation
+        inputs.pop_back();
+        check_shapes(inputs, *this).standard();
+        return migraphx::compute_shape(op, inputs);
+    }
+
+    argument compute(context& ctx, const shape&, const std::vector<argument>& args) const
+    {
+        auto outputs         = args.back().get_sub_objects();
+        const auto& in_lens  = args.front().get_shape().lens();
+        std::size_t axis_dim = in_lens[op.axis];
+        std::size_t k        = op.k;
+        std::size_t inner    = std::accumulate(in_lens.begin() + op.axis + 1,
+                                            in_lens.end(),
+                                            std::size_t{1},
+                                            std::multiplies<>{});
+        std::size_t nslices  = args.front().get_shape().elements() / axis_dim;
+        bool largest         = op.largest;
+
+        visit_all(outputs.front(), args.front())([&](auto out_val, auto input) {
+            const auto* in_ptr = input.data();
+            auto* val_ptr      = out_val.data();
+            auto* ind_ptr      = outputs.back().cast<int64_t>();
+            ctx.bulk_execute(nslices, 1, [=](auto start, auto end) {
+                std::vector<int64_t> indices(axis_dim);
+                for(auto i = start; i < end; i++)
+                {
+                    auto outer      = i / inner;
+                    auto in_start   = outer * axis_dim * inner + i % inner;
+                    auto out_start  = outer * k * inner + i % inner;
+                    const auto* x   = in_ptr + in_start;
+                    auto compare    = [&](auto i1, auto i2) {
+                        auto x1 = x[i1 * inner];
+                        auto x2 = x[i2 * inner];
+                        // Compare exactly and keep the lowest index first on ties, so this stays
+                        // a strict weak ordering
+                        if(largest)
+                            return std::greater<>{}(std::make_pair(x1, -i1),
+                                                    std::make_pair(x2, -i2));
+                        return std::less<>{}(std::make_pair(x1, i1), std::make_pair(x2, i2));
+                    };
+                    std::iota(indices.begin(), indices.end(), 0);
+                    // Only the first k elements are needed in order, so select them first and
+                    // then sort just those
+                    if(k < axis_dim)
+                        std::nth_element(
+                            indices.begin(), indices.begin() + k, indices.end(), compare);
+                    std::sort(indices.begin(), indices.begin() + k, compare);
+                    for(std::size_t j = 0; j < k; j++)
+                    {
+                        val_ptr[out_start + j * inner] = x[indices[j] * inner];
+                        ind_ptr[out_start + j * inner] = indices[j];
+                    }
+                }
+            });
+        });
+
+        return args.back();
+    }
+
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return shapes.size() - 1;
+    }
+};
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
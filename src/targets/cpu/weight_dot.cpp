@@ -0,0 +1,128 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/config.hpp>
+#include <migraphx/context.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/op/weight_dot.hpp>
+#include <migraphx/register_op.hpp>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+struct cpu_weight_dot : auto_register_op<cpu_weight_dot>
+{
+    op::weight_dot op;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return migraphx::reflect(self.op, f);
+    }
+    std::string name() const { return "cpu::" + op.name(); }
+    shape compute_shape(std::vector<shape> inputs) const
+    {
+        // Compensate for allocation
+        inputs.pop_back();
+        return migraphx::compute_shape(op, inputs);
+    }
+
+    // Number of rows and output columns computed together
+    static constexpr std::size_t row_block = 64;
+    static constexpr std::size_t col_block = 16;
+
+    argument
+    compute(context& ctx, const shape& output_shape, const std::vector<argument>& args) const
+    {
+        auto k          = args[0].get_shape().lens().back();
+        auto n          = output_shape.lens().back();
+        auto rows       = output_shape.elements() / n;
+        auto stride     = args[1].get_shape().lens()[1];
+        auto group_size = op.group_size;
+        auto groups     = k / group_size;
+        auto row_blocks = (rows + row_block - 1) / row_block;
+        auto col_blocks = (n + col_block - 1) / col_block;
+        const auto* w   = args[1].cast<int8_t>();
+        visit_all(args.back(), args[0], args[2])([&](auto output, auto a, auto scales) {
+            const auto* a_ptr = a.data();
+            const auto* s_ptr = scales.data();
+            auto* out_ptr     = output.data();
+            // The output is split into tiles of rows and columns. A group of the weights of the
+            // tile's columns is dequantized once for all its rows, and the activations of the
+            // rows are reused across its columns while they are in cache.
+            ctx.bulk_execute(row_blocks * col_blocks, 1, [=](auto start, auto end) {
+                std::vector<float> weights(col_block * group_size);
+                std::vector<float> sums(row_block * col_block);
+                for(auto tile = start; tile < end; tile++)
+                {
+                    auto col_start = (tile / row_blocks) * col_block;
+                    auto col_end   = std::min(n, col_start + col_block);
+                    auto row_start = (tile % row_blocks) * row_block;
+                    auto row_end   = std::min(rows, row_start + row_block);
+                    std::fill(sums.begin(), sums.end(), 0.0f);
+                    for(std::size_t g = 0; g < groups; g++)
+                    {
+                        for(auto col = col_start; col < col_end; col++)
+                        {
+                            const auto* row = w + col * stride;
+                            float scale     = s_ptr[col * groups + g];
+                            auto* wg        = weights.data() + (col - col_start) * group_size;
+                            for(std::size_t j = 0; j < group_size; j++)
+                                wg[j] = scale * op.unpack(row, g * group_size + j);
+                        }
+                        for(auto r = row_start; r < row_end; r++)
+                        {
+                            const auto* x = a_ptr + r * k + g * group_size;
+                            auto* rsums   = sums.data() + (r - row_start) * col_block;
+                            for(auto col = col_start; col < col_end; col++)
+                            {
+                                const auto* wg = weights.data() + (col - col_start) * group_size;
+                                float sum      = 0;
+                                for(std::size_t j = 0; j < group_size; j++)
+                                    sum += static_cast<float>(x[j]) * wg[j];
+                                rsums[col - col_start] += sum;
+                            }
+                        }
+                    }
+                    for(auto r = row_start; r < row_end; r++)
+                    {
+                        const auto* rsums = sums.data() + (r - row_start) * col_block;
+                        for(auto col = col_start; col < col_end; col++)
+                            out_ptr[r * n + col] = rsums[col - col_start];
+                    }
+                }
+            });
+        });
+        return args.back();
+    }
+
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return shapes.size() - 1;
+    }
+};
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -25,6 +25,7 @@
 #include <migraphx/module.hpp>
 #include <migraphx/instruction.hpp>
 #include <migraphx/iterator_for.hpp>
+#include <migraphx/make_op.hpp>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -59,6 +60,18 @@ void write_literals::apply(module& m) const
     {
         if(ins->name() != "@literal")
             continue;
+        // Constant weights only need to be reordered into the primitive's layout once
+        auto outputs = ins->outputs();
+        for(auto output : outputs)
+        {
+            if(output->inputs().size() < 2 or output->inputs()[1] != ins)
+                continue;
+            auto v = output->get_operator().to_value();
+            if(not v.contains("prepack_weights") or v.at("prepack_weights").to<bool>())
+                continue;
+            v["prepack_weights"] = true;
+            m.replace_instruction(output, make_op(output->name(), v), output->inputs());
+        }
         m.replace_instruction(ins, cpu_literal{ins->get_literal().get_argument()});
     }
 }
@@ -52,13 +52,21 @@ int get_device_id()
     return device;
 }
 
-std::string get_device_name()
+static hipDeviceProp_t get_device_properties()
 {
     hipDeviceProp_t props{};
     auto status = hipGetDeviceProperties(&props, get_device_id());
     if(status != hipSuccess)
         MIGRAPHX_THROW("Failed to get device properties");
-    return get_arch_name(rank<1>{}, props);
+    return props;
+}
+
+std::string get_device_name() { return get_arch_name(rank<1>{}, get_device_properties()); }
+
+std::string get_device_identity()
+{
+    auto props = get_device_properties();
+    return get_arch_name(rank<1>{}, props) + ";" + std::string(props.name);
 }
 
 } // namespace gpu
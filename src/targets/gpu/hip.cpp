@@ -25,6 +25,7 @@
 #include <migraphx/gpu/hip.hpp>
 
 #include <migraphx/manage_ptr.hpp>
+#include <migraphx/ranges.hpp>
 #include <migraphx/register_op.hpp>
 #include <migraphx/gpu/context.hpp>
 #include <migraphx/gpu/device/contiguous.hpp>
@@ -231,6 +232,11 @@ argument get_preallocation(context& ctx, const std::string& id)
     return ctx.get_current_device().preallocations.at(id);
 }
 
+bool has_preallocation(context& ctx, const std::string& id)
+{
+    return contains(ctx.get_current_device().preallocations, id);
+}
+
 void store_preallocated_param(context& ctx, const std::string& id, const argument& a)
 {
     ctx.get_current_device().preallocations[id] = a;
@@ -33,6 +33,9 @@ namespace gpu {
 
 std::string get_device_name();
 
+/// The architecture with its features followed by the name of the device
+std::string get_device_identity();
+
 } // namespace gpu
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
@@ -29,6 +29,8 @@
 #include <migraphx/literal.hpp>
 #include <migraphx/check_shapes.hpp>
 #include <migraphx/functional.hpp>
+#include <memory>
+#include <mutex>
 #include <utility>
 
 namespace migraphx {
@@ -55,6 +57,7 @@ void copy_to_gpu(context& ctx, const argument& src, const argument& dst);
 void copy_from_gpu(context& ctx, const argument& src, const argument& dst);
 
 argument get_preallocation(context& ctx, const std::string& id);
+bool has_preallocation(context& ctx, const std::string& id);
 
 struct hip_allocate
 {
@@ -188,8 +191,12 @@ struct hip_allocate_memory
         return s;
     }
 
-    argument compute(context& ctx, const shape&, const std::vector<argument>&) const
+    argument compute(context& ctx, const shape& output_shape, const std::vector<argument>&) const
     {
+        // The memory is written to, so unlike literals each context needs its own. A context
+        // created after the program was finalized allocates on first use.
+        if(not has_preallocation(ctx, id))
+            finalize(ctx, output_shape, {});
         return get_preallocation(ctx, id);
     }
 
@@ -205,6 +212,14 @@ struct hip_copy_literal
     literal l;
     std::string id{};
 
+    // The literal is constant, so every context of the program shares one device copy
+    struct device_literal
+    {
+        std::once_flag flag;
+        argument data;
+    };
+    std::shared_ptr<device_literal> buffer = std::make_shared<device_literal>();
+
     template <class Self, class F>
     static auto reflect(Self& self, F f)
     {
@@ -218,16 +233,19 @@ struct hip_copy_literal
         return l.get_shape();
     }
 
-    argument compute(context& ctx, const shape&, const std::vector<argument>&) const
+    argument compute(context&, const shape&, const std::vector<argument>&) const
     {
-        return get_preallocation(ctx, id);
+        return get_buffer();
     }
 
-    void finalize(context& ctx, const shape&, const std::vector<shape>&) const
+    void finalize(context&, const shape&, const std::vector<shape>&) const { get_buffer(); }
+
+    argument get_buffer() const
     {
-        argument a = to_gpu(l.get_argument());
-        store_preallocated_param(ctx, id, a);
+        std::call_once(buffer->flag, [&] { buffer->data = to_gpu(l.get_argument()); });
+        return buffer->data;
     }
+
     friend std::ostream& operator<<(std::ostream& os, const hip_copy_literal& x)
     {
         os << x.name() << "[id=" << x.id << "]";
@@ -41,6 +41,7 @@ struct target
     argument copy_to(const argument& arg) const;
     argument copy_from(const argument& arg) const;
     argument allocate(const shape& s) const;
+    std::string device_identity() const;
 };
 
 } // namespace gpu
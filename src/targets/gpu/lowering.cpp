@@ -232,7 +232,7 @@ struct miopen_apply
             for(const auto& in : inputs)
             {
                 auto p_output = mod->insert_instruction(ret, make_op("hip::copy_from_gpu"), in);
-                instruction::replace_argument(ret, in, p_output);
+                mod->replace_argument(ret, in, p_output);
             }
         }
         // else branch to handle legacy program without the return instruction
@@ -192,7 +192,7 @@ void pack_int8_args::apply(module& m) const
                         {{"shape", to_value(pack_int8_shape(inputs[0]->get_shape()))}}));
             auto output_x =
                 m.insert_instruction(ins, make_op("gpu::int8_conv_pack"), {inputs[0], packed_x});
-            instruction::replace_argument(ins, inputs[0], output_x);
+            m.replace_argument(ins, inputs[0], output_x);
 
             auto packed_w = m.insert_instruction(
                 ins,
@@ -200,7 +200,7 @@ void pack_int8_args::apply(module& m) const
                         {{"shape", to_value(pack_int8_shape(inputs[1]->get_shape()))}}));
             auto output_w =
                 m.insert_instruction(ins, make_op("gpu::int8_conv_pack"), {inputs[1], packed_w});
-            instruction::replace_argument(ins, inputs[1], output_w);
+            m.replace_argument(ins, inputs[1], output_w);
         }
     }
 }
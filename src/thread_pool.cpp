@@ -0,0 +1,297 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/thread_pool.hpp>
+#include <migraphx/env.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_NUM_THREADS)
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_THREAD_AFFINITY)
+
+namespace {
+
+struct job
+{
+    const std::function<void(std::size_t)>* f = nullptr;
+    std::atomic<std::size_t> remaining{0};
+    std::mutex m;
+    std::exception_ptr error = nullptr;
+
+    // Returns true for the last task, after which the job can no longer be accessed
+    bool execute(std::size_t i)
+    {
+        try
+        {
+            (*f)(i);
+        }
+        catch(...)
+        {
+            std::lock_guard<std::mutex> lock(m);
+            if(error == nullptr)
+                error = std::current_exception();
+        }
+        return --remaining == 0;
+    }
+
+    bool done() const { return remaining == 0; }
+};
+
+struct task
+{
+    job* j        = nullptr;
+    std::size_t i = 0;
+};
+
+struct task_queue
+{
+    std::mutex m;
+    std::deque<task> tasks;
+
+    // The owner takes the most recent task since its data is more likely to be in cache
+    bool pop(task& t)
+    {
+        std::lock_guard<std::mutex> lock(m);
+        if(tasks.empty())
+            return false;
+        t = tasks.back();
+        tasks.pop_back();
+        return true;
+    }
+
+    bool steal(task& t)
+    {
+        std::lock_guard<std::mutex> lock(m);
+        if(tasks.empty())
+            return false;
+        t = tasks.front();
+        tasks.pop_front();
+        return true;
+    }
+};
+
+void set_affinity(std::thread& t, std::size_t i)
+{
+#ifdef __linux__
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(i % std::max(1u, std::thread::hardware_concurrency()), &cpus);
+    pthread_setaffinity_np(t.native_handle(), sizeof(cpu_set_t), &cpus);
+#else
+    (void)t;
+    (void)i;
+#endif
+}
+
+} // namespace
+
+struct thread_pool_impl
+{
+    // Queue 0 is shared by the threads outside of the pool, the others belong to a worker
+    std::vector<task_queue> queues;
+    std::vector<std::thread> workers;
+    std::atomic<std::size_t> pending{0};
+    // Tasks that nobody waits for, which are guarded by m
+    std::deque<std::function<void()>> detached;
+    std::mutex m;
+    std::condition_variable cv;
+    bool stopped = false;
+
+    static thread_local thread_pool_impl* current_pool;
+    static thread_local std::size_t current_queue;
+
+    thread_pool_impl(std::size_t n, bool affinity) : queues(std::max<std::size_t>(n, 1))
+    {
+        for(std::size_t i = 1; i < queues.size(); i++)
+        {
+            workers.emplace_back([this, i] { this->work(i); });
+            if(affinity)
+                set_affinity(workers.back(), i);
+        }
+    }
+
+    ~thread_pool_impl()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m);
+            stopped = true;
+        }
+        cv.notify_all();
+        for(auto& w : workers)
+            w.join();
+    }
+
+    std::size_t queue_index() const { return current_pool == this ? current_queue : 0; }
+
+    bool try_get(std::size_t q, task& t)
+    {
+        if(queues[q].pop(t))
+            return true;
+        for(std::size_t k = 1; k < queues.size(); k++)
+        {
+            if(queues[(q + k) % queues.size()].steal(t))
+                return true;
+        }
+        return false;
+    }
+
+    bool try_execute(std::size_t q)
+    {
+        task t;
+        if(not try_get(q, t))
+            return false;
+        pending--;
+        if(t.j->execute(t.i))
+        {
+            // Wake up the thread waiting for the job
+            std::lock_guard<std::mutex> lock(m);
+            cv.notify_all();
+        }
+        return true;
+    }
+
+    void work(std::size_t q)
+    {
+        current_pool  = this;
+        current_queue = q;
+        for(;;)
+        {
+            if(try_execute(q))
+                continue;
+            std::function<void()> f;
+            {
+                std::unique_lock<std::mutex> lock(m);
+                cv.wait(lock, [&] { return stopped or pending > 0 or not detached.empty(); });
+                if(stopped)
+                    return;
+                if(pending > 0 or detached.empty())
+                    continue;
+                f = std::move(detached.front());
+                detached.pop_front();
+            }
+            f();
+        }
+    }
+
+    void submit(std::function<void()> f)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m);
+            detached.push_back(std::move(f));
+        }
+        cv.notify_all();
+    }
+
+    void submit(job& j, std::size_t n)
+    {
+        auto q = queue_index();
+        // Count the tasks before they are visible so pending can never underflow
+        {
+            std::lock_guard<std::mutex> lock(m);
+            pending += n - 1;
+        }
+        for(std::size_t i = 1; i < n; i++)
+        {
+            // Threads outside of the pool spread the tasks over all the queues, while the
+            // workers keep them in their own queue for the idle workers to steal
+            auto& tq = q == 0 ? queues[i % queues.size()] : queues[q];
+            std::lock_guard<std::mutex> lock(tq.m);
+            tq.tasks.push_back(task{&j, i});
+        }
+        cv.notify_all();
+        j.execute(0);
+        // Help with any pending task while waiting, since the tasks of this job can be queued
+        // behind tasks of a nested job
+        while(not j.done())
+        {
+            if(try_execute(q))
+                continue;
+            std::unique_lock<std::mutex> lock(m);
+            cv.wait_for(
+                lock, std::chrono::milliseconds{1}, [&] { return pending > 0 or j.done(); });
+        }
+    }
+};
+
+thread_local thread_pool_impl* thread_pool_impl::current_pool = nullptr;
+thread_local std::size_t thread_pool_impl::current_queue      = 0;
+
+thread_pool::thread_pool(std::size_t n, bool affinity)
+    : impl(std::make_unique<thread_pool_impl>(n, affinity))
+{
+}
+
+thread_pool::~thread_pool() {}
+
+std::size_t thread_pool::size() const { return impl->queues.size(); }
+
+void thread_pool::run(std::size_t n, const std::function<void(std::size_t)>& f)
+{
+    if(n == 0)
+        return;
+    if(n == 1 or size() == 1)
+    {
+        for(std::size_t i = 0; i < n; i++)
+            f(i);
+        return;
+    }
+    job j;
+    j.f         = &f;
+    j.remaining = n;
+    impl->submit(j, n);
+    if(j.error != nullptr)
+        std::rethrow_exception(j.error);
+}
+
+void thread_pool::submit(std::function<void()> f)
+{
+    if(size() == 1)
+        f();
+    else
+        impl->submit(std::move(f));
+}
+
+thread_pool& thread_pool::global()
+{
+    static thread_pool pool{
+        value_of(MIGRAPHX_NUM_THREADS{}, std::max(1u, std::thread::hardware_concurrency())),
+        enabled(MIGRAPHX_THREAD_AFFINITY{})};
+    return pool;
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
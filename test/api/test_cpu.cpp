@@ -45,6 +45,23 @@ TEST_CASE(load_and_run)
     CHECK(bool{shapes_before.front() == outputs.front().get_shape()});
 }
 
+TEST_CASE(load_and_run_session)
+{
+    auto p = migraphx::parse_onnx("conv_relu_maxpool_test.onnx");
+    p.compile(migraphx::target("ref"));
+    migraphx::program_parameters pp;
+    auto param_shapes = p.get_parameter_shapes();
+    for(auto&& name : param_shapes.names())
+    {
+        pp.add(name, migraphx::argument::generate(param_shapes[name]));
+    }
+    migraphx::execution_session session{p};
+    auto outputs  = session.eval(pp);
+    auto expected = p.eval(pp);
+    CHECK(outputs.size() == expected.size());
+    CHECK(bool{outputs.front() == expected.front()});
+}
+
 TEST_CASE(load_and_run_init_list)
 {
     auto p             = migraphx::parse_onnx("conv_relu_maxpool_test.onnx");
@@ -0,0 +1,220 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/calibration.hpp>
+#include <migraphx/apply_alpha_beta.hpp>
+#include <migraphx/file_buffer.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/json.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/quantization.hpp>
+#include <migraphx/ref/target.hpp>
+#include <migraphx/tmp_dir.hpp>
+#include <numeric>
+#include "test.hpp"
+
+static migraphx::argument make_arg(std::vector<float> v)
+{
+    migraphx::shape s{migraphx::shape::float_type, {v.size()}};
+    migraphx::argument a{s};
+    std::copy(v.begin(), v.end(), a.cast<float>());
+    return a;
+}
+
+// Mostly small values with a single large outlier
+static std::vector<float> outlier_data()
+{
+    std::vector<float> v(10000);
+    for(std::size_t i = 0; i < v.size(); i++)
+        v[i] = ((i % 200) / 100.0f - 1.0f) * ((i % 2 == 0) ? 1.0f : -1.0f);
+    v[1234] = 50.0f;
+    return v;
+}
+
+static std::size_t total(const migraphx::calibration_histogram& h)
+{
+    return std::accumulate(h.counts.begin(), h.counts.end(), std::size_t{0});
+}
+
+TEST_CASE(histogram_max)
+{
+    migraphx::calibration_histogram h;
+    h.update(make_arg({0.5f, -2.0f, 1.0f}));
+    h.update(make_arg({-0.25f, 3.0f}));
+    EXPECT(h.runs == 2);
+    EXPECT(total(h) == 5);
+    EXPECT(migraphx::float_equal(h.max_abs, 3.0f));
+    EXPECT(h.range >= 3.0f);
+    migraphx::calibration_options options;
+    EXPECT(migraphx::float_equal(h.threshold(options), 3.0f));
+    auto params = h.quant_params(options);
+    EXPECT(migraphx::float_equal(params.first, 127.0f / 3.0f));
+    EXPECT(migraphx::float_equal(params.second, 0.0f));
+}
+
+TEST_CASE(histogram_asymmetric)
+{
+    migraphx::calibration_histogram h;
+    h.update(make_arg({0.5f, 1.0f, 2.0f}));
+    h.update(make_arg({-0.55f, 1.5f}));
+    EXPECT(migraphx::float_equal(h.min_value, -0.55f));
+    EXPECT(migraphx::float_equal(h.max_value, 2.0f));
+    migraphx::calibration_options options;
+    auto params = h.quant_params(options, true);
+    EXPECT(migraphx::float_equal(params.first, 100.0f));
+    EXPECT(migraphx::float_equal(params.second, 55.0f));
+}
+
+TEST_CASE(histogram_zero)
+{
+    migraphx::calibration_histogram h;
+    migraphx::calibration_options options;
+    EXPECT(migraphx::float_equal(h.quant_params(options).first, 64.0f));
+    h.update(make_arg({0.0f, 0.0f}));
+    EXPECT(h.counts.front() == 2);
+    EXPECT(migraphx::float_equal(h.quant_params(options).first, 1.0f));
+    h.update(make_arg({1.0f, -1.0f}));
+    EXPECT(h.counts.front() == 2);
+    EXPECT(h.counts.back() == 2);
+}
+
+TEST_CASE(histogram_grow)
+{
+    migraphx::calibration_histogram h{16};
+    h.update(make_arg({0.1f, 0.2f, 0.3f, 1.0f}));
+    auto range = h.range;
+    auto small = h.counts;
+    h.update(make_arg({7.5f}));
+    EXPECT(total(h) == 5);
+    EXPECT(h.range >= 7.5f);
+    EXPECT(h.range == range * 8);
+    // The small values are merged into the first bins
+    EXPECT(h.counts[0] == small[0] + small[1] + small[2] + small[3] + small[4] + small[5] +
+                             small[6] + small[7]);
+}
+
+TEST_CASE(histogram_percentile)
+{
+    migraphx::calibration_histogram h;
+    h.update(make_arg(outlier_data()));
+    migraphx::calibration_options options;
+    options.method     = migraphx::calibration_method::percentile;
+    options.percentile = 99.9;
+    auto t             = h.threshold(options);
+    EXPECT(t >= 1.0f);
+    EXPECT(t < 1.1f);
+}
+
+TEST_CASE(histogram_entropy)
+{
+    migraphx::calibration_histogram h;
+    h.update(make_arg(outlier_data()));
+    migraphx::calibration_options options;
+    options.method = migraphx::calibration_method::entropy;
+    auto t         = h.threshold(options);
+    EXPECT(t >= 0.9f);
+    EXPECT(t < 5.0f);
+}
+
+TEST_CASE(method_names)
+{
+    for(std::string name : {"max", "percentile", "entropy"})
+        EXPECT(migraphx::to_string(migraphx::to_calibration_method(name)) == name);
+    EXPECT(test::throws([] { migraphx::to_calibration_method("kl"); }));
+}
+
+static migraphx::program create_dot_program()
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape sa{migraphx::shape::float_type, {2, 16}};
+    migraphx::shape sb{migraphx::shape::float_type, {16, 8}};
+    auto pa = mm->add_parameter("a", sa);
+    auto pb = mm->add_parameter("b", sb);
+    auto r  = migraphx::add_apply_alpha_beta(*mm, {pa, pb}, migraphx::make_op("dot"));
+    mm->add_return({r});
+    return p;
+}
+
+TEST_CASE(calibration_table)
+{
+    migraphx::tmp_dir td{"calibration"};
+    auto table         = (td.path / "table.json").string();
+    migraphx::target t = migraphx::ref::target{};
+
+    migraphx::parameter_map m;
+    for(auto&& x : create_dot_program().get_parameter_shapes())
+        m[x.first] = migraphx::generate_argument(x.second, x.first.size());
+
+    migraphx::calibration_options options;
+    options.method = migraphx::calibration_method::entropy;
+    options.table  = table;
+
+    auto p1 = create_dot_program();
+    migraphx::quantize_int8(p1, t, {m}, {"dot"}, options);
+    EXPECT(migraphx::fs::exists(table));
+    auto key        = migraphx::from_json_string(migraphx::read_string(table)).at("key");
+    auto histograms = migraphx::load_calibration_table(table, key.to<std::string>());
+    EXPECT(test::throws([&] { migraphx::load_calibration_table(table, "other"); }));
+    EXPECT(histograms.size() == 2);
+    EXPECT(std::all_of(histograms.begin(), histograms.end(), [](const auto& h) {
+        return h.runs == 1;
+    }));
+
+    // Reuses the table without any calibration data
+    auto p2 = create_dot_program();
+    migraphx::quantize_int8(p2, t, {}, {"dot"}, options);
+    EXPECT(p1 == p2);
+}
+
+TEST_CASE(calibration_table_mismatch)
+{
+    migraphx::tmp_dir td{"calibration"};
+    migraphx::target t = migraphx::ref::target{};
+    migraphx::parameter_map m;
+    for(auto&& x : create_dot_program().get_parameter_shapes())
+        m[x.first] = migraphx::generate_argument(x.second, x.first.size());
+
+    migraphx::calibration_options options;
+    options.table = (td.path / "table.json").string();
+    auto p1       = create_dot_program();
+    migraphx::quantize_int8(p1, t, {m}, {"dot"}, options);
+
+    // A table collected with another number of bins is rejected
+    options.bins = 1024;
+    auto p2      = create_dot_program();
+    EXPECT(test::throws([&] { migraphx::quantize_int8(p2, t, {}, {"dot"}, options); }));
+
+    // So is a table from another program with the same number of entries
+    options.bins = 2048;
+    auto p3      = create_dot_program();
+    auto* mm     = p3.get_main_module();
+    auto ret     = std::prev(mm->end());
+    auto relu    = mm->insert_instruction(ret, migraphx::make_op("relu"), ret->inputs().front());
+    mm->replace_return({relu});
+    EXPECT(test::throws([&] { migraphx::quantize_int8(p3, t, {}, {"dot"}, options); }));
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
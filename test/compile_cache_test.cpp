@@ -0,0 +1,217 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/compile_cache.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/ref/target.hpp>
+#include <migraphx/load_save.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/tmp_dir.hpp>
+#include <migraphx/file_buffer.hpp>
+#include <chrono>
+#include "test.hpp"
+
+static migraphx::program create_program(int n)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+
+    auto x   = mm->add_parameter("x", {migraphx::shape::int32_type});
+    auto lit = mm->add_literal(n);
+    auto add = mm->add_instruction(migraphx::make_op("add"), x, lit);
+    mm->add_return({add});
+    return p;
+}
+
+static std::size_t count_files(const migraphx::fs::path& dir)
+{
+    return std::distance(migraphx::fs::directory_iterator(dir),
+                         migraphx::fs::directory_iterator{});
+}
+
+static int run(const migraphx::program& p, int x)
+{
+    migraphx::shape s{migraphx::shape::int32_type};
+    auto result = p.eval({{"x", migraphx::argument{s, &x}}}).back();
+    return result.at<int>();
+}
+
+TEST_CASE(compile_cache_store)
+{
+    migraphx::tmp_dir td{"compile_cache"};
+    migraphx::compile_options options;
+    options.cache_dir = td.path.string();
+
+    auto p1 = create_program(2);
+    p1.compile(migraphx::ref::target{}, options);
+    EXPECT(count_files(td.path) == 1);
+    EXPECT(run(p1, 1) == 3);
+
+    auto p2 = create_program(2);
+    p2.compile(migraphx::ref::target{}, options);
+    EXPECT(count_files(td.path) == 1);
+    EXPECT(p1.sort() == p2.sort());
+    EXPECT(run(p2, 1) == 3);
+}
+
+TEST_CASE(compile_cache_hit)
+{
+    migraphx::tmp_dir td{"compile_cache"};
+    migraphx::compile_options options;
+    options.cache_dir = td.path.string();
+
+    auto p1 = create_program(2);
+    p1.compile(migraphx::ref::target{}, options);
+    auto file = migraphx::fs::directory_iterator(td.path)->path();
+
+    // Replace the cached program so a hit can be told apart from a compile
+    auto other = create_program(5);
+    other.compile(migraphx::ref::target{});
+    migraphx::save(other, file.string());
+
+    auto p2 = create_program(2);
+    p2.compile(migraphx::ref::target{}, options);
+    EXPECT(run(p2, 1) == 6);
+}
+
+TEST_CASE(compile_cache_options)
+{
+    migraphx::tmp_dir td{"compile_cache"};
+    migraphx::compile_options options;
+    options.cache_dir = td.path.string();
+
+    auto p1 = create_program(2);
+    p1.compile(migraphx::ref::target{}, options);
+    auto p2 = create_program(3);
+    p2.compile(migraphx::ref::target{}, options);
+    EXPECT(count_files(td.path) == 2);
+
+    options.fast_math = not options.fast_math;
+    auto p3           = create_program(2);
+    p3.compile(migraphx::ref::target{}, options);
+    EXPECT(count_files(td.path) == 3);
+}
+
+TEST_CASE(compile_cache_truncated)
+{
+    migraphx::tmp_dir td{"compile_cache"};
+    migraphx::compile_options options;
+    options.cache_dir = td.path.string();
+
+    auto p1 = create_program(2);
+    p1.compile(migraphx::ref::target{}, options);
+    auto file   = migraphx::fs::directory_iterator(td.path)->path();
+    auto buffer = migraphx::read_buffer(file.string());
+    auto size   = buffer.size();
+    // Truncate the file as if the process writing it had been killed
+    buffer.resize(size / 2);
+    migraphx::write_buffer(file.string(), buffer);
+
+    auto p2 = create_program(2);
+    p2.compile(migraphx::ref::target{}, options);
+    EXPECT(run(p2, 1) == 3);
+    EXPECT(migraphx::fs::file_size(file) == size);
+}
+
+TEST_CASE(compile_cache_evict)
+{
+    migraphx::tmp_dir td{"compile_cache"};
+    migraphx::compile_options options;
+    options.cache_dir  = td.path.string();
+    options.cache_size = 1;
+
+    auto p1 = create_program(2);
+    p1.compile(migraphx::ref::target{}, options);
+    EXPECT(count_files(td.path) == 1);
+    auto first = migraphx::fs::directory_iterator(td.path)->path();
+
+    auto p2 = create_program(3);
+    p2.compile(migraphx::ref::target{}, options);
+    EXPECT(count_files(td.path) == 1);
+    EXPECT(not migraphx::fs::exists(first));
+}
+
+// A target that generates code for a specific device
+struct device_target : migraphx::ref::target
+{
+    std::string identity;
+    std::string device_identity() const { return identity; }
+};
+
+TEST_CASE(compile_cache_key_device)
+{
+    migraphx::compile_cache cache;
+    migraphx::compile_options options;
+    auto p   = create_program(2);
+    auto key = [&](const std::string& identity) {
+        migraphx::target t    = device_target{{}, identity};
+        migraphx::context ctx = t.get_context();
+        return cache.key(p, t, t.get_passes(ctx, options), options);
+    };
+    EXPECT(key("avx2") == key("avx2"));
+    EXPECT(key("avx2") != key("avx512"));
+    EXPECT(key("") != key("gfx90a"));
+}
+
+TEST_CASE(compile_cache_evict_lru)
+{
+    migraphx::tmp_dir td{"compile_cache"};
+    migraphx::compile_cache cache;
+    cache.dir = td.path;
+    std::vector<std::string> keys = {"a", "b", "c"};
+    for(const auto& key : keys)
+    {
+        auto p = create_program(2);
+        p.compile(migraphx::ref::target{});
+        cache.store(key, p);
+    }
+    auto file = [&](const std::string& key) { return td.path / (key + ".mxr"); };
+    auto size = migraphx::fs::file_size(file("a"));
+    // Make the access order b, a, c from oldest to newest
+    auto now = migraphx::fs::file_time_type::clock::now();
+    migraphx::fs::last_write_time(file("b"), now - std::chrono::hours{3});
+    migraphx::fs::last_write_time(file("a"), now - std::chrono::hours{2});
+    migraphx::fs::last_write_time(file("c"), now - std::chrono::hours{1});
+
+    // Loading a program makes it the most recently used
+    EXPECT(migraphx::has_value(cache.load("a")));
+    auto newer = [&](const std::string& x, const std::string& y) {
+        return migraphx::fs::last_write_time(file(x)) > migraphx::fs::last_write_time(file(y));
+    };
+    EXPECT(newer("a", "c"));
+
+    // Room for two programs removes the least recently used one
+    cache.max_bytes = 2 * size + size / 2;
+    cache.evict();
+    EXPECT(not migraphx::fs::exists(file("b")));
+    EXPECT(migraphx::fs::exists(file("a")));
+    EXPECT(migraphx::fs::exists(file("c")));
+
+    // The program that was just stored is kept even when it doesn't fit
+    cache.max_bytes = 1;
+    cache.evict("c");
+    EXPECT(count_files(td.path) == 1);
+    EXPECT(migraphx::fs::exists(file("c")));
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -0,0 +1,139 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/cpu/blocked_layout.hpp>
+#include <migraphx/cpu/target.hpp>
+#include <migraphx/dead_code_elimination.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/op/common.hpp>
+#include <migraphx/pass.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/verify_args.hpp>
+#include <algorithm>
+#include <test.hpp>
+
+static const migraphx::shape input_shape{migraphx::shape::float_type, {1, 16, 8, 8}};
+
+// The cpu target with the blocked layout pass forced to a block, or removed when it is 0
+struct blocked_target : migraphx::cpu::target
+{
+    std::size_t block = 0;
+    std::vector<migraphx::pass> get_passes(migraphx::context& ctx,
+                                           const migraphx::compile_options& options) const
+    {
+        auto passes = migraphx::cpu::target::get_passes(ctx, options);
+        std::transform(passes.begin(), passes.end(), passes.begin(), [&](auto p) {
+            if(p.name() != "cpu::blocked_layout")
+                return p;
+            if(block == 0)
+                return migraphx::pass{migraphx::dead_code_elimination{}};
+            return migraphx::pass{migraphx::cpu::blocked_layout{block}};
+        });
+        return passes;
+    }
+};
+
+// convolution -> pooling -> convolution, optionally returning the first convolution too
+static migraphx::program create_program(bool return_first = false)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_parameter("x", input_shape);
+    auto w1  = mm->add_literal(
+        migraphx::generate_literal({migraphx::shape::float_type, {32, 16, 3, 3}}, 1));
+    auto w2 = mm->add_literal(
+        migraphx::generate_literal({migraphx::shape::float_type, {16, 32, 3, 3}}, 2));
+    auto conv1 =
+        mm->add_instruction(migraphx::make_op("convolution", {{"padding", {1, 1}}}), x, w1);
+    auto pool = mm->add_instruction(
+        migraphx::make_op(
+            "pooling",
+            {{"mode", migraphx::op::pooling_mode::max}, {"lengths", {2, 2}}, {"stride", {2, 2}}}),
+        conv1);
+    auto conv2 =
+        mm->add_instruction(migraphx::make_op("convolution", {{"padding", {1, 1}}}), pool, w2);
+    if(return_first)
+        mm->add_return({conv1, conv2});
+    else
+        mm->add_return({conv2});
+    return p;
+}
+
+static std::size_t output_block(const migraphx::module& m, const std::string& name)
+{
+    auto it =
+        std::find_if(m.begin(), m.end(), [&](const auto& ins) { return ins.name() == name; });
+    if(it == m.end())
+        return 0;
+    return it->get_operator().to_value().at("output_block").template to<std::size_t>();
+}
+
+static std::size_t count_op(const migraphx::module& m, const std::string& name)
+{
+    return std::count_if(m.begin(), m.end(), [&](const auto& ins) { return ins.name() == name; });
+}
+
+static void check_block(std::size_t block, bool return_first)
+{
+    auto x = migraphx::generate_argument(input_shape);
+    auto p = create_program(return_first);
+
+    // Compare against the plain layout
+    auto expected_p = p;
+    expected_p.compile(blocked_target{});
+    auto expected = expected_p.eval({{"x", x}});
+
+    blocked_target t;
+    t.block = block;
+    p.compile(t);
+    const auto* mm = p.get_main_module();
+    EXPECT(output_block(*mm, "dnnl::convolution") == block);
+    EXPECT(output_block(*mm, "dnnl::pooling") == block);
+    // Only a returned blocked output has to be reordered back to the plain layout
+    EXPECT(count_op(*mm, "dnnl::reorder") == (return_first ? 1 : 0));
+
+    auto results = p.eval({{"x", x}});
+    EXPECT(results.size() == expected.size());
+    for(std::size_t i = 0; i < results.size(); i++)
+        EXPECT(migraphx::verify_args("blocked_layout", expected[i], results[i]));
+}
+
+TEST_CASE(blocked_8) { check_block(8, false); }
+
+TEST_CASE(blocked_16) { check_block(16, false); }
+
+TEST_CASE(blocked_output_returned) { check_block(16, true); }
+
+TEST_CASE(not_blocked)
+{
+    blocked_target t;
+    auto p = create_program();
+    p.compile(t);
+    const auto* mm = p.get_main_module();
+    EXPECT(output_block(*mm, "dnnl::convolution") == 0);
+    EXPECT(output_block(*mm, "dnnl::pooling") == 0);
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
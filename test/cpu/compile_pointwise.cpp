@@ -0,0 +1,147 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/cpu/compile_pointwise.hpp>
+#include <migraphx/cpu/target.hpp>
+#include <migraphx/file_buffer.hpp>
+#include <migraphx/filesystem.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/tmp_dir.hpp>
+#include <migraphx/verify.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <test.hpp>
+
+// The cache directory is read once, so it is set before any test runs
+static const migraphx::tmp_dir& cache_dir()
+{
+    static const migraphx::tmp_dir dir{"cpu-jit-cache"};
+    return dir;
+}
+
+static std::size_t count_files(const std::string& ext)
+{
+    return std::count_if(migraphx::fs::directory_iterator{cache_dir().path},
+                         migraphx::fs::directory_iterator{},
+                         [&](const auto& entry) { return entry.path().extension() == ext; });
+}
+
+static migraphx::module create_pointwise_module()
+{
+    migraphx::module m{"main:pointwise0"};
+    migraphx::shape s{migraphx::shape::float_type};
+    auto x0  = m.add_parameter("x0", s);
+    auto x1  = m.add_parameter("x1", s);
+    auto add = m.add_instruction(migraphx::make_op("add"), x0, x1);
+    auto r   = m.add_instruction(migraphx::make_op("relu"), add);
+    m.add_return({r});
+    return m;
+}
+
+TEST_CASE(cache_hit)
+{
+    migraphx::shape s{migraphx::shape::float_type, {3, 17}};
+    std::vector<migraphx::shape> inputs = {s, s, s};
+    auto m1                             = create_pointwise_module();
+    auto op1                            = migraphx::cpu::compile_pointwise(inputs, m1);
+    auto nlibs                          = count_files(".so");
+    EXPECT(nlibs > 0);
+    EXPECT(count_files(".cpp") == nlibs);
+
+    auto m2  = create_pointwise_module();
+    auto op2 = migraphx::cpu::compile_pointwise(inputs, m2);
+    EXPECT(count_files(".so") == nlibs);
+    EXPECT(op1.to_value() == op2.to_value());
+}
+
+TEST_CASE(cache_collision)
+{
+    migraphx::shape s{migraphx::shape::float_type, {5, 9}};
+    std::vector<migraphx::shape> inputs = {s, s, s};
+    auto m1                             = create_pointwise_module();
+    auto op1                            = migraphx::cpu::compile_pointwise(inputs, m1);
+    // An entry whose source doesn't match is compiled again and replaced
+    const std::string other = "int x;";
+    for(const auto& entry : migraphx::fs::directory_iterator{cache_dir().path})
+    {
+        if(entry.path().extension() == ".cpp")
+            migraphx::write_buffer(entry.path().string(), other.data(), other.size());
+    }
+    auto m2  = create_pointwise_module();
+    auto op2 = migraphx::cpu::compile_pointwise(inputs, m2);
+    EXPECT(op1.to_value() == op2.to_value());
+    for(const auto& entry : migraphx::fs::directory_iterator{cache_dir().path})
+    {
+        if(entry.path().extension() == ".cpp")
+            EXPECT(migraphx::read_string(entry.path().string()) != other);
+    }
+}
+
+TEST_CASE(cached_kernel_eval)
+{
+    auto create_program = [] {
+        migraphx::program p;
+        auto* mm = p.get_main_module();
+        migraphx::shape s{migraphx::shape::float_type, {4, 33}};
+        auto x   = mm->add_parameter("x", s);
+        auto y   = mm->add_parameter("y", s);
+        auto add = mm->add_instruction(migraphx::make_op("add"), x, y);
+        auto mul = mm->add_instruction(migraphx::make_op("mul"), add, x);
+        mm->add_instruction(migraphx::make_op("tanh"), mul);
+        return p;
+    };
+    migraphx::parameter_map params;
+    for(auto&& [name, s] : create_program().get_parameter_shapes())
+        params[name] = migraphx::generate_argument(s, name.front());
+    std::vector<float> x;
+    std::vector<float> y;
+    params["x"].visit([&](auto v) { x.assign(v.begin(), v.end()); });
+    params["y"].visit([&](auto v) { y.assign(v.begin(), v.end()); });
+    std::vector<float> expected(x.size());
+    std::transform(x.begin(), x.end(), y.begin(), expected.begin(), [](auto a, auto b) {
+        return std::tanh((a + b) * a);
+    });
+    // The second program loads the kernel from the cache
+    for(int i = 0; i < 2; i++)
+    {
+        auto cp = create_program();
+        cp.compile(migraphx::cpu::target{});
+        auto* mm = cp.get_main_module();
+        EXPECT(std::any_of(
+            mm->begin(), mm->end(), [](auto&& ins) { return ins.name() == "cpu::code_object"; }));
+        std::vector<float> result;
+        cp.eval(params).back().visit([&](auto v) { result.assign(v.begin(), v.end()); });
+        EXPECT(migraphx::verify_range(result, expected));
+    }
+}
+
+int main(int argc, const char* argv[])
+{
+    setenv("MIGRAPHX_CPU_JIT_CACHE_DIR", cache_dir().path.c_str(), 1);
+    test::run(argc, argv);
+}
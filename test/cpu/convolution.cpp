@@ -0,0 +1,181 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/cpu/target.hpp>
+#include <migraphx/execution_session.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/verify.hpp>
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include <test.hpp>
+
+static const migraphx::shape input_shape{migraphx::shape::float_type, {1, 16, 8, 8}};
+static const migraphx::shape weights_shape{migraphx::shape::float_type, {16, 16, 3, 3}};
+
+static migraphx::program create_program()
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_parameter("x", input_shape);
+    auto w   = mm->add_literal(migraphx::generate_literal(weights_shape, 1));
+    mm->add_instruction(migraphx::make_op("convolution", {{"padding", {1, 1}}}), x, w);
+    p.compile(migraphx::cpu::target{});
+    return p;
+}
+
+template <class T>
+static std::vector<float> to_vector(const T& x)
+{
+    std::vector<float> result;
+    x.visit([&](auto v) { result.assign(v.begin(), v.end()); });
+    return result;
+}
+
+// Direct convolution with a padding of 1 and a stride of 1
+static std::vector<float> convolution(const migraphx::argument& x)
+{
+    auto w        = to_vector(migraphx::generate_literal(weights_shape, 1));
+    auto input    = to_vector(x);
+    std::size_t c = input_shape.lens()[1];
+    std::size_t h = input_shape.lens()[2];
+    std::size_t k = weights_shape.lens()[0];
+    std::vector<float> result(k * h * h);
+    for(std::size_t o = 0; o < k; o++)
+    {
+        for(std::size_t i = 0; i < h; i++)
+        {
+            for(std::size_t j = 0; j < h; j++)
+            {
+                float sum = 0;
+                for(std::size_t ic = 0; ic < c; ic++)
+                {
+                    for(std::size_t di = 0; di < 3; di++)
+                    {
+                        for(std::size_t dj = 0; dj < 3; dj++)
+                        {
+                            auto ii = i + di;
+                            auto jj = j + dj;
+                            if(ii < 1 or jj < 1 or ii > h or jj > h)
+                                continue;
+                            sum += input[(ic * h + ii - 1) * h + jj - 1] *
+                                   w[((o * c + ic) * 3 + di) * 3 + dj];
+                        }
+                    }
+                }
+                result[(o * h + i) * h + j] = sum;
+            }
+        }
+    }
+    return result;
+}
+
+static std::vector<float> eval(migraphx::execution_session& session, const migraphx::argument& x)
+{
+    return to_vector(session.eval({{"x", x}}).back());
+}
+
+TEST_CASE(prepack_weights)
+{
+    auto p         = create_program();
+    const auto* mm = p.get_main_module();
+    EXPECT(std::any_of(mm->begin(), mm->end(), [](const auto& ins) {
+        if(ins.name() != "dnnl::convolution")
+            return false;
+        return ins.get_operator().to_value().at("prepack_weights").template to<bool>();
+    }));
+}
+
+TEST_CASE(eval_twice)
+{
+    auto p = create_program();
+    migraphx::execution_session session{p};
+    // The weights are reordered on the first run and the packed copy is reused by the second
+    for(std::size_t i = 0; i < 2; i++)
+    {
+        auto x = migraphx::generate_argument(input_shape, i);
+        EXPECT(migraphx::verify_range(eval(session, x), convolution(x)));
+    }
+}
+
+TEST_CASE(eval_concurrent)
+{
+    auto p = create_program();
+    std::vector<migraphx::argument> inputs;
+    std::vector<std::vector<float>> expected;
+    for(std::size_t i = 0; i < 2; i++)
+    {
+        inputs.push_back(migraphx::generate_argument(input_shape, i));
+        expected.push_back(convolution(inputs.back()));
+    }
+    // Both sessions share the packed weights, and the first run of either one reorders them
+    std::vector<std::vector<float>> results(inputs.size());
+    std::vector<std::thread> threads;
+    for(std::size_t i = 0; i < inputs.size(); i++)
+    {
+        threads.emplace_back([&, i] {
+            migraphx::execution_session session{p};
+            results[i] = eval(session, inputs[i]);
+        });
+    }
+    for(auto& t : threads)
+        t.join();
+    for(std::size_t i = 0; i < inputs.size(); i++)
+        EXPECT(migraphx::verify_range(results[i], expected[i]));
+}
+
+TEST_CASE(eval_concurrent_copies)
+{
+    auto p = create_program();
+    migraphx::execution_session session{p};
+    // Each copy gets its own context, so the scratch buffers and streams are not shared
+    std::vector<migraphx::execution_session> sessions(2, session);
+    std::vector<migraphx::argument> inputs;
+    std::vector<std::vector<float>> expected;
+    for(std::size_t i = 0; i < sessions.size(); i++)
+    {
+        inputs.push_back(migraphx::generate_argument(input_shape, i));
+        expected.push_back(convolution(inputs.back()));
+    }
+    std::vector<std::vector<std::vector<float>>> results(sessions.size());
+    std::vector<std::thread> threads;
+    for(std::size_t i = 0; i < sessions.size(); i++)
+    {
+        threads.emplace_back([&, i] {
+            for(std::size_t j = 0; j < 8; j++)
+                results[i].push_back(eval(sessions[i], inputs[i]));
+        });
+    }
+    for(auto& t : threads)
+        t.join();
+    for(std::size_t i = 0; i < sessions.size(); i++)
+    {
+        for(auto&& r : results[i])
+            EXPECT(migraphx::verify_range(r, expected[i]));
+    }
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -0,0 +1,114 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/cpu/fuse_attention.hpp>
+#include <migraphx/cpu/target.hpp>
+#include <migraphx/auto_contiguous.hpp>
+#include <migraphx/dead_code_elimination.hpp>
+#include <migraphx/float_equal.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/pass_manager.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/ranges.hpp>
+#include <algorithm>
+#include <test.hpp>
+
+static void run_pass(migraphx::module& m)
+{
+    migraphx::run_passes(m,
+                         {migraphx::auto_contiguous{},
+                          migraphx::cpu::fuse_attention{},
+                          migraphx::dead_code_elimination{}});
+}
+
+static bool has_op(const migraphx::module& m, const std::string& name)
+{
+    return std::any_of(m.begin(), m.end(), [&](const auto& ins) { return ins.name() == name; });
+}
+
+// softmax(q * transpose(k) * scale) * v, with k stored like q so that it has to be transposed
+static migraphx::instruction_ref add_attention(migraphx::module& m)
+{
+    migraphx::shape s{migraphx::shape::float_type, {2, 4, 16, 8}};
+    migraphx::shape ss{migraphx::shape::float_type};
+    auto q  = m.add_parameter("q", s);
+    auto k  = m.add_parameter("k", s);
+    auto v  = m.add_parameter("v", s);
+    auto kt = m.add_instruction(
+        migraphx::make_op("transpose", {{"permutation", {0, 1, 3, 2}}}), k);
+    auto qk     = m.add_instruction(migraphx::make_op("dot"), q, kt);
+    auto scale  = m.add_literal(migraphx::literal{ss, {0.125f}});
+    auto bscale = m.add_instruction(
+        migraphx::make_op("multibroadcast", {{"out_lens", qk->get_shape().lens()}}), scale);
+    auto scaled  = m.add_instruction(migraphx::make_op("mul"), qk, bscale);
+    auto softmax = m.add_instruction(migraphx::make_op("softmax", {{"axis", 3}}), scaled);
+    auto r       = m.add_instruction(migraphx::make_op("dot"), softmax, v);
+    m.add_return({r});
+    return softmax;
+}
+
+TEST_CASE(fuse_transposed_k)
+{
+    migraphx::module m;
+    add_attention(m);
+    run_pass(m);
+    EXPECT(has_op(m, "cpu::attention"));
+    EXPECT(not has_op(m, "softmax"));
+    EXPECT(not has_op(m, "dot"));
+    // The transposed keys are read in place instead of being copied
+    EXPECT(not has_op(m, "contiguous"));
+    auto attention = std::find_if(
+        m.begin(), m.end(), [](const auto& ins) { return ins.name() == "cpu::attention"; });
+    EXPECT(attention->inputs()[1]->name() == "transpose");
+    auto scale = attention->get_operator().to_value()["scale"].to<float>();
+    EXPECT(migraphx::float_equal(scale, 0.125f));
+}
+
+TEST_CASE(fuse_softmax_used)
+{
+    migraphx::module m;
+    auto softmax = add_attention(m);
+    // The softmax is also returned, so it has to be computed on its own
+    auto ret = std::prev(m.end());
+    m.replace_return({ret->inputs().front(), softmax});
+    run_pass(m);
+    EXPECT(has_op(m, "softmax"));
+    EXPECT(not has_op(m, "cpu::attention"));
+}
+
+TEST_CASE(compile_attention)
+{
+    migraphx::program p;
+    add_attention(*p.get_main_module());
+    p.compile(migraphx::cpu::target{});
+    const auto* mm = p.get_main_module();
+    EXPECT(has_op(*mm, "cpu::attention"));
+    EXPECT(std::none_of(mm->begin(), mm->end(), [](const auto& ins) {
+        return migraphx::contains({"softmax", "dot", "dnnl::softmax", "dnnl::dot"}, ins.name());
+    }));
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
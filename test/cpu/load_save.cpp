@@ -0,0 +1,84 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/cpu/target.hpp>
+#include <migraphx/file_buffer.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/mapped_file.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/serialize.hpp>
+#include <migraphx/verify_args.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <numeric>
+#include <test.hpp>
+
+static migraphx::program create_program()
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {3, 5}};
+    std::vector<float> data(s.elements());
+    std::iota(data.begin(), data.end(), 0);
+    auto x = mm->add_parameter("x", s);
+    auto l = mm->add_literal(migraphx::literal{s, data});
+    mm->add_instruction(migraphx::make_op("add"), x, l);
+    p.compile(migraphx::cpu::target{});
+    return p;
+}
+
+TEST_CASE(literal_in_mapped_section)
+{
+    auto p1 = create_program();
+    migraphx::data_section section;
+    auto v = p1.to_value(section);
+
+    std::string filename = "migraphx_cpu_data_section.bin";
+    migraphx::write_buffer(filename, section.contents());
+    migraphx::mapped_file f{filename};
+    std::remove(filename.c_str());
+    migraphx::program p2;
+    {
+        migraphx::data_section input{f.share(0, f.size()), f.size()};
+        p2.from_value(v, input);
+    }
+
+    // The compiled literals point into the mapping instead of holding a copy of the data
+    const auto* mm = p2.get_main_module();
+    auto it = std::find_if(mm->begin(), mm->end(), [](const auto& ins) {
+        return ins.name() == "cpu::literal";
+    });
+    CHECK(bool{it != mm->end()});
+    auto arg = it->get_operator().compute(it->get_shape(), {});
+    EXPECT(arg.data() >= f.data());
+    EXPECT(arg.data() + arg.get_shape().bytes() <= f.data() + f.size());
+
+    auto x = migraphx::generate_argument(p1.get_parameter_shape("x"));
+    auto expected = p1.eval({{"x", x}}).back();
+    auto result   = p2.eval({{"x", x}}).back();
+    EXPECT(migraphx::verify_args("load_save", expected, result));
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -0,0 +1,101 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/cpu/allocation_model.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/cpu/lowering.hpp>
+#include <migraphx/cpu/schedule_model.hpp>
+#include <migraphx/dead_code_elimination.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/pass_manager.hpp>
+#include <migraphx/replace_allocate.hpp>
+#include <migraphx/schedule.hpp>
+#include <algorithm>
+#include <test.hpp>
+
+static void run_pass(migraphx::module& m, std::size_t nstreams)
+{
+    migraphx::cpu::context ctx{nstreams};
+    migraphx::run_passes(m,
+                         {migraphx::cpu::lowering{&ctx},
+                          migraphx::dead_code_elimination{},
+                          migraphx::replace_allocate{migraphx::cpu::cpu_allocation_model{}},
+                          migraphx::dead_code_elimination{},
+                          migraphx::schedule{migraphx::cpu::schedule_model{ctx.nstreams()},
+                                             ctx.nstreams() > 1},
+                          migraphx::dead_code_elimination{}});
+}
+
+static std::size_t count(const migraphx::module& m, const std::string& name)
+{
+    return std::count_if(m.begin(), m.end(), [&](auto&& ins) { return ins.name() == name; });
+}
+
+static migraphx::module create_branches()
+{
+    migraphx::module m;
+    migraphx::shape s{migraphx::shape::float_type, {64, 64}};
+    auto x  = m.add_parameter("x", s);
+    auto a1 = m.add_instruction(migraphx::make_op("sin"), x);
+    auto a2 = m.add_instruction(migraphx::make_op("cos"), a1);
+    auto b1 = m.add_instruction(migraphx::make_op("atan"), x);
+    auto b2 = m.add_instruction(migraphx::make_op("asin"), b1);
+    m.add_instruction(migraphx::make_op("concat", {{"axis", 0}}), a2, b2);
+    return m;
+}
+
+TEST_CASE(single_stream)
+{
+    auto m = create_branches();
+    run_pass(m, 1);
+    // The reference operators are left as they are
+    EXPECT(count(m, "cpu::op") == 0);
+    EXPECT(count(m, "sin") == 1);
+    EXPECT(count(m, "cpu::async") == 0);
+    EXPECT(count(m, "cpu::set_stream") == 0);
+}
+
+TEST_CASE(branches)
+{
+    auto m = create_branches();
+    run_pass(m, 2);
+    EXPECT(count(m, "sin") == 0);
+    EXPECT(count(m, "cpu::set_stream") >= 2);
+    EXPECT(count(m, "cpu::record_event") >= 1);
+    EXPECT(count(m, "cpu::wait_event") >= 1);
+    EXPECT(count(m, "cpu::async") == 5);
+    // Every operator writes to a buffer that memory_coloring can plan
+    for(auto ins : migraphx::iterator_for(m))
+    {
+        if(ins->name() != "cpu::async")
+            continue;
+        auto alias = ins->get_operator().output_alias(migraphx::to_shapes(ins->inputs()));
+        EXPECT(alias >= 0);
+        EXPECT(ins->inputs().at(alias)->name() == "cpu::allocate");
+    }
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -0,0 +1,127 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/cpu/stream.hpp>
+#include <migraphx/errors.hpp>
+#include <atomic>
+#include <memory>
+#include <numeric>
+#include <vector>
+#include <test.hpp>
+
+TEST_CASE(stream_in_order)
+{
+    migraphx::cpu::stream s{true, 1};
+    EXPECT(s.is_async());
+    std::vector<std::size_t> result;
+    for(std::size_t i = 0; i < 64; i++)
+        s.submit([&result, i] { result.push_back(i); });
+    s.wait();
+    std::vector<std::size_t> expected(64);
+    std::iota(expected.begin(), expected.end(), 0);
+    EXPECT(result == expected);
+}
+
+TEST_CASE(stream_sync)
+{
+    migraphx::cpu::stream s{false, 1};
+    EXPECT(not s.is_async());
+    bool done = false;
+    s.submit([&] { done = true; });
+    EXPECT(done);
+    EXPECT(test::throws([&] { s.submit([] { MIGRAPHX_THROW("Failed"); }); }));
+}
+
+TEST_CASE(stream_error)
+{
+    migraphx::cpu::stream s{true, 1};
+    std::atomic<bool> after{false};
+    s.submit([] { MIGRAPHX_THROW("Failed"); });
+    // Work after an error still runs so that events are signaled
+    s.submit([&] { after = true; });
+    EXPECT(test::throws([&] { s.wait(); }));
+    EXPECT(after.load());
+    // The error is only reported once
+    s.wait();
+}
+
+TEST_CASE(stream_wait_event)
+{
+    migraphx::cpu::event e;
+    migraphx::cpu::stream s1{true, 1};
+    migraphx::cpu::stream s2{true, 1};
+    std::vector<std::size_t> result;
+    // The second stream waits for the first one, which is started last
+    e.record();
+    s2.submit_wait(e, e.recorded());
+    s2.submit([&] { result.push_back(2); });
+    s1.submit([&] { result.push_back(1); });
+    s1.submit([&] { e.signal(); });
+    s2.wait();
+    s1.wait();
+    EXPECT(result == std::vector<std::size_t>{1, 2});
+}
+
+TEST_CASE(stream_wait_event_chain)
+{
+    // More waiting streams than threads, so a wait must not block the thread
+    const std::size_t n = 16;
+    std::vector<std::unique_ptr<migraphx::cpu::stream>> streams;
+    std::vector<migraphx::cpu::event> events(n);
+    for(std::size_t i = 0; i < n; i++)
+        streams.push_back(std::make_unique<migraphx::cpu::stream>(true, 1));
+    std::vector<std::size_t> result;
+    for(std::size_t i = n; i > 0; i--)
+    {
+        auto& s = *streams[i - 1];
+        if(i > 1)
+        {
+            events[i - 2].record();
+            s.submit_wait(events[i - 2], events[i - 2].recorded());
+        }
+        s.submit([&result, i] { result.push_back(i - 1); });
+        s.submit([&events, i] { events[i - 1].signal(); });
+    }
+    for(auto& s : streams)
+        s->wait();
+    std::vector<std::size_t> expected(n);
+    std::iota(expected.begin(), expected.end(), 0);
+    EXPECT(result == expected);
+}
+
+TEST_CASE(event_notify)
+{
+    migraphx::cpu::event e;
+    e.record();
+    e.record();
+    std::size_t called = 0;
+    EXPECT(e.notify(2, [&] { called++; }));
+    e.signal();
+    EXPECT(called == 0);
+    e.signal();
+    EXPECT(called == 1);
+    EXPECT(not e.notify(2, [&] { called++; }));
+    EXPECT(called == 1);
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
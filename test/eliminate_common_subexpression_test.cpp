@@ -171,6 +171,84 @@ TEST_CASE(cse_test_literal)
     EXPECT(m1 == m2);
 }
 
+TEST_CASE(cse_test_literal_data)
+{
+    migraphx::shape s{migraphx::shape::float_type, {3}};
+    migraphx::module m1;
+    {
+        auto l1   = m1.add_literal(migraphx::literal{s, {1, 2, 3}});
+        auto l2   = m1.add_literal(migraphx::literal{s, {1, 2, 4}});
+        auto l3   = m1.add_literal(migraphx::literal{s, {1, 2, 3}});
+        auto sum1 = m1.add_instruction(migraphx::make_op("add"), l1, l2);
+        auto sum2 = m1.add_instruction(migraphx::make_op("add"), l3, l2);
+        auto sum3 = m1.add_instruction(migraphx::make_op("add"), sum1, sum2);
+        m1.add_instruction(pass_op{}, sum3);
+    }
+    run_pass(m1);
+
+    migraphx::module m2;
+    {
+        auto l2   = m2.add_literal(migraphx::literal{s, {1, 2, 4}});
+        auto l1   = m2.add_literal(migraphx::literal{s, {1, 2, 3}});
+        auto sum1 = m2.add_instruction(migraphx::make_op("add"), l1, l2);
+        auto sum3 = m2.add_instruction(migraphx::make_op("add"), sum1, sum1);
+        m2.add_instruction(pass_op{}, sum3);
+    }
+    EXPECT(m1 == m2);
+}
+
+TEST_CASE(cse_test_attributes)
+{
+    migraphx::shape s{migraphx::shape::float_type, {2, 3}};
+    migraphx::module m1;
+    {
+        auto x  = m1.add_parameter("x", s);
+        auto t1 = m1.add_instruction(migraphx::make_op("transpose", {{"permutation", {1, 0}}}), x);
+        auto t2 = m1.add_instruction(migraphx::make_op("transpose", {{"permutation", {0, 1}}}), x);
+        auto t3 = m1.add_instruction(migraphx::make_op("transpose", {{"permutation", {1, 0}}}), x);
+        m1.add_instruction(pass_op{}, t1, t2, t3);
+    }
+    run_pass(m1);
+
+    migraphx::module m2;
+    {
+        auto x  = m2.add_parameter("x", s);
+        auto t1 = m2.add_instruction(migraphx::make_op("transpose", {{"permutation", {1, 0}}}), x);
+        auto t2 = m2.add_instruction(migraphx::make_op("transpose", {{"permutation", {0, 1}}}), x);
+        m2.add_instruction(pass_op{}, t1, t2, t1);
+    }
+    EXPECT(m1 == m2);
+}
+
+TEST_CASE(cse_test_chain)
+{
+    migraphx::shape s{migraphx::shape::float_type, {4}};
+    auto add_chain = [](migraphx::module& m, migraphx::instruction_ref x, std::size_t n) {
+        for(std::size_t i = 0; i < n; i++)
+        {
+            auto e = m.add_instruction(migraphx::make_op("exp"), x);
+            x      = m.add_instruction(migraphx::make_op("add"), e, x);
+        }
+        return x;
+    };
+    migraphx::module m1;
+    {
+        auto x  = m1.add_parameter("x", s);
+        auto c1 = add_chain(m1, x, 100);
+        auto c2 = add_chain(m1, x, 100);
+        m1.add_instruction(pass_op{}, c1, c2);
+    }
+    run_pass(m1);
+
+    migraphx::module m2;
+    {
+        auto x  = m2.add_parameter("x", s);
+        auto c1 = add_chain(m2, x, 100);
+        m2.add_instruction(pass_op{}, c1, c1);
+    }
+    EXPECT(m1 == m2);
+}
+
 TEST_CASE(cse_test_submodule)
 {
     migraphx::shape si{migraphx::shape::int64_type};
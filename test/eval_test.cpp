@@ -498,6 +498,58 @@ TEST_CASE(eval_context3)
     EXPECT(not is_shared(t.ctx, p.get_context()));
 }
 
+TEST_CASE(eval_compiled_twice)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto one = mm->add_literal(1);
+    auto two = mm->add_literal(2);
+    auto sum = mm->add_instruction(sum_op{}, one, two);
+    mm->add_instruction(pass_op{}, sum);
+    p.compile(id_target{});
+    EXPECT(p.eval({}).back() == migraphx::literal{3});
+    EXPECT(p.eval({}).back() == migraphx::literal{3});
+}
+
+TEST_CASE(eval_compiled_modified)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto one = mm->add_literal(1);
+    auto two = mm->add_literal(2);
+    mm->add_instruction(sum_op{}, one, two);
+    p.compile(id_target{});
+    EXPECT(p.eval({}).back() == migraphx::literal{3});
+    // Modifying the program after compiling should not use a stale evaluation plan
+    auto* mm2 = p.get_main_module();
+    auto last = std::prev(mm2->end());
+    mm2->replace_instruction(last, minus_op{}, two, one);
+    EXPECT(p.eval({}).back() == migraphx::literal{1});
+    mm2->add_instruction(sum_op{}, last, two);
+    EXPECT(p.eval({}).back() == migraphx::literal{3});
+}
+
+TEST_CASE(eval_compiled_modified_same_size)
+{
+    migraphx::program p;
+    auto* mm   = p.get_main_module();
+    auto one   = mm->add_literal(1);
+    auto two   = mm->add_literal(2);
+    auto three = mm->add_literal(3);
+    auto sum   = mm->add_instruction(sum_op{}, one, two);
+    p.compile(id_target{});
+    EXPECT(p.eval({}).back() == migraphx::literal{3});
+    // The module is modified through a pointer taken before compiling, which keeps its size the
+    // same, so only the module version can tell the plan is stale
+    mm->replace_argument(sum, two, three);
+    EXPECT(p.eval({}).back() == migraphx::literal{4});
+    mm->replace_instruction(sum, minus_op{}, three, one);
+    EXPECT(p.eval({}).back() == migraphx::literal{2});
+    mm->remove_instruction(sum);
+    mm->add_instruction(sum_op{}, three, three);
+    EXPECT(p.eval({}).back() == migraphx::literal{6});
+}
+
 struct cout_redirect
 {
     cout_redirect()                     = delete;
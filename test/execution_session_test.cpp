@@ -0,0 +1,260 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/execution_session.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/ref/target.hpp>
+#include <algorithm>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "test.hpp"
+
+static migraphx::program create_program()
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {4, 8}};
+    auto x   = mm->add_parameter("x", s);
+    auto y   = mm->add_literal(migraphx::generate_literal(s, 1));
+    auto add = mm->add_instruction(migraphx::make_op("add"), x, y);
+    mm->add_instruction(migraphx::make_op("mul"), add, x);
+    p.compile(migraphx::ref::target{});
+    return p;
+}
+
+TEST_CASE(create_context_uncompiled)
+{
+    migraphx::program p;
+    EXPECT(test::throws([&] { p.create_context(); }));
+}
+
+TEST_CASE(session_eval)
+{
+    auto p = create_program();
+    migraphx::execution_session session{p};
+    migraphx::parameter_map params;
+    params["x"]   = migraphx::generate_argument(p.get_parameter_shape("x"), 2);
+    auto expected = p.eval(params).back();
+    EXPECT(session.eval(params).back() == expected);
+    EXPECT(session.eval(params).back() == expected);
+}
+
+TEST_CASE(session_eval_concurrent)
+{
+    auto p = create_program();
+    const std::size_t n = 8;
+    std::vector<migraphx::argument> inputs;
+    std::vector<migraphx::argument> expected;
+    for(std::size_t i = 0; i < n; i++)
+    {
+        inputs.push_back(migraphx::generate_argument(p.get_parameter_shape("x"), i));
+        expected.push_back(p.eval({{"x", inputs.back()}}).back());
+    }
+
+    std::vector<std::vector<migraphx::argument>> results(n);
+    std::vector<std::thread> threads;
+    for(std::size_t i = 0; i < n; i++)
+    {
+        threads.emplace_back([&, i] {
+            migraphx::execution_session session{p};
+            for(std::size_t j = 0; j < 16; j++)
+                results[i].push_back(session.eval({{"x", inputs[i]}}).back());
+        });
+    }
+    for(auto& t : threads)
+        t.join();
+
+    for(std::size_t i = 0; i < n; i++)
+    {
+        for(auto&& r : results[i])
+            EXPECT(r == expected[i]);
+    }
+}
+
+TEST_CASE(session_copy_concurrent)
+{
+    auto p = create_program();
+    migraphx::execution_session session{p};
+    auto copy = session;
+    EXPECT(&copy.get_program() == &session.get_program());
+    std::vector<migraphx::execution_session*> sessions = {&session, &copy};
+
+    std::vector<migraphx::argument> inputs;
+    std::vector<migraphx::argument> expected;
+    for(std::size_t i = 0; i < sessions.size(); i++)
+    {
+        inputs.push_back(migraphx::generate_argument(p.get_parameter_shape("x"), i));
+        expected.push_back(p.eval({{"x", inputs.back()}}).back());
+    }
+
+    std::vector<std::vector<migraphx::argument>> results(sessions.size());
+    std::vector<std::thread> threads;
+    for(std::size_t i = 0; i < sessions.size(); i++)
+    {
+        threads.emplace_back([&, i] {
+            for(std::size_t j = 0; j < 16; j++)
+                results[i].push_back(sessions[i]->eval({{"x", inputs[i]}}).back());
+        });
+    }
+    for(auto& t : threads)
+        t.join();
+
+    for(std::size_t i = 0; i < sessions.size(); i++)
+    {
+        EXPECT(results[i].size() == 16);
+        for(auto&& r : results[i])
+            EXPECT(r == expected[i]);
+    }
+}
+
+TEST_CASE(session_eval_outputs)
+{
+    auto p = create_program();
+    migraphx::execution_session session{p};
+    EXPECT(session.get_output_parameter_names().empty());
+    migraphx::parameter_map params;
+    params["x"]   = migraphx::generate_argument(p.get_parameter_shape("x"), 2);
+    auto expected = p.eval(params).back();
+    migraphx::argument output{p.get_output_shapes().back()};
+    auto results = session.eval(params, {output});
+    EXPECT(results.size() == 1);
+    EXPECT(results.front().data() == output.data());
+    EXPECT(output == expected);
+}
+
+// Copies its first argument into the buffer of its second, like the copy a target inserts for
+// an output parameter
+struct copy_to_op
+{
+    std::string name() const { return "copy_to"; }
+    migraphx::argument
+    compute(migraphx::context&, const migraphx::shape&, std::vector<migraphx::argument> args) const
+    {
+        visit_all(args[0], args[1])([](auto input, auto output) {
+            std::copy(input.begin(), input.end(), output.begin());
+        });
+        return args[1];
+    }
+
+    migraphx::shape compute_shape(std::vector<migraphx::shape> inputs) const
+    {
+        return inputs.back();
+    }
+    int output_alias(const std::vector<migraphx::shape>&) const { return 1; }
+};
+
+// A program that writes each result into a `main:#output_N` parameter. The parameters are added
+// in name order so the outputs have to be ordered by their index.
+static migraphx::program create_output_program(std::size_t n)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {4, 8}};
+    auto x = mm->add_parameter("x", s);
+    std::vector<std::string> names;
+    for(std::size_t i = 0; i < n; i++)
+        names.push_back("main:#output_" + std::to_string(i));
+    std::sort(names.begin(), names.end());
+    std::unordered_map<std::string, migraphx::instruction_ref> outputs;
+    for(const auto& name : names)
+        outputs[name] = mm->add_parameter(name, s);
+    std::vector<migraphx::instruction_ref> results;
+    for(std::size_t i = 0; i < n; i++)
+    {
+        auto y   = mm->add_literal(migraphx::literal{s, std::vector<float>(s.elements(), i)});
+        auto add = mm->add_instruction(migraphx::make_op("add"), x, y);
+        results.push_back(mm->add_instruction(
+            copy_to_op{}, add, outputs.at("main:#output_" + std::to_string(i))));
+    }
+    mm->add_return(results);
+    p.compile(migraphx::ref::target{});
+    return p;
+}
+
+TEST_CASE(session_output_parameter_names)
+{
+    auto p     = create_output_program(11);
+    auto names = migraphx::execution_session{p}.get_output_parameter_names();
+    EXPECT(names.size() == 11);
+    for(std::size_t i = 0; i < names.size(); i++)
+        EXPECT(names[i] == "main:#output_" + std::to_string(i));
+}
+
+TEST_CASE(session_eval_output_parameters)
+{
+    const std::size_t n = 11;
+    auto p              = create_output_program(n);
+    migraphx::execution_session session{p};
+    auto x = migraphx::generate_argument(p.get_parameter_shape("x"), 2);
+    std::vector<migraphx::argument> outputs;
+    for(std::size_t i = 0; i < n; i++)
+        outputs.push_back(migraphx::argument{p.get_parameter_shape("x")});
+    auto results = session.eval({{"x", x}}, outputs);
+    EXPECT(results.size() == n);
+    for(std::size_t i = 0; i < n; i++)
+    {
+        EXPECT(results[i].data() == outputs[i].data());
+        std::vector<float> expected;
+        x.visit([&](auto v) {
+            std::transform(v.begin(), v.end(), std::back_inserter(expected), [&](auto a) {
+                return a + i;
+            });
+        });
+        std::vector<float> actual;
+        outputs[i].visit([&](auto v) { actual.assign(v.begin(), v.end()); });
+        EXPECT(actual == expected);
+    }
+    // Outputs that don't match the output parameters are rejected
+    EXPECT(test::throws([&] { session.eval({{"x", x}}, {outputs.front()}); }));
+}
+
+TEST_CASE(session_eval_outputs_mismatch)
+{
+    auto p = create_program();
+    migraphx::execution_session session{p};
+    migraphx::parameter_map params;
+    params["x"] = migraphx::generate_argument(p.get_parameter_shape("x"), 2);
+    migraphx::argument output{migraphx::shape{migraphx::shape::float_type, {8, 4}}};
+    EXPECT(test::throws([&] { session.eval(params, {output}); }));
+    EXPECT(test::throws([&] { session.eval(params, {output, output}); }));
+}
+
+TEST_CASE(session_eval_async)
+{
+    auto p = create_program();
+    migraphx::execution_session session{p};
+    std::vector<migraphx::argument> inputs;
+    std::vector<std::future<std::vector<migraphx::argument>>> futures;
+    for(std::size_t i = 0; i < 4; i++)
+    {
+        inputs.push_back(migraphx::generate_argument(p.get_parameter_shape("x"), i));
+        futures.push_back(session.eval_async({{"x", inputs.back()}}));
+    }
+    for(std::size_t i = 0; i < 4; i++)
+        EXPECT(futures[i].get().back() == p.eval({{"x", inputs[i]}}).back());
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
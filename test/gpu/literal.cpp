@@ -28,6 +28,7 @@
 #include <migraphx/generate.hpp>
 #include <migraphx/gpu/target.hpp>
 #include <migraphx/gpu/hip.hpp>
+#include <migraphx/gpu/context.hpp>
 
 void gpu_literal_test()
 {
@@ -48,4 +49,22 @@ void gpu_literal_test()
     }
 }
 
-int main() { gpu_literal_test(); }
+void gpu_literal_shared_test()
+{
+    auto lit = generate_literal(migraphx::shape{migraphx::shape::float_type, {4, 3, 3, 3}});
+    migraphx::operation op = migraphx::gpu::hip_copy_literal{lit, "lit"};
+    migraphx::context ctx1 = migraphx::gpu::context{};
+    migraphx::context ctx2 = migraphx::gpu::context{};
+    op.finalize(ctx1, lit.get_shape(), {});
+    auto result1 = op.compute(ctx1, lit.get_shape(), {});
+    // A context that wasn't finalized, like the one of a new session, reuses the same copy
+    auto result2 = op.compute(ctx2, lit.get_shape(), {});
+    EXPECT(result1.data() == result2.data());
+    EXPECT(lit == migraphx::gpu::from_gpu(result1));
+}
+
+int main()
+{
+    gpu_literal_test();
+    gpu_literal_shared_test();
+}
@@ -0,0 +1,91 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/hash.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/literal.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/value.hpp>
+
+#include <test.hpp>
+
+TEST_CASE(hash_value_equal)
+{
+    migraphx::value v1 = {{"a", 1}, {"b", 2.5}, {"c", "x"}};
+    migraphx::value v2 = {{"a", 1}, {"b", 2.5}, {"c", "x"}};
+    EXPECT(v1 == v2);
+    EXPECT(migraphx::hash_value(v1) == migraphx::hash_value(v2));
+    migraphx::value v3 = {{"a", 1}, {"b", 2.5}, {"c", "y"}};
+    EXPECT(migraphx::hash_value(v1) != migraphx::hash_value(v3));
+}
+
+TEST_CASE(hash_value_array)
+{
+    migraphx::value v1 = {1, 2, 3};
+    migraphx::value v2 = {1, 2, 3};
+    migraphx::value v3 = {1, 2, 4};
+    EXPECT(migraphx::hash_value(v1) == migraphx::hash_value(v2));
+    EXPECT(migraphx::hash_value(v1) != migraphx::hash_value(v3));
+    EXPECT(migraphx::hash_value(v1.with_key("a")) != migraphx::hash_value(v1.with_key("b")));
+}
+
+TEST_CASE(hash_shape)
+{
+    migraphx::shape s1{migraphx::shape::float_type, {2, 3}};
+    migraphx::shape s2{migraphx::shape::float_type, {2, 3}};
+    migraphx::shape s3{migraphx::shape::float_type, {2, 3}, {1, 2}};
+    migraphx::shape s4{migraphx::shape::half_type, {2, 3}};
+    EXPECT(migraphx::hash_value(s1) == migraphx::hash_value(s2));
+    EXPECT(migraphx::hash_value(s1) != migraphx::hash_value(s3));
+    EXPECT(migraphx::hash_value(s1) != migraphx::hash_value(s4));
+}
+
+TEST_CASE(hash_literal)
+{
+    migraphx::shape s{migraphx::shape::float_type, {3}};
+    migraphx::literal l1{s, {1, 2, 3}};
+    migraphx::literal l2{s, {1, 2, 3}};
+    migraphx::literal l3{s, {1, 2, 4}};
+    EXPECT(migraphx::hash_value(l1) == migraphx::hash_value(l2));
+    EXPECT(migraphx::hash_value(l1) != migraphx::hash_value(l3));
+}
+
+TEST_CASE(hash_instruction)
+{
+    migraphx::shape s{migraphx::shape::float_type, {2, 3}};
+    migraphx::module m;
+    auto x    = m.add_parameter("x", s);
+    auto y    = m.add_parameter("y", s);
+    auto add1 = m.add_instruction(migraphx::make_op("add"), x, y);
+    auto add2 = m.add_instruction(migraphx::make_op("add"), x, y);
+    auto add3 = m.add_instruction(migraphx::make_op("add"), y, x);
+    auto mul  = m.add_instruction(migraphx::make_op("mul"), x, y);
+    EXPECT(bool{*add1 == *add2});
+    EXPECT(migraphx::hash_value(*add1) == migraphx::hash_value(*add2));
+    EXPECT(migraphx::hash_value(*add1) != migraphx::hash_value(*add3));
+    EXPECT(migraphx::hash_value(*add1) != migraphx::hash_value(*mul));
+    EXPECT(migraphx::hash_value(*x) != migraphx::hash_value(*y));
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
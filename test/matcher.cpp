@@ -1086,4 +1086,82 @@ TEST_CASE(match_finder)
     match::find_matches(mm, match_find_sum{sum}, match_find_literal{sum});
 }
 
+TEST_CASE(match_root_names)
+{
+    auto names1 = match::get_root_names(
+        match::name("sum")(match::arg(0)(match::name("@literal"))).bind("x"));
+    EXPECT(names1.has_value());
+    EXPECT(*names1 == std::vector<std::string>{"sum"});
+
+    auto names2 = match::get_root_names(match::name("sum", "pass"));
+    EXPECT(names2.has_value());
+    EXPECT(names2->size() == 2);
+    EXPECT(migraphx::contains(*names2, "sum"));
+    EXPECT(migraphx::contains(*names2, "pass"));
+
+    auto names3 = match::get_root_names(match::any_matcher{match::name("pass")});
+    EXPECT(names3.has_value());
+    EXPECT(*names3 == std::vector<std::string>{"pass"});
+
+    EXPECT(not match::get_root_names(match::any()).has_value());
+    EXPECT(not match::get_root_names(match::standard_shape()).has_value());
+}
+
+struct match_fold_sum
+{
+    auto matcher() const
+    {
+        return match::name("sum")(match::all_of[match::inputs()](match::name("@literal")));
+    }
+
+    void apply(migraphx::module& m, const match::matcher_result& r) const
+    {
+        auto ins = r.result;
+        int x    = 0;
+        for(auto input : ins->inputs())
+            x += input->get_literal().at<int>();
+        m.replace_instruction(ins, m.add_literal(x));
+    }
+};
+
+struct match_skip_sum
+{
+    auto matcher() const { return match::name("sum"); }
+
+    void apply(migraphx::module&, const match::matcher_result&) const {}
+};
+
+TEST_CASE(rewrite_fixed_point)
+{
+    migraphx::module mm;
+    auto one   = mm.add_literal(1);
+    auto two   = mm.add_literal(2);
+    auto three = mm.add_literal(3);
+    auto four  = mm.add_literal(4);
+    auto sum1  = mm.add_instruction(sum_op{}, one, two);
+    auto sum2  = mm.add_instruction(sum_op{}, three, four);
+    auto sum3  = mm.add_instruction(sum_op{}, sum1, sum2);
+    auto sum4  = mm.add_instruction(sum_op{}, sum3, sum3);
+    mm.add_instruction(pass_op{}, sum4);
+    match::rewrite_matches(mm, match_fold_sum{});
+    // Everything is folded into one literal and the unused literals are removed
+    EXPECT(mm.size() == 2);
+    EXPECT(mm.begin()->name() == "@literal");
+    EXPECT(mm.begin()->get_literal().at<int>() == 20);
+}
+
+TEST_CASE(rewrite_no_change)
+{
+    migraphx::module mm;
+    auto one = mm.add_literal(1);
+    auto two = mm.add_literal(2);
+    auto sum = mm.add_instruction(sum_op{}, one, two);
+    mm.add_instruction(pass_op{}, sum);
+    auto version = mm.version();
+    // A finder that never rewrites must still terminate
+    match::rewrite_matches(mm, match_skip_sum{}, match_fold_sum{});
+    EXPECT(mm.version() == version);
+    EXPECT(mm.size() == 4);
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -35,6 +35,14 @@ void run_pass(migraphx::module& m)
     migraphx::run_passes(m, {migraphx::memory_coloring{"allocate", true}});
 }
 
+void run_pass(migraphx::module& m, const std::string& planner, bool reuse_pointwise = false)
+{
+    migraphx::memory_coloring mc{"allocate", true};
+    mc.planner         = planner;
+    mc.reuse_pointwise = reuse_pointwise;
+    migraphx::run_passes(m, {mc});
+}
+
 struct allocate
 {
     migraphx::shape s{};
@@ -59,6 +67,17 @@ struct allocate
     }
 };
 
+struct pointwise_op
+{
+    std::string name() const { return "pointwise_op"; }
+    migraphx::value attributes() const { return {{"pointwise", true}}; }
+    migraphx::shape compute_shape(std::vector<migraphx::shape> inputs) const
+    {
+        return inputs.back();
+    }
+    int output_alias(const std::vector<migraphx::shape>& s) const { return s.size() - 1; }
+};
+
 migraphx::instruction_ref add_alloc(migraphx::module& m, const migraphx::shape& s)
 {
     return m.add_instruction(allocate{s});
@@ -649,10 +668,8 @@ TEST_CASE(test37)
     CHECK(no_allocate(m));
 }
 
-TEST_CASE(test38)
+void add_test38(migraphx::module& m)
 {
-    migraphx::module m;
-
     auto output = m.add_parameter("output", {migraphx::shape::float_type, {1, 64, 56, 56}});
     auto m29    = add_alloc(m, {migraphx::shape::float_type, {0}});
     auto p30    = add_alloc(m, {migraphx::shape::float_type, {1, 64, 112, 112}});
@@ -690,7 +707,22 @@ TEST_CASE(test38)
     auto p78    = add_alloc(m, {migraphx::shape::float_type, {1, 64, 56, 56}});
     auto p83    = m.add_instruction(pass_op{}, p78, p77);
     m.add_instruction(pass_op{}, output, p83, p63);
+}
+
+TEST_CASE(test38)
+{
+    migraphx::module m;
+    add_test38(m);
     run_pass(m);
+    CHECK(m.get_parameter_shape("scratch").bytes() == 6422528);
+    CHECK(no_allocate(m));
+}
+
+TEST_CASE(test38_coloring)
+{
+    migraphx::module m;
+    add_test38(m);
+    run_pass(m, "coloring");
     CHECK(m.get_parameter_shape("scratch").bytes() == 7225344); // Optimal solution is 6422528
     CHECK(no_allocate(m));
 }
@@ -737,6 +769,76 @@ TEST_CASE(test39)
     CHECK(no_allocate(*else_mod));
 }
 
+TEST_CASE(unknown_planner)
+{
+    migraphx::module m;
+    auto a1 = add_alloc(m, {migraphx::shape::float_type, {8}});
+    m.add_instruction(pass_op{}, a1);
+    EXPECT(test::throws([&] { run_pass(m, "unknown"); }));
+}
+
+TEST_CASE(reuse_pointwise)
+{
+    auto create_module = [](migraphx::module& m) {
+        migraphx::shape s{migraphx::shape::float_type, {64}};
+        auto output = m.add_parameter("output", s);
+        auto a1     = add_alloc(m, s);
+        auto p1     = m.add_instruction(pass_op{}, a1);
+        auto a2     = add_alloc(m, s);
+        auto p2     = m.add_instruction(pointwise_op{}, p1, a2);
+        m.add_instruction(pass_op{}, output, p2);
+    };
+    migraphx::module m1;
+    create_module(m1);
+    run_pass(m1, "best_fit");
+    CHECK(m1.get_parameter_shape("scratch").bytes() == 512);
+    CHECK(no_allocate(m1));
+
+    migraphx::module m2;
+    create_module(m2);
+    run_pass(m2, "best_fit", true);
+    CHECK(m2.get_parameter_shape("scratch").bytes() == 256);
+    CHECK(no_allocate(m2));
+}
+
+TEST_CASE(reuse_pointwise_live_input)
+{
+    migraphx::module m;
+    migraphx::shape s{migraphx::shape::float_type, {64}};
+    auto output = m.add_parameter("output", s);
+    auto a1     = add_alloc(m, s);
+    auto p1     = m.add_instruction(pass_op{}, a1);
+    auto a2     = add_alloc(m, s);
+    auto p2     = m.add_instruction(pointwise_op{}, p1, a2);
+    // The input is still used after the pointwise operator so it can't be overwritten
+    m.add_instruction(pass_op{}, output, p2, p1);
+    run_pass(m, "best_fit", true);
+    CHECK(m.get_parameter_shape("scratch").bytes() == 512);
+    CHECK(is_disjoint({a1, a2}));
+}
+
+TEST_CASE(best_fit_many)
+{
+    migraphx::module m;
+    migraphx::shape s{migraphx::shape::float_type, {64}};
+    auto output = m.add_parameter("output", s);
+    auto prev   = m.add_instruction(pass_op{}, add_alloc(m, s));
+    // Every tenth buffer stays live until the end, while the others only live for one step
+    std::vector<migraphx::instruction_ref> kept;
+    for(std::size_t i = 1; i < 1000; i++)
+    {
+        prev = m.add_instruction(pass_op{}, add_alloc(m, s), prev);
+        if(i % 10 == 0)
+            kept.push_back(prev);
+    }
+    kept.push_back(prev);
+    kept.insert(kept.begin(), output);
+    m.add_instruction(pass_op{}, kept);
+    run_pass(m, "best_fit");
+    CHECK(m.get_parameter_shape("scratch").bytes() == 101 * s.bytes());
+    CHECK(no_allocate(m));
+}
+
 // NOLINTNEXTLINE
 TEST_CASE(rnn_dom)
 {
@@ -439,4 +439,72 @@ TEST_CASE(multiple_module_dependency)
     EXPECT((sub->validate() == sub->end()));
 }
 
+TEST_CASE(module_version)
+{
+    migraphx::module m;
+    auto v0  = m.version();
+    auto x   = m.add_parameter("x", {migraphx::shape::int64_type});
+    auto one = m.add_literal(1);
+    auto v1  = m.version();
+    EXPECT(v1 != v0);
+    auto sum = m.add_instruction(sum_op{}, x, one);
+    auto v2  = m.version();
+    EXPECT(v2 != v1);
+    m.get_parameter_shapes();
+    EXPECT(m.version() == v2);
+    m.replace_instruction(sum, one);
+    auto v3 = m.version();
+    EXPECT(v3 != v2);
+    m.remove_instruction(sum);
+    EXPECT(m.version() != v3);
+}
+
+struct count_idempotent_pass
+{
+    std::unordered_map<std::string, int>* count = nullptr;
+    std::string name() const { return "count_idempotent"; }
+    bool idempotent() const { return true; }
+    void apply(migraphx::module& m) const { (*count)[m.name()]++; }
+};
+
+struct add_literal_pass
+{
+    std::string module_name;
+    std::string name() const { return "add_literal"; }
+    void apply(migraphx::module& m) const
+    {
+        if(m.name() == module_name)
+            m.add_literal(1);
+    }
+};
+
+TEST_CASE(skip_idempotent_pass)
+{
+    migraphx::module m;
+    m.add_literal(1);
+    std::unordered_map<std::string, int> count;
+    count_idempotent_pass cp{&count};
+    migraphx::run_passes(m, {cp, cp, add_literal_pass{m.name()}, cp, cp});
+    EXPECT(count[m.name()] == 2);
+}
+
+TEST_CASE(skip_idempotent_pass_submodule)
+{
+    migraphx::program p;
+    auto* mm    = p.get_main_module();
+    auto* sub   = p.create_module("sub");
+    auto* other = p.create_module("other");
+    sub->add_literal(1);
+    other->add_literal(1);
+    mm->add_instruction(mod_pass_op{}, {}, {sub});
+    mm->add_instruction(mod_pass_op{}, {}, {other});
+    std::unordered_map<std::string, int> count;
+    count_idempotent_pass cp{&count};
+    migraphx::run_passes(p, {cp, cp, add_literal_pass{"sub"}, cp});
+    // A change in a submodule reruns the pass on the parent but not on unrelated modules
+    EXPECT(count["sub"] == 2);
+    EXPECT(count["main"] == 2);
+    EXPECT(count["other"] == 1);
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
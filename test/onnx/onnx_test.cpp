@@ -1379,6 +1379,21 @@ TEST_CASE(external_data_diff_path_test)
     EXPECT(p == prog);
 }
 
+TEST_CASE(external_data_offset_test)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {2, 3}};
+    auto a = mm->add_literal(migraphx::literal{s, {1, 2, 3, 4, 5, 6}});
+    auto b = mm->add_literal(migraphx::literal{s, {7, 8, 9, 10, 11, 12}});
+    auto c = mm->add_literal(migraphx::literal{s, {13, 14, 15, 16, 17, 18}});
+    auto t = mm->add_instruction(migraphx::make_op("add"), a, b);
+    mm->add_instruction(migraphx::make_op("add"), t, c);
+
+    auto prog = optimize_onnx("external_data_offset_test.onnx");
+    EXPECT(p == prog);
+}
+
 TEST_CASE(eyelike_default_test)
 {
     migraphx::program p;
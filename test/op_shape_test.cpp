@@ -1665,6 +1665,27 @@ TEST_CASE(where_broadcast_input)
     expect_shape(s2, migraphx::make_op("where"), s3, s1, s2);
 }
 
+TEST_CASE(weight_dot_shape)
+{
+    migraphx::shape a{migraphx::shape::float_type, {2, 3, 64}};
+    migraphx::shape w4{migraphx::shape::int8_type, {8, 32}};
+    migraphx::shape w8{migraphx::shape::int8_type, {8, 64}};
+    migraphx::shape s{migraphx::shape::float_type, {8, 2}};
+    expect_shape(migraphx::shape{migraphx::shape::float_type, {2, 3, 8}},
+                 migraphx::make_op("weight_dot", {{"bits", 4}, {"group_size", 32}}),
+                 a,
+                 w4,
+                 s);
+    expect_shape(migraphx::shape{migraphx::shape::float_type, {2, 3, 8}},
+                 migraphx::make_op("weight_dot", {{"bits", 8}, {"group_size", 32}}),
+                 a,
+                 w8,
+                 s);
+    throws_shape(migraphx::make_op("weight_dot", {{"bits", 8}, {"group_size", 32}}), a, w4, s);
+    throws_shape(migraphx::make_op("weight_dot", {{"bits", 4}, {"group_size", 16}}), a, w4, s);
+    throws_shape(migraphx::make_op("weight_dot", {{"bits", 2}, {"group_size", 32}}), a, w4, s);
+}
+
 TEST_CASE(roialign_test)
 {
     migraphx::shape sx{migraphx::shape::float_type, {3, 4, 5, 6}};
@@ -0,0 +1,128 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/pass_profile.hpp>
+#include <migraphx/pass_manager.hpp>
+#include <migraphx/dead_code_elimination.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/matcher.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/program.hpp>
+#include <sstream>
+
+#include <test.hpp>
+
+struct find_double_neg
+{
+    auto matcher() const
+    {
+        return migraphx::match::name("neg")(migraphx::match::arg(0)(migraphx::match::name("neg")));
+    }
+
+    void apply(migraphx::module& m, const migraphx::match::matcher_result& r) const
+    {
+        auto ins = r.result;
+        m.replace_instruction(ins, ins->inputs().front()->inputs().front());
+    }
+};
+
+struct remove_double_neg
+{
+    std::string name() const { return "remove_double_neg"; }
+    void apply(migraphx::module& m) const { migraphx::match::find_matches(m, find_double_neg{}); }
+};
+
+migraphx::program create_program()
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_parameter("x", {migraphx::shape::float_type, {2}});
+    auto n1  = mm->add_instruction(migraphx::make_op("neg"), x);
+    auto n2  = mm->add_instruction(migraphx::make_op("neg"), n1);
+    auto n3  = mm->add_instruction(migraphx::make_op("neg"), n2);
+    auto n4  = mm->add_instruction(migraphx::make_op("neg"), n3);
+    mm->add_return({n4});
+    return p;
+}
+
+TEST_CASE(profile_records)
+{
+    auto p = create_program();
+    migraphx::pass_profile profile;
+    migraphx::run_passes(p,
+                         {remove_double_neg{},
+                          migraphx::dead_code_elimination{},
+                          migraphx::dead_code_elimination{}},
+                         {},
+                         &profile);
+    // One record for the module and one for the program for each pass
+    EXPECT(profile.records.size() == 6);
+
+    const auto& neg = profile.records[0];
+    EXPECT(neg.pass == "remove_double_neg");
+    EXPECT(neg.module == "main");
+    EXPECT(not neg.skipped);
+    EXPECT(neg.instructions_before == 6);
+    EXPECT(neg.instructions_after == 6);
+    EXPECT(neg.matches.size() == 1);
+    EXPECT(neg.matches.begin()->second == 2);
+
+    const auto& dce = profile.records[2];
+    EXPECT(dce.pass == "dead_code_elimination");
+    EXPECT(dce.module == "main");
+    EXPECT(dce.instructions_before == 6);
+    EXPECT(dce.instructions_after == 2);
+
+    // The second dead code elimination does not run since nothing changed
+    EXPECT(profile.records[4].skipped);
+    EXPECT(profile.records[5].module.empty());
+    EXPECT(profile.total_ms() >= 0);
+}
+
+TEST_CASE(profile_value)
+{
+    auto p = create_program();
+    migraphx::pass_profile profile;
+    migraphx::run_passes(p, {remove_double_neg{}}, {}, &profile);
+    auto v = profile.to_value();
+    EXPECT(v.size() == 2);
+    EXPECT(v[0].at("pass").to<std::string>() == "remove_double_neg");
+    EXPECT(v[0].at("module").to<std::string>() == "main");
+    EXPECT(v[0].at("instructions_before").to<std::size_t>() == 6);
+    EXPECT(v[0].at("matches").size() == 1);
+    EXPECT(not v[0].at("skipped").to<bool>());
+
+    std::stringstream ss;
+    profile.print_summary(ss);
+    EXPECT(migraphx::contains(ss.str(), "remove_double_neg"));
+}
+
+TEST_CASE(profile_not_enabled)
+{
+    auto p = create_program();
+    migraphx::run_passes(p, {remove_double_neg{}});
+    EXPECT(migraphx::match::profiled_matches() == nullptr);
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
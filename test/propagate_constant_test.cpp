@@ -26,6 +26,9 @@
 #include <migraphx/pass_manager.hpp>
 #include <basic_ops.hpp>
 #include <migraphx/make_op.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/file_buffer.hpp>
+#include <migraphx/tmp_dir.hpp>
 
 #include <test.hpp>
 
@@ -163,4 +166,117 @@ TEST_CASE(const_dot)
     EXPECT(m1 == m2);
 }
 
+TEST_CASE(const_grows)
+{
+    auto create_module = [] {
+        migraphx::module m;
+        auto one = m.add_literal(1.0f);
+        auto mb  = m.add_instruction(
+            migraphx::make_op("multibroadcast", {{"out_lens", {64, 64}}}), one);
+        auto sum = m.add_instruction(migraphx::make_op("add"), mb, mb);
+        m.add_instruction(pass_op{}, sum);
+        return m;
+    };
+    migraphx::module m1 = create_module();
+    migraphx::run_passes(m1,
+                         {migraphx::propagate_constant{16, 0}, migraphx::dead_code_elimination{}});
+    EXPECT(m1 == create_module());
+
+    migraphx::module m2 = create_module();
+    run_pass(m2);
+    EXPECT(std::none_of(
+        m2.begin(), m2.end(), [](const auto& ins) { return ins.name() == "add"; }));
+}
+
+static migraphx::module create_cache_module()
+{
+    migraphx::module m;
+    auto one = m.add_literal(1);
+    auto two = m.add_literal(2);
+    auto sum = m.add_instruction(migraphx::make_op("add"), one, two);
+    m.add_instruction(pass_op{}, sum);
+    return m;
+}
+
+static migraphx::module expected_cache_module(int x)
+{
+    migraphx::module m;
+    auto l = m.add_literal(x);
+    m.add_instruction(pass_op{}, l);
+    return m;
+}
+
+static std::vector<migraphx::fs::path> cache_files(const migraphx::fs::path& dir,
+                                                   const std::string& extension)
+{
+    std::vector<migraphx::fs::path> result;
+    for(const auto& f : migraphx::fs::directory_iterator{dir})
+    {
+        if(f.path().extension() == extension)
+            result.push_back(f.path());
+    }
+    return result;
+}
+
+TEST_CASE(const_cache)
+{
+    migraphx::tmp_dir td{"const_cache"};
+    migraphx::propagate_constant pc;
+    pc.cache_dir = td.path.string();
+
+    migraphx::module m1 = create_cache_module();
+    migraphx::run_passes(m1, {pc, migraphx::dead_code_elimination{}});
+    EXPECT(m1 == expected_cache_module(3));
+
+    // Change the cached value to check that it is used
+    auto files = cache_files(td.path, ".bin");
+    EXPECT(files.size() == 1);
+    EXPECT(cache_files(td.path, ".key").size() == 1);
+    int x = 5;
+    migraphx::write_buffer(files.front().string(), reinterpret_cast<char*>(&x), sizeof(x));
+
+    migraphx::module m2 = create_cache_module();
+    migraphx::run_passes(m2, {pc, migraphx::dead_code_elimination{}});
+    EXPECT(m2 == expected_cache_module(5));
+}
+
+TEST_CASE(const_cache_key_mismatch)
+{
+    migraphx::tmp_dir td{"const_cache"};
+    migraphx::propagate_constant pc;
+    pc.cache_dir = td.path.string();
+
+    migraphx::module m1 = create_cache_module();
+    migraphx::run_passes(m1, {pc, migraphx::dead_code_elimination{}});
+
+    // An entry stored for another computation with the same file name is not used
+    auto files = cache_files(td.path, ".bin");
+    EXPECT(files.size() == 1);
+    int x = 5;
+    migraphx::write_buffer(files.front().string(), reinterpret_cast<char*>(&x), sizeof(x));
+    auto key_file = cache_files(td.path, ".key").front();
+    auto key      = migraphx::read_string(key_file.string());
+    std::string other = "other";
+    migraphx::write_buffer(key_file.string(), other.data(), other.size());
+
+    migraphx::module m2 = create_cache_module();
+    migraphx::run_passes(m2, {pc, migraphx::dead_code_elimination{}});
+    EXPECT(m2 == expected_cache_module(3));
+    EXPECT(migraphx::read_string(key_file.string()) == key);
+}
+
+TEST_CASE(const_cache_unwritable)
+{
+    migraphx::tmp_dir td{"const_cache"};
+    // The cache directory can't be created under a regular file
+    auto file = td.path / "file";
+    migraphx::write_buffer(file.string(), std::vector<char>{});
+    migraphx::propagate_constant pc;
+    pc.cache_dir = (file / "cache").string();
+
+    migraphx::module m = create_cache_module();
+    migraphx::run_passes(m, {pc, migraphx::dead_code_elimination{}});
+    EXPECT(m == expected_cache_module(3));
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -43,6 +43,43 @@ def test_conv_relu():
     print(r)
 
 
+def test_session():
+    p = migraphx.parse_onnx("conv_relu_maxpool_test.onnx")
+    p.compile(migraphx.get_target("ref"))
+    params = {}
+
+    for key, value in p.get_parameter_shapes().items():
+        params[key] = migraphx.generate_argument(value)
+
+    session = migraphx.execution_session(p)
+    r1 = session.run(params)[-1]
+    r2 = p.run(params)[-1]
+    assert r1 == r2
+
+
+def test_session_outputs():
+    p = migraphx.parse_onnx("conv_relu_maxpool_test.onnx")
+    p.compile(migraphx.get_target("ref"))
+    params = {}
+
+    for key, value in p.get_parameter_shapes().items():
+        params[key] = migraphx.generate_argument(value)
+
+    session = migraphx.execution_session(p)
+    s = p.get_output_shapes()[-1]
+    a = array.array("f", [0] * s.elements())
+    output = migraphx.argument(memoryview(a).cast("B").cast("f", s.lens()))
+    r1 = session.run(params, [output])[-1]
+    r2 = p.run(params)[-1]
+    assert r1 == r2
+    assert output == r2
+
+    future = session.run_async(params)
+    r3 = future.get()[-1]
+    assert future.done()
+    assert r3 == r2
+
+
 def create_buffer(t, data, shape):
     a = array.array(t, data)
     if sys.version_info >= (3, 0):
@@ -84,6 +121,8 @@ def test_module():
 
 
 test_conv_relu()
+test_session()
 test_module()
 if sys.version_info >= (3, 0):
+    test_session_outputs()
     test_add_scalar()
@@ -1129,6 +1129,149 @@ TEST_CASE(int8_quantization_conv)
     }
 }
 
+TEST_CASE(int8_quantization_per_channel_asymmetric)
+{
+    auto run_prog = [](migraphx::program p,
+                       const migraphx::parameter_map& m,
+                       std::vector<float>& res,
+                       bool b_quantize = false) {
+        migraphx::target t = migraphx::ref::target{};
+        if(b_quantize)
+        {
+            migraphx::calibration_options options;
+            options.per_channel = true;
+            options.asymmetric  = true;
+            migraphx::quantize_int8(p, t, {m}, {"dot", "convolution"}, options);
+            auto* mm = p.get_main_module();
+            EXPECT(std::any_of(mm->begin(), mm->end(), [](const auto& ins) {
+                return migraphx::contains({"quant_dot", "quant_convolution"}, ins.name());
+            }));
+        }
+        p.compile(t);
+        auto result = p.eval(m).back();
+        result.visit([&](auto v) { res.assign(v.begin(), v.end()); });
+    };
+
+    auto make_weights = [](const migraphx::shape& s) {
+        // Give each output channel a very different range
+        std::vector<float> w(s.elements());
+        for(std::size_t i = 0; i < w.size(); i++)
+        {
+            auto idx = s.multi(i);
+            auto k   = (s.lens().size() == 4) ? idx.front() : idx.back();
+            w[i]     = std::pow(4.0f, k) * ((i % 7) - 3.0f) / 3.0f;
+        }
+        return w;
+    };
+
+    auto make_input = [](const migraphx::shape& s) {
+        // Mostly positive activations
+        std::vector<float> x(s.elements());
+        for(std::size_t i = 0; i < x.size(); i++)
+            x[i] = ((i * 13) % 17) / 4.0f - 0.5f;
+        return migraphx::literal{s, x}.get_argument();
+    };
+
+    {
+        migraphx::program p;
+        auto* mm = p.get_main_module();
+        migraphx::shape sx{migraphx::shape::float_type, {2, 3, 4, 4}};
+        migraphx::shape sw{migraphx::shape::float_type, {4, 3, 3, 3}};
+        auto x = mm->add_parameter("x", sx);
+        auto w = mm->add_literal(migraphx::literal{sw, make_weights(sw)});
+        auto r = mm->add_instruction(migraphx::make_op("convolution", {{"padding", {1, 1}}}), x, w);
+        mm->add_return({r});
+
+        migraphx::parameter_map m;
+        auto input = make_input(sx);
+        m["x"]     = input;
+        std::vector<float> quant_result;
+        std::vector<float> no_quant_result;
+        run_prog(p, m, quant_result, true);
+        run_prog(p, m, no_quant_result);
+        EXPECT(migraphx::verify_range(quant_result, no_quant_result, 100000));
+    }
+
+    {
+        migraphx::program p;
+        auto* mm = p.get_main_module();
+        migraphx::shape sa{migraphx::shape::float_type, {3, 16}};
+        migraphx::shape sb{migraphx::shape::float_type, {16, 4}};
+        auto a = mm->add_parameter("a", sa);
+        auto b = mm->add_literal(migraphx::literal{sb, make_weights(sb)});
+        auto r = mm->add_instruction(migraphx::make_op("dot"), a, b);
+        mm->add_return({r});
+
+        migraphx::parameter_map m;
+        auto input = make_input(sa);
+        m["a"]     = input;
+        std::vector<float> quant_result;
+        std::vector<float> no_quant_result;
+        run_prog(p, m, quant_result, true);
+        run_prog(p, m, no_quant_result);
+        EXPECT(migraphx::verify_range(quant_result, no_quant_result, 100000));
+    }
+}
+
+TEST_CASE(weight_only_quantization_dot)
+{
+    auto create_program = [] {
+        migraphx::program p;
+        auto* mm = p.get_main_module();
+        migraphx::shape sa{migraphx::shape::float_type, {2, 3, 64}};
+        migraphx::shape sb{migraphx::shape::float_type, {64, 8}};
+        auto a  = mm->add_parameter("a", sa);
+        auto b  = mm->add_literal(migraphx::generate_literal(sb, get_hash(std::string("b"))));
+        auto mb = mm->add_instruction(
+            migraphx::make_op("multibroadcast", {{"out_lens", {2, 64, 8}}}), b);
+        auto r = mm->add_instruction(migraphx::make_op("dot"), a, mb);
+        mm->add_return({r});
+        return p;
+    };
+
+    auto run_prog = [](migraphx::program p, const migraphx::parameter_map& m) {
+        p.compile(migraphx::ref::target{});
+        std::vector<float> res;
+        p.eval(m).back().visit([&](auto v) { res.assign(v.begin(), v.end()); });
+        return res;
+    };
+
+    migraphx::parameter_map m;
+    migraphx::shape sa{migraphx::shape::float_type, {2, 3, 64}};
+    m["a"]        = migraphx::generate_argument(sa, get_hash(std::string("a")));
+    auto expected = run_prog(create_program(), m);
+    for(std::size_t bits : {8, 4})
+    {
+        auto p = create_program();
+        migraphx::quantize_weights(p, migraphx::ref::target{}, bits, 32);
+        auto* mm = p.get_main_module();
+        EXPECT(std::none_of(
+            mm->begin(), mm->end(), [](const auto& ins) { return ins.name() == "dot"; }));
+        EXPECT(std::any_of(
+            mm->begin(), mm->end(), [](const auto& ins) { return ins.name() == "weight_dot"; }));
+        auto result = run_prog(p, m);
+        EXPECT(migraphx::verify_range(result, expected, (bits == 8) ? 100000 : 1000000));
+    }
+}
+
+TEST_CASE(weight_only_quantization_unsupported_target)
+{
+    struct gpu_target : migraphx::ref::target
+    {
+        std::string name() const { return "gpu"; }
+    };
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape sa{migraphx::shape::float_type, {3, 64}};
+    migraphx::shape sb{migraphx::shape::float_type, {64, 8}};
+    auto a = mm->add_parameter("a", sa);
+    auto b = mm->add_literal(migraphx::generate_literal(sb));
+    mm->add_instruction(migraphx::make_op("dot"), a, b);
+    EXPECT(test::throws([&] { migraphx::quantize_weights(p, gpu_target{}); }));
+    EXPECT(std::any_of(
+        mm->begin(), mm->end(), [](const auto& ins) { return ins.name() == "dot"; }));
+}
+
 TEST_CASE(int8_subgraph)
 {
     auto create_program = [] {
@@ -0,0 +1,173 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/request_batcher.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/ref/target.hpp>
+#include <thread>
+#include <vector>
+#include "test.hpp"
+
+static migraphx::program create_program(std::size_t batch, std::size_t n = 8)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {batch, n}};
+    auto x  = mm->add_parameter("x", s);
+    auto y  = mm->add_parameter("y", s);
+    auto z  = mm->add_instruction(migraphx::make_op("add"), x, y);
+    auto zz = mm->add_instruction(migraphx::make_op("mul"), z, x);
+    mm->add_return({z, zz});
+    p.compile(migraphx::ref::target{});
+    return p;
+}
+
+static std::vector<migraphx::program> create_programs(const std::vector<std::size_t>& sizes)
+{
+    std::vector<migraphx::program> result;
+    for(auto size : sizes)
+        result.push_back(create_program(size));
+    return result;
+}
+
+static migraphx::parameter_map create_sample(const migraphx::request_batcher& b, unsigned long seed)
+{
+    migraphx::parameter_map m;
+    for(auto&& ps : b.get_parameter_shapes())
+        m[ps.first] = migraphx::generate_argument(ps.second, seed++);
+    return m;
+}
+
+TEST_CASE(batch_buckets)
+{
+    migraphx::request_batcher b{create_programs({4, 1, 2})};
+    EXPECT(b.get_bucket_sizes() == std::vector<std::size_t>{1, 2, 4});
+    migraphx::shape sample{migraphx::shape::float_type, {1, 8}};
+    EXPECT(b.get_parameter_shapes().at("x") == sample);
+    EXPECT(b.get_parameter_shapes().at("y") == sample);
+}
+
+TEST_CASE(batch_invalid_programs)
+{
+    EXPECT(test::throws([] { migraphx::request_batcher{{}}; }));
+    EXPECT(test::throws([] { migraphx::request_batcher{create_programs({2, 2})}; }));
+    EXPECT(test::throws([] {
+        std::vector<migraphx::program> progs;
+        progs.push_back(create_program(1, 8));
+        progs.push_back(create_program(2, 4));
+        migraphx::request_batcher{std::move(progs)};
+    }));
+    EXPECT(test::throws([] {
+        migraphx::request_batcher{create_programs({1, 2}), {4, std::chrono::microseconds{0}}};
+    }));
+}
+
+TEST_CASE(batch_invalid_request)
+{
+    migraphx::request_batcher b{create_programs({1, 2})};
+    migraphx::shape s{migraphx::shape::float_type, {2, 8}};
+    EXPECT(test::throws([&] { b.submit({{"x", migraphx::generate_argument(s)}}); }));
+    EXPECT(test::throws([&] {
+        b.submit({{"x", migraphx::generate_argument(s)}, {"y", migraphx::generate_argument(s)}});
+    }));
+}
+
+TEST_CASE(batch_results)
+{
+    auto single = create_program(1);
+    migraphx::request_batcher b{create_programs({1, 2, 4}),
+                                {4, std::chrono::microseconds{100000}}};
+    const std::size_t n = 10;
+    std::vector<migraphx::parameter_map> samples;
+    std::vector<std::future<std::vector<migraphx::argument>>> futures;
+    for(std::size_t i = 0; i < n; i++)
+    {
+        samples.push_back(create_sample(b, i));
+        futures.push_back(b.submit(samples.back()));
+    }
+    for(std::size_t i = 0; i < n; i++)
+    {
+        auto results  = futures[i].get();
+        auto expected = single.eval(samples[i]);
+        EXPECT(results.size() == 2);
+        EXPECT(results == expected);
+    }
+    auto stats = b.get_stats();
+    EXPECT(stats.requests == n);
+    EXPECT(stats.batches >= 3);
+}
+
+TEST_CASE(batch_padding)
+{
+    auto single = create_program(1);
+    migraphx::request_batcher b{create_programs({1, 2, 4}),
+                                {4, std::chrono::microseconds{100000}}};
+    std::vector<migraphx::parameter_map> samples;
+    std::vector<std::future<std::vector<migraphx::argument>>> futures;
+    for(std::size_t i = 0; i < 3; i++)
+    {
+        samples.push_back(create_sample(b, i));
+        futures.push_back(b.submit(samples.back()));
+    }
+    for(std::size_t i = 0; i < 3; i++)
+        EXPECT(futures[i].get() == single.eval(samples[i]));
+    EXPECT(b.get_stats().padding == 1);
+}
+
+TEST_CASE(batch_concurrent)
+{
+    auto single = create_program(1);
+    migraphx::request_batcher b{create_programs({1, 2, 4, 8}),
+                                {8, std::chrono::microseconds{500}}};
+    const std::size_t nthreads = 8;
+    const std::size_t n        = 16;
+    // The expected results are computed up front since the program is not evaluated concurrently
+    std::vector<migraphx::parameter_map> samples;
+    std::vector<std::vector<migraphx::argument>> expected;
+    for(std::size_t i = 0; i < nthreads * n; i++)
+    {
+        samples.push_back(create_sample(b, i));
+        expected.push_back(single.eval(samples.back()));
+    }
+    std::vector<std::size_t> errors(nthreads);
+    std::vector<std::thread> threads;
+    for(std::size_t t = 0; t < nthreads; t++)
+    {
+        threads.emplace_back([&, t] {
+            for(std::size_t i = 0; i < n; i++)
+            {
+                auto k = t * n + i;
+                if(b.submit(samples[k]).get() != expected[k])
+                    errors[t]++;
+            }
+        });
+    }
+    for(auto& t : threads)
+        t.join();
+    EXPECT(std::all_of(errors.begin(), errors.end(), [](auto e) { return e == 0; }));
+    EXPECT(b.get_stats().requests == nthreads * n);
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
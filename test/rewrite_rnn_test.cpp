@@ -0,0 +1,203 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/rewrite_rnn.hpp>
+#include <migraphx/dead_code_elimination.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/op/common.hpp>
+#include <migraphx/pass_manager.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/ref/target.hpp>
+#include <migraphx/verify.hpp>
+
+#include <test.hpp>
+
+const std::size_t batch_size  = 3;
+const std::size_t max_seq_len = 5;
+const std::size_t hidden_size = 4;
+const std::size_t input_size  = 3;
+
+static migraphx::program create_program(const std::string& name,
+                                        migraphx::op::rnn_direction dirct,
+                                        bool optional_args,
+                                        std::size_t seq_len = max_seq_len,
+                                        int linear_before_reset = 0)
+{
+    std::size_t num_gates = 1;
+    if(name == "gru")
+        num_gates = 3;
+    else if(name == "lstm")
+        num_gates = 4;
+    std::size_t num_dirct = dirct == migraphx::op::rnn_direction::bidirectional ? 2 : 1;
+    auto float_shape      = [](std::vector<std::size_t> lens) {
+        return migraphx::shape{migraphx::shape::float_type, std::move(lens)};
+    };
+
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto seq = mm->add_parameter("seq", float_shape({max_seq_len, batch_size, input_size}));
+    auto w = mm->add_parameter("w", float_shape({num_dirct, num_gates * hidden_size, input_size}));
+    auto r = mm->add_parameter("r", float_shape({num_dirct, num_gates * hidden_size, hidden_size}));
+    auto und = mm->add_instruction(migraphx::make_op("undefined"));
+    std::vector<migraphx::instruction_ref> args{seq, w, r, und, und, und};
+    if(optional_args)
+    {
+        args[3] = mm->add_parameter("bias", float_shape({num_dirct, 2 * num_gates * hidden_size}));
+        args[5] = mm->add_parameter("ih", float_shape({num_dirct, batch_size, hidden_size}));
+    }
+    if(seq_len != max_seq_len)
+    {
+        migraphx::shape sl_shape{migraphx::shape::int32_type, {batch_size}};
+        args[4] = mm->add_literal(
+            migraphx::literal{sl_shape, std::vector<int>(batch_size, static_cast<int>(seq_len))});
+    }
+    if(name == "lstm")
+    {
+        args.push_back(und);
+        args.push_back(und);
+        if(optional_args)
+        {
+            args[6] = mm->add_parameter("ic", float_shape({num_dirct, batch_size, hidden_size}));
+            args[7] = mm->add_parameter("pph", float_shape({num_dirct, 3 * hidden_size}));
+        }
+    }
+
+    migraphx::value v = {{"hidden_size", hidden_size},
+                         {"direction", migraphx::to_value(dirct)}};
+    if(name == "gru")
+        v["linear_before_reset"] = linear_before_reset;
+    auto hs = mm->add_instruction(migraphx::make_op(name, v), args);
+    std::vector<migraphx::instruction_ref> outputs{hs};
+    outputs.push_back(mm->add_instruction(migraphx::make_op("rnn_last_hs_output"), hs));
+    if(name == "lstm")
+        outputs.push_back(mm->add_instruction(migraphx::make_op("rnn_last_cell_output"), hs));
+    mm->add_return(outputs);
+    return p;
+}
+
+static bool has_loop(const migraphx::program& p)
+{
+    const auto* mm = p.get_main_module();
+    return std::any_of(
+        mm->begin(), mm->end(), [](const auto& ins) { return ins.name() == "loop"; });
+}
+
+static std::vector<migraphx::argument> run(migraphx::program p,
+                                           const migraphx::parameter_map& params)
+{
+    p.compile(migraphx::ref::target{});
+    return p.eval(params);
+}
+
+static void verify_compact(const migraphx::program& p)
+{
+    migraphx::parameter_map params;
+    unsigned long seed = 0;
+    for(auto&& pp : p.get_parameter_shapes())
+        params[pp.first] = migraphx::generate_argument(pp.second, seed++);
+
+    auto unrolled = p;
+    migraphx::run_passes(unrolled, {migraphx::rewrite_rnn{}, migraphx::dead_code_elimination{}});
+    auto compact = p;
+    migraphx::run_passes(compact,
+                         {migraphx::rewrite_rnn{true}, migraphx::dead_code_elimination{}});
+    EXPECT(not has_loop(unrolled));
+    EXPECT(has_loop(compact));
+
+    auto expected = run(unrolled, params);
+    auto results  = run(compact, params);
+    EXPECT(results.size() == expected.size());
+    for(std::size_t i = 0; i < results.size(); i++)
+    {
+        EXPECT(results[i].get_shape() == expected[i].get_shape());
+        std::vector<float> result;
+        std::vector<float> gold;
+        results[i].visit([&](auto output) { result.assign(output.begin(), output.end()); });
+        expected[i].visit([&](auto output) { gold.assign(output.begin(), output.end()); });
+        EXPECT(migraphx::verify_range(result, gold));
+    }
+}
+
+TEST_CASE(compact_rnn_forward)
+{
+    verify_compact(create_program("rnn", migraphx::op::rnn_direction::forward, true));
+}
+
+TEST_CASE(compact_rnn_reverse)
+{
+    verify_compact(create_program("rnn", migraphx::op::rnn_direction::reverse, false));
+}
+
+TEST_CASE(compact_rnn_bidirectional_seq_len)
+{
+    verify_compact(create_program("rnn", migraphx::op::rnn_direction::bidirectional, true, 3));
+}
+
+TEST_CASE(compact_gru_forward)
+{
+    verify_compact(create_program("gru", migraphx::op::rnn_direction::forward, true));
+}
+
+TEST_CASE(compact_gru_reverse_linear_before_reset)
+{
+    verify_compact(create_program("gru", migraphx::op::rnn_direction::reverse, true, 4, 1));
+}
+
+TEST_CASE(compact_gru_bidirectional)
+{
+    verify_compact(create_program("gru", migraphx::op::rnn_direction::bidirectional, false));
+    verify_compact(
+        create_program("gru", migraphx::op::rnn_direction::bidirectional, true, max_seq_len, 1));
+}
+
+TEST_CASE(compact_lstm_forward)
+{
+    verify_compact(create_program("lstm", migraphx::op::rnn_direction::forward, true));
+}
+
+TEST_CASE(compact_lstm_reverse)
+{
+    verify_compact(create_program("lstm", migraphx::op::rnn_direction::reverse, false, 2));
+}
+
+TEST_CASE(compact_lstm_bidirectional)
+{
+    verify_compact(create_program("lstm", migraphx::op::rnn_direction::bidirectional, true));
+}
+
+TEST_CASE(compact_variable_seq_lens)
+{
+    auto p   = create_program("lstm", migraphx::op::rnn_direction::forward, true);
+    auto* mm = p.get_main_module();
+    auto ins =
+        std::find_if(mm->begin(), mm->end(), [](const auto& i) { return i.name() == "lstm"; });
+    migraphx::shape sl_shape{migraphx::shape::int32_type, {batch_size}};
+    auto seq_lens = mm->add_literal(migraphx::literal{sl_shape, {5, 2, 3}});
+    mm->replace_argument(ins, ins->inputs()[4], seq_lens);
+    migraphx::run_passes(p, {migraphx::rewrite_rnn{true}, migraphx::dead_code_elimination{}});
+    EXPECT(not has_loop(p));
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
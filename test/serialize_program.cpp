@@ -24,10 +24,16 @@
 #include <migraphx/program.hpp>
 #include <migraphx/ref/target.hpp>
 #include <migraphx/load_save.hpp>
+#include <migraphx/msgpack.hpp>
+#include <migraphx/instruction.hpp>
 #include "test.hpp"
 #include <migraphx/make_op.hpp>
 
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/serialize.hpp>
+
 #include <cstdio>
+#include <numeric>
 
 migraphx::program create_program()
 {
@@ -79,6 +85,117 @@ TEST_CASE(as_file)
     EXPECT(p1.sort() == p2.sort());
 }
 
+migraphx::program create_program_with_literals()
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {3, 5}};
+    std::vector<float> data(s.elements());
+    std::iota(data.begin(), data.end(), 0);
+
+    auto x   = mm->add_parameter("x", s);
+    auto l1  = mm->add_literal(migraphx::literal{s, data});
+    auto l2  = mm->add_literal(migraphx::literal{{migraphx::shape::int8_type, {3}}, {1, 2, 3}});
+    auto add = mm->add_instruction(migraphx::make_op("add"), x, l1);
+    mm->add_return({add, l2});
+    return p;
+}
+
+TEST_CASE(as_file_data_section)
+{
+    std::string filename = "migraphx_program_data_section.mxr";
+    migraphx::program p1 = create_program_with_literals();
+    migraphx::save(p1, filename);
+    migraphx::program p2 = migraphx::load(filename);
+    std::remove(filename.c_str());
+    EXPECT(p1.sort() == p2.sort());
+    for(auto ins : migraphx::iterator_for(*p2.get_main_module()))
+    {
+        if(ins->name() != "@literal")
+            continue;
+        auto addr = reinterpret_cast<std::uintptr_t>(ins->get_literal().data());
+        EXPECT(addr % migraphx::data_section::alignment == 0);
+    }
+}
+
+TEST_CASE(as_msgpack_data_section)
+{
+    migraphx::program p1     = create_program_with_literals();
+    std::vector<char> buffer = migraphx::save_buffer(p1);
+    migraphx::program p2     = migraphx::load_buffer(buffer);
+    EXPECT(p1.sort() == p2.sort());
+}
+
+TEST_CASE(as_msgpack_inline_data)
+{
+    migraphx::program p1     = create_program_with_literals();
+    std::vector<char> buffer = migraphx::to_msgpack(p1.to_value());
+    migraphx::program p2     = migraphx::load_buffer(buffer);
+    EXPECT(p1.sort() == p2.sort());
+}
+
+TEST_CASE(data_section_missing)
+{
+    migraphx::program p1 = create_program_with_literals();
+    migraphx::data_section section;
+    auto v = p1.to_value(section);
+    migraphx::program p2;
+    EXPECT(test::throws([&] { p2.from_value(v); }));
+}
+
+TEST_CASE(data_section_explicit)
+{
+    migraphx::program p1 = create_program_with_literals();
+    migraphx::data_section section;
+    auto v = p1.to_value(section);
+    EXPECT(not section.contents().empty());
+    auto data = std::make_shared<std::vector<char>>(section.contents());
+    migraphx::data_section input{std::shared_ptr<char>{data, data->data()}, data->size()};
+    migraphx::program p2;
+    p2.from_value(v, input);
+    EXPECT(p1.sort() == p2.sort());
+}
+
+TEST_CASE(data_section_store_load)
+{
+    migraphx::literal l{{migraphx::shape::float_type, {4}}, {1, 2, 3, 4}};
+    // An operator that holds raw data next to fields named like the ones of the load operator
+    migraphx::value v;
+    v["data"]     = migraphx::to_value(l.get_argument());
+    v["offset"]   = 8;
+    v["shape"]    = migraphx::to_value(l.get_shape());
+    migraphx::data_section section;
+    section.store(v);
+    EXPECT(not v.at("data").contains("data"));
+    EXPECT(v.at("offset").to<int>() == 8);
+    EXPECT(section.contents().size() == l.get_shape().bytes());
+    auto data = std::make_shared<std::vector<char>>(section.contents());
+    migraphx::data_section input{std::shared_ptr<char>{data, data->data()}, data->size()};
+    input.load(v);
+    EXPECT(v.at("offset").to<int>() == 8);
+    auto loaded = migraphx::from_value<migraphx::literal>(v.at("data"));
+    EXPECT(loaded == l);
+    // The data is shared with the section instead of copied
+    EXPECT(loaded.data() >= data->data());
+    EXPECT(loaded.data() + l.get_shape().bytes() <= data->data() + data->size());
+}
+
+TEST_CASE(data_section_load_expired)
+{
+    migraphx::literal l{{migraphx::shape::float_type, {4}}, {1, 2, 3, 4}};
+    migraphx::value v;
+    v["data"] = migraphx::to_value(l.get_argument());
+    migraphx::data_section section;
+    section.store(v);
+    auto data = std::make_shared<std::vector<char>>(section.contents());
+    {
+        migraphx::data_section input{std::shared_ptr<char>{data, data->data()}, data->size()};
+        input.load(v);
+    }
+    // The raw data can only be read while the section is alive
+    EXPECT(test::throws([&] { migraphx::from_value<migraphx::literal>(v.at("data")); }));
+}
+
 TEST_CASE(compiled)
 {
     migraphx::program p1 = create_program();
@@ -0,0 +1,148 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/thread_pool.hpp>
+#include <migraphx/par_for.hpp>
+#include <migraphx/errors.hpp>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <numeric>
+#include <vector>
+#include <test.hpp>
+
+TEST_CASE(run_all)
+{
+    migraphx::thread_pool pool{4};
+    EXPECT(pool.size() == 4);
+    std::vector<std::size_t> counts(1000, 0);
+    pool.run(counts.size(), [&](std::size_t i) { counts[i]++; });
+    EXPECT(std::all_of(counts.begin(), counts.end(), [](auto c) { return c == 1; }));
+}
+
+TEST_CASE(run_single_thread)
+{
+    migraphx::thread_pool pool{1};
+    std::vector<std::size_t> result;
+    pool.run(8, [&](std::size_t i) { result.push_back(i); });
+    std::vector<std::size_t> expected(8);
+    std::iota(expected.begin(), expected.end(), 0);
+    EXPECT(result == expected);
+}
+
+TEST_CASE(run_nested)
+{
+    migraphx::thread_pool pool{3};
+    std::atomic<std::size_t> total{0};
+    pool.run(16, [&](std::size_t) { pool.run(16, [&](std::size_t j) { total += j; }); });
+    EXPECT(total.load() == 16 * 120);
+}
+
+TEST_CASE(run_throws)
+{
+    migraphx::thread_pool pool{4};
+    std::atomic<std::size_t> n{0};
+    EXPECT(test::throws([&] {
+        pool.run(64, [&](std::size_t i) {
+            n++;
+            if(i == 7)
+                MIGRAPHX_THROW("Task failed");
+        });
+    }));
+    EXPECT(n.load() == 64);
+    // The pool is still usable after an error
+    std::atomic<std::size_t> m{0};
+    pool.run(64, [&](std::size_t) { m++; });
+    EXPECT(m.load() == 64);
+}
+
+TEST_CASE(submit_all)
+{
+    migraphx::thread_pool pool{4};
+    const std::size_t n = 100;
+    std::mutex m;
+    std::condition_variable cv;
+    std::size_t done = 0;
+    for(std::size_t i = 0; i < n; i++)
+    {
+        pool.submit([&] {
+            std::lock_guard<std::mutex> lock(m);
+            done++;
+            cv.notify_all();
+        });
+    }
+    std::unique_lock<std::mutex> lock(m);
+    cv.wait(lock, [&] { return done == n; });
+    EXPECT(done == n);
+}
+
+TEST_CASE(submit_single_thread)
+{
+    migraphx::thread_pool pool{1};
+    bool done = false;
+    pool.submit([&] { done = true; });
+    EXPECT(done);
+}
+
+TEST_CASE(submit_run)
+{
+    // Tasks that nobody waits for can use the pool for their own work
+    migraphx::thread_pool pool{3};
+    std::mutex m;
+    std::condition_variable cv;
+    std::size_t total = 0;
+    std::size_t done  = 0;
+    for(std::size_t i = 0; i < 4; i++)
+    {
+        pool.submit([&] {
+            std::atomic<std::size_t> sum{0};
+            pool.run(16, [&](std::size_t j) { sum += j; });
+            std::lock_guard<std::mutex> lock(m);
+            total += sum;
+            done++;
+            cv.notify_all();
+        });
+    }
+    std::unique_lock<std::mutex> lock(m);
+    cv.wait(lock, [&] { return done == 4; });
+    EXPECT(total == 4 * 120);
+}
+
+TEST_CASE(par_for_tid)
+{
+    auto nthreads = migraphx::thread_pool::global().size();
+    std::vector<std::size_t> result(4096, 0);
+    std::atomic<bool> valid_tid{true};
+    migraphx::par_for(result.size(), [&](std::size_t i, std::size_t tid) {
+        if(tid >= nthreads)
+            valid_tid = false;
+        result[i] = i;
+    });
+    EXPECT(valid_tid.load());
+    std::vector<std::size_t> expected(result.size());
+    std::iota(expected.begin(), expected.end(), 0);
+    EXPECT(result == expected);
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -0,0 +1,65 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "verify_program.hpp"
+#include <migraphx/program.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/make_op.hpp>
+
+template <bool Masked>
+struct test_attention : verify_program<test_attention<Masked>>
+{
+    migraphx::program create_program() const
+    {
+        migraphx::program p;
+        auto* mm = p.get_main_module();
+        migraphx::shape qs{migraphx::shape::float_type, {2, 4, 130, 16}};
+        migraphx::shape ms{migraphx::shape::float_type, {2, 1, 1, 130}};
+        auto q = mm->add_parameter("q", qs);
+        auto k = mm->add_parameter("k", qs);
+        auto v = mm->add_parameter("v", qs);
+        auto kt =
+            mm->add_instruction(migraphx::make_op("transpose", {{"permutation", {0, 1, 3, 2}}}), k);
+        auto scores = mm->add_instruction(migraphx::make_op("dot"), q, kt);
+        auto lens   = scores->get_shape().lens();
+        auto scale  = mm->add_literal(0.25f);
+        scale       = mm->add_instruction(
+            migraphx::make_op("multibroadcast", {{"out_lens", lens}}), scale);
+        scores = mm->add_instruction(migraphx::make_op("mul"), scores, scale);
+        if(Masked)
+        {
+            auto mask = mm->add_parameter("mask", ms);
+            mask      = mm->add_instruction(
+                migraphx::make_op("multibroadcast", {{"out_lens", lens}}), mask);
+            scores = mm->add_instruction(migraphx::make_op("add"), scores, mask);
+        }
+        auto probs = mm->add_instruction(migraphx::make_op("softmax", {{"axis", 3}}), scores);
+        mm->add_instruction(migraphx::make_op("dot"), probs, v);
+        return p;
+    }
+};
+
+template struct test_attention<false>;
+template struct test_attention<true>;
@@ -0,0 +1,54 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "verify_program.hpp"
+#include <migraphx/program.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/make_op.hpp>
+
+// Independent branches that the scheduler can put on different streams. It mixes operators that
+// write to an allocation with reference operators and operators that allocate their own output.
+struct test_branches_concat : verify_program<test_branches_concat>
+{
+    migraphx::program create_program() const
+    {
+        migraphx::program p;
+        auto* mm = p.get_main_module();
+        migraphx::shape xs{migraphx::shape::float_type, {1, 8, 16, 16}};
+        migraphx::shape ws{migraphx::shape::float_type, {8, 8, 3, 3}};
+        auto x  = mm->add_parameter("x", xs);
+        auto w1 = mm->add_literal(migraphx::generate_literal(ws, 1));
+        auto w2 = mm->add_literal(migraphx::generate_literal(ws, 2));
+        auto c1 = mm->add_instruction(
+            migraphx::make_op("convolution", {{"padding", {1, 1}}}), x, w1);
+        auto r1 = mm->add_instruction(migraphx::make_op("relu"), c1);
+        auto c2 = mm->add_instruction(migraphx::make_op("convolution"), x, w2);
+        auto p2 = mm->add_instruction(
+            migraphx::make_op("pad", {{"pads", {0, 0, 1, 1, 0, 0, 1, 1}}}), c2);
+        auto n3 = mm->add_instruction(migraphx::make_op("neg"), x);
+        auto s3 = mm->add_instruction(migraphx::make_op("sin"), n3);
+        auto cc = mm->add_instruction(migraphx::make_op("concat", {{"axis", 1}}), r1, p2, s3);
+        mm->add_instruction(migraphx::make_op("tanh"), cc);
+        return p;
+    }
+};
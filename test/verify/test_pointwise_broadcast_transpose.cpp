@@ -0,0 +1,54 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "verify_program.hpp"
+#include <migraphx/program.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/make_op.hpp>
+
+// A fused pointwise chain over inputs with broadcasted, transposed and standard strides, and
+// with scalar literals that are folded into the fused module
+struct test_pointwise_broadcast_transpose : verify_program<test_pointwise_broadcast_transpose>
+{
+    migraphx::program create_program() const
+    {
+        migraphx::program p;
+        auto* mm = p.get_main_module();
+        migraphx::shape s{migraphx::shape::float_type, {2, 3, 4, 5}};
+        auto x = mm->add_parameter("x", s);
+        auto y = mm->add_parameter("y", migraphx::shape{migraphx::shape::float_type, {2, 5, 4, 3}});
+        auto b = mm->add_parameter("b", migraphx::shape{migraphx::shape::float_type, {3}});
+        auto ty =
+            mm->add_instruction(migraphx::make_op("transpose", {{"permutation", {0, 3, 2, 1}}}), y);
+        auto bb = mm->add_instruction(
+            migraphx::make_op("broadcast", {{"axis", 1}, {"out_lens", s.lens()}}), b);
+        auto two = mm->add_instruction(
+            migraphx::make_op("multibroadcast", {{"out_lens", s.lens()}}), mm->add_literal(2.0f));
+        auto add  = mm->add_instruction(migraphx::make_op("add"), x, ty);
+        auto mul  = mm->add_instruction(migraphx::make_op("mul"), add, two);
+        auto sub  = mm->add_instruction(migraphx::make_op("sub"), mul, bb);
+        auto tanh = mm->add_instruction(migraphx::make_op("tanh"), sub);
+        mm->add_instruction(migraphx::make_op("max"), tanh, x);
+        return p;
+    }
+};
@@ -0,0 +1,55 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "verify_program.hpp"
+#include <migraphx/program.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/make_op.hpp>
+
+// The rows and columns are not multiples of the blocks used by the cpu kernel
+static migraphx::program create_weight_dot(std::size_t bits)
+{
+    const std::size_t k     = 256;
+    const std::size_t n     = 40;
+    const std::size_t group = 64;
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto a   = mm->add_parameter("a", migraphx::shape{migraphx::shape::float_type, {2, 70, k}});
+    auto w   = mm->add_literal(
+        migraphx::generate_literal({migraphx::shape::int8_type, {n, k * bits / 8}}, 1));
+    auto s = mm->add_literal(
+        migraphx::generate_literal({migraphx::shape::float_type, {n, k / group}}, 2));
+    mm->add_instruction(
+        migraphx::make_op("weight_dot", {{"bits", bits}, {"group_size", group}}), a, w, s);
+    return p;
+}
+
+struct test_weight_dot : verify_program<test_weight_dot>
+{
+    migraphx::program create_program() const { return create_weight_dot(8); }
+};
+
+struct test_weight_dot_int4 : verify_program<test_weight_dot_int4>
+{
+    migraphx::program create_program() const { return create_weight_dot(4); }
+};
@@ -53,6 +53,9 @@ struct pass
     void apply(module& m) const;
     /// Run the pass on the program
     void apply(program& p) const;
+    /// Whether running the pass again on a module that has not changed since
+    /// the last run has no effect, so the pass manager can skip it
+    bool idempotent() const;
 };
 
 #else
@@ -79,13 +82,20 @@ void module_pass_manager_apply(const T& x, module_pass_manager& mpm)
     module_pass_manager_apply(rank<1>{}, x, mpm);
 }
 
+template <class T>
+bool pass_idempotent(const T&)
+{
+    return false;
+}
+
 } // namespace detail
 
 <%
 interface('pass',
     virtual('name', returns='std::string', const=True),
     virtual('apply', returns='void', mpm='module_pass_manager &', const=True, default='migraphx::detail::module_pass_manager_apply'),
-    virtual('apply', returns='void', p='program &', const=True, default='migraphx::nop')
+    virtual('apply', returns='void', p='program &', const=True, default='migraphx::nop'),
+    virtual('idempotent', returns='bool', const=True, default='migraphx::detail::pass_idempotent')
 )
 %>
 
@@ -82,6 +82,15 @@ struct target
      * @return Allocated argument in the target.
      */
     argument allocate(const shape& s) const;
+    /**
+     * @brief Identify the device the compiled code is built for.
+     *
+     * Compiled programs are only reused on devices with the same identity. Targets that
+     * generate code for the exact device, such as a specific gpu architecture or the host cpu
+     * features, should return a string that changes with it.
+     * @return A string identifying the device, which is empty when the code is portable.
+     */
+    std::string device_identity() const;
 };
 
 #else
@@ -105,6 +114,12 @@ argument copy_from_target(T&, const argument& arg)
     return arg;
 }
 
+template <class T>
+std::string target_device_identity(T&)
+{
+    return "";
+}
+
 <%
 interface('target',
      virtual('name', returns='std::string', const=True),
@@ -121,7 +136,9 @@ interface('target',
              const   = True,
              default = 'copy_from_target'),
     virtual('allocate', s='const shape&', returns='argument', const=True,
-             default = 'target_allocate')
+             default = 'target_allocate'),
+    virtual('device_identity', returns='std::string', const=True,
+             default = 'target_device_identity')
 )
 %>
 